@@ -142,6 +142,92 @@ public class MidiDriver
      */
     public  native boolean write(byte a[]);
 
+    /**
+     * Write MIDI 2.0 Universal MIDI Packets. MIDI 1.0 and MIDI 2.0
+     * channel voice messages and SysEx are supported, groups are
+     * ignored.
+     *
+     * @param words array of 32-bit packet words
+     * @return true for success
+     */
+    public native boolean writeUMP(int words[]);
+
+    /**
+     * Note on. Typed events are queued and applied before the next
+     * audio buffer, or before the next write, without parsing MIDI
+     * bytes, so they stay in order with written bytes.
+     * @param channel midi channel (0 - 15)
+     * @param note note number (0 - 127)
+     * @param velocity velocity (0 - 127)
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean noteOn(int channel, int note, int velocity);
+
+    /**
+     * Note off
+     * @param channel midi channel (0 - 15)
+     * @param note note number (0 - 127)
+     * @param velocity release velocity (0 - 127)
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean noteOff(int channel, int note, int velocity);
+
+    /**
+     * Control change
+     * @param channel midi channel (0 - 15)
+     * @param controller controller number (0 - 127)
+     * @param value controller value (0 - 127)
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean controlChange(int channel, int controller,
+                                        int value);
+
+    /**
+     * Pitch bend
+     * @param channel midi channel (0 - 15)
+     * @param value bend value (0 - 16383), 8192 is centre
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean pitchBend(int channel, int value);
+
+    /**
+     * Program change
+     * @param channel midi channel (0 - 15)
+     * @param program program number (0 - 127)
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean programChange(int channel, int program);
+
+    /**
+     * Note on for several notes. The batch is queued whole or not at
+     * all.
+     * @param channel midi channel (0 - 15)
+     * @param notes note numbers (0 - 127)
+     * @param velocities velocities (0 - 127), same length as notes
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean noteOnBatch(int channel, int notes[],
+                                      int velocities[]);
+
+    /**
+     * Note off for several notes
+     * @param channel midi channel (0 - 15)
+     * @param notes note numbers (0 - 127)
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean noteOffBatch(int channel, int notes[]);
+
+    /**
+     * Control change for several controllers
+     * @param channel midi channel (0 - 15)
+     * @param controllers controller numbers (0 - 127)
+     * @param values controller values (0 - 127), same length as
+     * controllers
+     * @return true for success, false if invalid or the queue is full
+     */
+    public native boolean controlChangeBatch(int channel, int controllers[],
+                                             int values[]);
+
     /**
      * Set master volume
      * @param volume master volume for EAS synthesizer (between 0 and 100)
@@ -156,6 +242,33 @@ public class MidiDriver
      */
     public native boolean setReverb(int preset);
 
+    /**
+     * Stop the audio stream after a period of silence. The stream is
+     * restarted by the next write.
+     * @param seconds seconds of silence before stopping, 0 to disable
+     * @return true for success
+     */
+    public native boolean setIdleTimeout(int seconds);
+
+    /**
+     * Only apply the latest pitch bend, channel pressure, modulation,
+     * volume, pan and expression value per channel in each audio
+     * buffer. Ordering relative to notes is preserved.
+     * @param enable true to enable coalescing
+     * @return true for success
+     */
+    public native boolean setCoalescing(boolean enable);
+
+    /**
+     * Ask for a floating point audio stream, which keeps the bits
+     * below the 16 bit LSB and is clipped to +/-1.0 like the 16 bit
+     * stream. The voices are still rendered in fixed point. Call
+     * before start(), the default is a 16 bit stream.
+     * @param enable true for float output
+     * @return true for success
+     */
+    public native boolean setFloatOutput(boolean enable);
+
     /**
      * Shut down native code
      *
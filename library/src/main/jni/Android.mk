@@ -28,6 +28,7 @@ LOCAL_SRC_FILES = \
 	lib_src/eas_mididata.c \
 	lib_src/eas_mixbuf.c \
 	lib_src/eas_mixer.c \
+	lib_src/eas_mixer_simd.c \
 	lib_src/eas_pan.c \
 	lib_src/eas_pcm.c \
 	lib_src/eas_pcmdata.c \
@@ -36,6 +37,7 @@ LOCAL_SRC_FILES = \
 	lib_src/eas_reverbdata.c \
 	lib_src/eas_smf.c \
 	lib_src/eas_smfdata.c \
+	lib_src/eas_state.c \
 	lib_src/eas_voicemgt.c \
 	lib_src/eas_wtengine.c \
 	lib_src/eas_wtsynth.c \
@@ -58,6 +60,8 @@ LOCAL_SRC_FILES = \
 #	lib_src/eas_xmf.c \
 #	lib_src/eas_xmfdata.c \
 #	host_src/eas_main.c \
+#	host_src/eas_batch.c (host only, see tests/CMakeLists.txt) \
+#	host_src/eas_batch_main.c \
 #	host_src/eas_wave.c \
 #	lib_src/eas_wavefile.c \
 #	lib_src/eas_wavefiledata.c \
@@ -73,6 +77,7 @@ LOCAL_CFLAGS += -O2 \
 	-D _FILTER_ENABLED \
 	-D DLS_SYNTHESIZER \
 	-D _REVERB_ENABLED \
+	-D EAS_SIMD_MIXER \
 	-D false=0 \
 	-Wno-unused-parameter \
         -Werror
@@ -85,6 +90,8 @@ LOCAL_CFLAGS += -O2 \
 # -D _WAVE_PARSER
 # -D _IMA_DECODER (needed for IMA-ADPCM wave files)
 # -D _CHORUS_ENABLED
+# -D _RT_CHECK (debug, record allocations, logging and locks in EAS_Render)
+# -D _RT_CHECK_TRAP (debug, abort on the first one)
 
 LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/host_src \
@@ -49,7 +49,9 @@
 #include "eas_mdls.h"
 #endif
 
+static EAS_RESULT MIDIStream_Event (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_INT parserMode);
 static EAS_RESULT MIDIStream_State (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 *pState);
+static EAS_RESULT MIDIStream_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
 static EAS_RESULT MIDIStream_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
 
 /*---------------------------------------------------------------------------- 
@@ -64,18 +66,46 @@ const static S_FILE_PARSER_INTERFACE EAS_MIDIStream_Parser =
     NULL,
     NULL,
     NULL,
-    NULL,
+    MIDIStream_Event,
     MIDIStream_State,
     NULL,
     NULL,
     NULL,
     NULL,
     NULL,
-    NULL,
+    MIDIStream_SetData,
     MIDIStream_GetData,
     NULL 
 };
 
+/*----------------------------------------------------------------------------
+ * MIDIStream_Event()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Called once per frame, applies controller values held by coalescing
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - pointer to file handle
+ * parserMode       - parser mode
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, parserMode) common decoder interface - parserMode not used */
+static EAS_RESULT MIDIStream_Event (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_INT parserMode)
+{
+    S_INTERACTIVE_MIDI *pData;
+
+    pData = (S_INTERACTIVE_MIDI*) pInstData;
+    EAS_FlushMIDIStream(pEASData, pData->pSynth, &pData->stream);
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * MIDIStream_State()
  *----------------------------------------------------------------------------
@@ -130,6 +160,47 @@ static EAS_RESULT MIDIStream_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstDa
             *pValue = (EAS_I32) pData->pSynth;
             break;
 
+        /* append the parser state to a state buffer */
+        case PARSER_DATA_SAVE_STATE:
+            EAS_SaveMIDIStream(&pData->stream, (S_EAS_STATE_BUFFER*) pValue);
+            break;
+
+        default:
+            return EAS_ERROR_INVALID_PARAMETER;
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * MIDIStream_SetData()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Set specified data
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - pointer to file handle
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, pEASData) common decoder interface - pEASData not used */
+static EAS_RESULT MIDIStream_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value)
+{
+    S_INTERACTIVE_MIDI *pData;
+
+    pData = (S_INTERACTIVE_MIDI*) pInstData;
+    switch (param)
+    {
+        /* restore the parser state from a state buffer */
+        case PARSER_DATA_RESTORE_STATE:
+            EAS_RestoreMIDIStream(&pData->stream, (S_EAS_STATE_BUFFER*) value);
+            break;
+
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -319,7 +390,6 @@ EAS_PUBLIC EAS_RESULT EAS_OpenMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE *
 EAS_PUBLIC EAS_RESULT EAS_WriteMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_U8 *pBuffer, EAS_I32 count)
 {
     S_INTERACTIVE_MIDI *pMIDIStream;
-    EAS_RESULT result;
 
     pMIDIStream = (S_INTERACTIVE_MIDI*) pStream->handle;
 
@@ -327,14 +397,134 @@ EAS_PUBLIC EAS_RESULT EAS_WriteMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE
         return EAS_ERROR_PARAMETER_RANGE;
 
     /* send the entire buffer */
-    while (count--)
+    return EAS_ParseMIDIBuffer(pEASData, pMIDIStream->pSynth, &pMIDIStream->stream, pBuffer, count, eParserModePlay);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_WriteMIDIEvents()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Send decoded channel messages to the MIDI stream device
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - stream handle
+ * pEvents          - pointer to array of events
+ * count            - number of events to write
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_WriteMIDIEvents (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, const S_EAS_MIDI_EVENT *pEvents, EAS_I32 count)
+{
+    S_INTERACTIVE_MIDI *pMIDIStream;
+
+    pMIDIStream = (S_INTERACTIVE_MIDI*) pStream->handle;
+
+    if (count <= 0)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    return EAS_ParseMIDIEvents(pEASData, pMIDIStream->pSynth, &pMIDIStream->stream, pEvents, count, eParserModePlay);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_WriteUMPStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Send Universal MIDI Packets to the MIDI stream device
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - stream handle
+ * pWords           - pointer to array of packet words
+ * count            - number of words to write
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_WriteUMPStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, const EAS_UMP_WORD *pWords, EAS_I32 count)
+{
+    S_INTERACTIVE_MIDI *pMIDIStream;
+
+    pMIDIStream = (S_INTERACTIVE_MIDI*) pStream->handle;
+
+    if (count <= 0)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    return EAS_ParseUMPStream(pEASData, pMIDIStream->pSynth, &pMIDIStream->stream, pWords, count, eParserModePlay);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetMIDIStreamCoalescing()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables coalescing of controller messages on a MIDI stream
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - stream handle
+ * enable           - EAS_TRUE to enable coalescing
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ * Held values are applied before coalescing is disabled
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetMIDIStreamCoalescing (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_BOOL enable)
+{
+    S_INTERACTIVE_MIDI *pMIDIStream;
+
+    pMIDIStream = (S_INTERACTIVE_MIDI*) pStream->handle;
+
+    if (enable)
+        pMIDIStream->stream.pCoalesce = &pMIDIStream->coalesce;
+    else
     {
-        if ((result = EAS_ParseMIDIStream(pEASData, pMIDIStream->pSynth, &pMIDIStream->stream, *pBuffer++, eParserModePlay)) != EAS_SUCCESS)
-            return result;
+        EAS_FlushMIDIStream(pEASData, pMIDIStream->pSynth, &pMIDIStream->stream);
+        pMIDIStream->stream.pCoalesce = NULL;
     }
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_GetMIDIStreamCoalescedCount()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the number of controller messages dropped by coalescing
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - stream handle
+ * pCount           - pointer to variable to receive the count
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, pEASData) reserved for future use */
+EAS_PUBLIC EAS_RESULT EAS_GetMIDIStreamCoalescedCount (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_I32 *pCount)
+{
+    S_INTERACTIVE_MIDI *pMIDIStream;
+
+    pMIDIStream = (S_INTERACTIVE_MIDI*) pStream->handle;
+    *pCount = (EAS_I32) pMIDIStream->coalesce.coalescedCount;
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * EAS_CloseMIDIStream()
  *----------------------------------------------------------------------------
@@ -93,6 +93,25 @@ typedef enum
 } E_DECODER_MODULES;
 #define NUM_DECODER_MODULES     4
 
+/* voice stealing policies for EAS_SetVoiceStealPolicy */
+typedef enum
+{
+    EAS_STEAL_POLICY_DEFAULT = 0,       /* age, gain and SP-MIDI allocation */
+    EAS_STEAL_POLICY_OLDEST,            /* oldest sounding note first */
+    EAS_STEAL_POLICY_QUIETEST,          /* lowest gain note first */
+    EAS_STEAL_POLICY_SAME_NOTE,         /* retrigger a matching note first */
+    EAS_STEAL_POLICY_CHANNEL_PRIORITY   /* lowest priority channel first */
+} E_STEAL_POLICY;
+#define NUM_STEAL_POLICIES      5
+
+/* decoded channel message for EAS_WriteMIDIEvents */
+typedef struct
+{
+    EAS_U8      status;             /* status byte with channel, 0x80 - 0xef */
+    EAS_U8      data1;              /* first data byte */
+    EAS_U8      data2;              /* second data byte, 0 if not used */
+} S_EAS_MIDI_EVENT;
+
 /* defines for EAS_PEOpenStream flags parameter */
 #define PCM_FLAGS_STEREO        0x00000100  /* stream is stereo */
 #define PCM_FLAGS_8_BIT         0x00000001  /* 8-bit format */
@@ -168,6 +187,64 @@ EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData);
 */
 EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
 
+/*----------------------------------------------------------------------------
+ * EAS_RenderFloat()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parse the Midi data and render floating point audio data. The mix
+ * bus is converted straight to float, so the output keeps the bits
+ * below the 16-bit LSB. It is clipped to +/-1.0 where EAS_Render
+ * saturates, and is within 2 LSB of EAS_Render scaled by 32768.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if audio data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderFloat (EAS_DATA_HANDLE pEASData, EAS_FLOAT *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
+
+/*----------------------------------------------------------------------------
+ * EAS_GetIdle()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns whether the last rendered buffer was idle: no voices active
+ * and the reverb tail died away. Idle buffers are written as silence
+ * without running the mixer or effects.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pIdle           - pointer to variable to receive the idle flag
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetIdle (EAS_DATA_HANDLE pEASData, EAS_BOOL *pIdle);
+
+/*----------------------------------------------------------------------------
+ * EAS_SetVoiceStealPolicy()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Selects how a voice is chosen for stealing when all voices are in
+ * use. The default policy weighs note age and gain, with SP-MIDI
+ * channel allocation when enabled.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  policy          - one of the EAS_STEAL_POLICY values
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetVoiceStealPolicy (EAS_DATA_HANDLE pEASData, EAS_I32 policy);
+
 /*----------------------------------------------------------------------------
  * EAS_SetTransposition)
  *----------------------------------------------------------------------------
@@ -318,6 +395,103 @@ EAS_PUBLIC EAS_RESULT EAS_ParseMetaData (EAS_DATA_HANDLE pEASData, EAS_HANDLE st
 */
 EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle);
 
+/*----------------------------------------------------------------------------
+ * EAS_SetTimelineMode()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables the pre-merged event timeline for an SMF file. When enabled,
+ * EAS_Prepare decodes all the tracks into a single time sorted event
+ * array and playback, repeats and locates walk the array instead of
+ * parsing the file. Files the timeline cannot represent, and files with
+ * a metadata callback registered, are still parsed from the file.
+ * Repeats and locates start from the tempo of the first pass, with or
+ * without the timeline.
+ * Must be called before EAS_Prepare.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - file handle
+ * enable           - EAS_TRUE to build the timeline
+ *
+ * Outputs:
+ * returns EAS_ERROR_INVALID_PARAMETER if the file is not an SMF file
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetTimelineMode (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_BOOL enable);
+
+/*----------------------------------------------------------------------------
+ * EAS_SetCheckpointInterval()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets how often an SMF file saves its parser and channel state while it
+ * plays. EAS_Locate restarts from the closest saved state before the
+ * requested time instead of parsing the file from the start. Checkpoints
+ * are off by default. They take about 18 KB per file, allocated by
+ * EAS_Prepare, and 2000 milliseconds is a reasonable interval. The
+ * interval doubles when a long file fills the table. A locate from a
+ * checkpoint restores the tempo of the first pass, like the timeline.
+ * Must be called before EAS_Prepare.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - file handle
+ * milliseconds     - checkpoint interval, zero disables checkpoints
+ *
+ * Outputs:
+ * returns EAS_ERROR_INVALID_PARAMETER if the file is not an SMF file
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetCheckpointInterval (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_I32 milliseconds);
+
+/*----------------------------------------------------------------------------
+ * EAS_LockMemory()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Marks the end of initialization for the memory allocator. While memory
+ * is locked, every allocation or free that has to go to the heap instead
+ * of the instance pools is reported as an error and counted in the
+ * lockedAllocs statistic. Lock the memory once the streams are open to
+ * check that rendering does not allocate.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * lock             - EAS_TRUE to lock, EAS_FALSE to unlock
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_LockMemory (EAS_DATA_HANDLE pEASData, EAS_BOOL lock);
+
+/*----------------------------------------------------------------------------
+ * EAS_GetMemoryStats()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the allocation statistics of the instance: bytes in use and
+ * their peak, bytes held from the heap, and allocation counts.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pStats           - pointer to the structure to fill
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetMemoryStats (EAS_DATA_HANDLE pEASData, S_EAS_MEM_STATS *pStats);
+
 /*----------------------------------------------------------------------------
  * EAS_State()
  *----------------------------------------------------------------------------
@@ -441,6 +615,102 @@ EAS_PUBLIC EAS_RESULT EAS_OpenMIDIStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE *
 */
 EAS_PUBLIC EAS_RESULT EAS_WriteMIDIStream(EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_U8 *pBuffer, EAS_I32 count);
 
+/*----------------------------------------------------------------------------
+ * EAS_WriteMIDIEvents()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Send decoded channel messages to the MIDI stream device. The events are
+ * applied directly without going through the MIDI byte parser, and do not
+ * disturb running status or a message split across EAS_WriteMIDIStream
+ * calls.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - stream handle
+ * pEvents          - pointer to array of events
+ * count            - number of events to write
+ *
+ * Outputs:
+ * returns EAS_ERROR_PARAMETER_RANGE at the first invalid event, events
+ * before it have been applied
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_WriteMIDIEvents (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, const S_EAS_MIDI_EVENT *pEvents, EAS_I32 count);
+
+/*----------------------------------------------------------------------------
+ * EAS_WriteUMPStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Send MIDI 2.0 Universal MIDI Packets to the MIDI stream device. MIDI 1.0
+ * and MIDI 2.0 channel voice messages and 7-bit SysEx are supported; other
+ * message types are skipped. MIDI 2.0 values are scaled to the resolution
+ * of the synthesizer and registered controllers are sent as RPN controller
+ * sequences. The group field is ignored.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - stream handle
+ * pWords           - pointer to array of 32-bit packet words
+ * count            - number of words to write
+ *
+ * Outputs:
+ * returns EAS_ERROR_PARAMETER_RANGE if the last packet is incomplete, the
+ * packets before it have been applied
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_WriteUMPStream (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, const EAS_UMP_WORD *pWords, EAS_I32 count);
+
+/*----------------------------------------------------------------------------
+ * EAS_SetMIDIStreamCoalescing()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enables or disables controller coalescing on a MIDI stream. When enabled,
+ * pitch bend, channel pressure, modulation, volume, pan and expression
+ * messages are held until the next render and only the latest value per
+ * channel is applied. Any other message on the channel applies the held
+ * values first, so ordering relative to notes is preserved.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - stream handle
+ * enable           - EAS_TRUE to enable, EAS_FALSE to disable
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetMIDIStreamCoalescing (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_BOOL enable);
+
+/*----------------------------------------------------------------------------
+ * EAS_GetMIDIStreamCoalescedCount()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the number of controller messages collapsed by coalescing since
+ * the stream was opened
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * streamHandle     - stream handle
+ * pCount           - pointer to variable to receive the count
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetMIDIStreamCoalescedCount (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_I32 *pCount);
+
 /*----------------------------------------------------------------------------
  * EAS_CloseMIDIStream()
  *----------------------------------------------------------------------------
@@ -503,6 +773,59 @@ EAS_PUBLIC EAS_RESULT EAS_Locate (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHan
 */
 EAS_PUBLIC EAS_RESULT EAS_GetLocation (EAS_DATA_HANDLE pEASData, EAS_HANDLE streamHandle, EAS_I32 *pTime);
 
+/*----------------------------------------------------------------------------
+ * EAS_SaveState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the playback state of the instance: the open streams, the
+ * channels and voices of the synthesizer and the effects.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pBuffer          - buffer for the state, NULL to get the size needed
+ * bufferSize       - size of the buffer in bytes
+ * pStateSize       - receives the size of the state in bytes
+ *
+ * Outputs:
+ * EAS_BUFFER_SIZE_MISMATCH if the buffer is too small, with the size
+ * needed in pStateSize
+ *
+ * Side Effects:
+ * The state is a versioned binary block in native byte order. It holds
+ * no pointers, so it can be restored into another instance, but only by
+ * a build of the library with the same layout. Files played through JET
+ * are not supported.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SaveState (EAS_DATA_HANDLE pEASData, void *pBuffer, EAS_I32 bufferSize, EAS_I32 *pStateSize);
+
+/*----------------------------------------------------------------------------
+ * EAS_RestoreState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores a state saved by EAS_SaveState.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pBuffer          - saved state
+ * size             - size of the saved state in bytes
+ *
+ * Outputs:
+ * EAS_ERROR_INCOMPATIBLE_VERSION if the state is from another build
+ * EAS_ERROR_SOUND_LIBRARY if different sound libraries are loaded
+ * EAS_ERROR_DATA_INCONSISTENCY if the state is damaged
+ *
+ * Side Effects:
+ * The instance must have the same files opened and prepared, in the same
+ * order, and the same sound libraries loaded as the saved instance.
+ * Rendering then continues exactly as it did after the save. A state
+ * that is rejected leaves the instance unchanged.
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RestoreState (EAS_DATA_HANDLE pEASData, const void *pBuffer, EAS_I32 size);
+
 /*----------------------------------------------------------------------------
  * EAS_Pause()
  *----------------------------------------------------------------------------
@@ -0,0 +1,581 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_batch.c
+ *
+ * Contents and purpose:
+ * Batch rendering of MIDI files on several threads, see eas_batch.h.
+ *
+ * The files are split into one contiguous range per worker. A worker
+ * takes files from the front of its own range and, when that is empty,
+ * steals from the back of the other ranges. Both ends of a range are
+ * packed in one word and claimed with a compare and swap, so the queue
+ * has no locks.
+ *
+ * Each worker keeps its own input buffer, PCM buffer and stdio output
+ * buffer for the whole batch. The library keeps no shared mutable state
+ * between instances, so the workers do not synchronize while rendering.
+ * WAV files are written little endian, the byte order of the supported
+ * targets.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+/* for clock_gettime and sysconf */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "eas.h"
+#include "eas_reverb.h"
+#include "eas_batch.h"
+
+/* size of the stdio buffer of each worker's output file */
+#define EAS_BATCH_OUT_BUFFER    65536
+
+/* size of the WAV header written before the samples */
+#define EAS_BATCH_WAV_HEADER    44
+
+/* range of files of a worker, the next file in the low 32 bits and the
+ * end of the range in the high 32 bits */
+typedef struct s_eas_batch_queue_tag
+{
+    unsigned long long range;
+} S_EAS_BATCH_QUEUE;
+
+typedef struct s_eas_batch_tag S_EAS_BATCH;
+
+/* worker thread */
+typedef struct s_eas_batch_worker_tag
+{
+    S_EAS_BATCH *pBatch;
+    pthread_t thread;
+    EAS_I32 index;
+    EAS_U8 *pInput;             /* contents of the current file */
+    EAS_I32 inputSize;          /* bytes in pInput */
+    EAS_I32 inputAlloc;         /* allocated size of pInput */
+    EAS_U8 *pDLS;               /* contents of the DLS collection */
+    EAS_I32 dlsSize;
+    EAS_I32 dlsAlloc;
+    EAS_PCM *pPCM;              /* one render buffer */
+    char *pOutBuffer;           /* stdio buffer of the output file */
+    EAS_I32 numStolen;
+} S_EAS_BATCH_WORKER;
+
+/* batch shared by the workers, read only while they run */
+struct s_eas_batch_tag
+{
+    S_EAS_BATCH_CONFIG config;
+    S_EAS_BATCH_JOB *pJobs;
+    S_EAS_BATCH_QUEUE *pQueues;
+    EAS_I32 numWorkers;
+    const S_EAS_LIB_CONFIG *pLibConfig;
+};
+
+/* in-memory file for the EAS file locator */
+typedef struct s_eas_batch_file_tag
+{
+    const EAS_U8 *pData;
+    EAS_I32 size;
+} S_EAS_BATCH_FILE;
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchReadAt()
+ *----------------------------------------------------------------------------
+*/
+static int EAS_BatchReadAt (void *handle, void *buf, int offset, int size)
+{
+    S_EAS_BATCH_FILE *pFile = (S_EAS_BATCH_FILE*) handle;
+
+    if ((offset < 0) || (offset >= pFile->size))
+        return 0;
+    if (size > pFile->size - offset)
+        size = pFile->size - offset;
+    memcpy(buf, pFile->pData + offset, (size_t) size);
+    return size;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchSize()
+ *----------------------------------------------------------------------------
+*/
+static int EAS_BatchSize (void *handle)
+{
+    return ((S_EAS_BATCH_FILE*) handle)->size;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchTime()
+ *----------------------------------------------------------------------------
+ * Returns a monotonic time in microseconds
+ *----------------------------------------------------------------------------
+*/
+static long long EAS_BatchTime (void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchReadFile()
+ *----------------------------------------------------------------------------
+ * Reads a whole file into a buffer that grows as needed
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_BatchReadFile (const char *pPath, EAS_U8 **ppBuffer, EAS_I32 *pAlloc, EAS_I32 *pSize)
+{
+    FILE *file;
+    EAS_U8 *pNew;
+    long size;
+
+    if ((file = fopen(pPath, "rb")) == NULL)
+        return EAS_ERROR_FILE_OPEN_FAILED;
+    if ((fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < 0) || (size > 0x7fffffffL) ||
+        (fseek(file, 0, SEEK_SET) != 0))
+    {
+        fclose(file);
+        return EAS_ERROR_FILE_READ_FAILED;
+    }
+
+    if (size > *pAlloc)
+    {
+        if ((pNew = realloc(*ppBuffer, (size_t) size)) == NULL)
+        {
+            fclose(file);
+            return EAS_ERROR_MALLOC_FAILED;
+        }
+        *ppBuffer = pNew;
+        *pAlloc = (EAS_I32) size;
+    }
+
+    if (fread(*ppBuffer, 1, (size_t) size, file) != (size_t) size)
+    {
+        fclose(file);
+        return EAS_ERROR_FILE_READ_FAILED;
+    }
+    fclose(file);
+    *pSize = (EAS_I32) size;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchPut32()
+ *----------------------------------------------------------------------------
+*/
+static void EAS_BatchPut32 (EAS_U8 *p, EAS_U32 value)
+{
+    p[0] = (EAS_U8) value;
+    p[1] = (EAS_U8) (value >> 8);
+    p[2] = (EAS_U8) (value >> 16);
+    p[3] = (EAS_U8) (value >> 24);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchWriteHeader()
+ *----------------------------------------------------------------------------
+ * Writes the WAV header for the given number of sample frames
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL EAS_BatchWriteHeader (FILE *file, const S_EAS_LIB_CONFIG *pLibConfig, EAS_I32 frames)
+{
+    EAS_U8 header[EAS_BATCH_WAV_HEADER];
+    EAS_U32 blockAlign;
+    EAS_U32 dataSize;
+
+    blockAlign = (EAS_U32) pLibConfig->numChannels * sizeof(EAS_PCM);
+    dataSize = (EAS_U32) frames * blockAlign;
+
+    memcpy(header, "RIFF", 4);
+    EAS_BatchPut32(header + 4, dataSize + EAS_BATCH_WAV_HEADER - 8);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    EAS_BatchPut32(header + 16, 16);
+    EAS_BatchPut32(header + 20, 1 | ((EAS_U32) pLibConfig->numChannels << 16));
+    EAS_BatchPut32(header + 24, (EAS_U32) pLibConfig->sampleRate);
+    EAS_BatchPut32(header + 28, (EAS_U32) pLibConfig->sampleRate * blockAlign);
+    EAS_BatchPut32(header + 32, blockAlign | ((EAS_U32) (sizeof(EAS_PCM) * 8) << 16));
+    memcpy(header + 36, "data", 4);
+    EAS_BatchPut32(header + 40, dataSize);
+
+    return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchRenderFile()
+ *----------------------------------------------------------------------------
+ * Renders one file on a new EAS instance
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_BatchRenderFile (S_EAS_BATCH_WORKER *pWorker, S_EAS_BATCH_JOB *pJob)
+{
+    const S_EAS_BATCH_CONFIG *pConfig = &pWorker->pBatch->config;
+    const S_EAS_LIB_CONFIG *pLibConfig = pWorker->pBatch->pLibConfig;
+    S_EAS_BATCH_FILE midiFile;
+    EAS_FILE locator;
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_RESULT closeResult;
+    EAS_STATE state;
+    EAS_I32 numGenerated;
+    EAS_I32 maxFrames;
+    EAS_I32 tailFrames;
+    FILE *file;
+
+    pJob->frames = 0;
+    if ((result = EAS_BatchReadFile(pJob->pInput, &pWorker->pInput, &pWorker->inputAlloc, &pWorker->inputSize)) != EAS_SUCCESS)
+        return result;
+
+    if ((result = EAS_Init(&pEASData)) != EAS_SUCCESS)
+        return result;
+
+    /* effects */
+    if (pConfig->reverbPreset >= 0)
+    {
+        EAS_SetParameter(pEASData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, pConfig->reverbPreset);
+        EAS_SetParameter(pEASData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE);
+    }
+    else
+        EAS_SetParameter(pEASData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_TRUE);
+
+#ifdef DLS_SYNTHESIZER
+    /* the collection was read once by the worker */
+    if (pWorker->pDLS != NULL)
+    {
+        midiFile.pData = pWorker->pDLS;
+        midiFile.size = pWorker->dlsSize;
+        locator.handle = &midiFile;
+        locator.readAt = EAS_BatchReadAt;
+        locator.size = EAS_BatchSize;
+        if ((result = EAS_LoadDLSCollection(pEASData, NULL, &locator)) != EAS_SUCCESS)
+        {
+            EAS_Shutdown(pEASData);
+            return result;
+        }
+    }
+#endif
+
+    midiFile.pData = pWorker->pInput;
+    midiFile.size = pWorker->inputSize;
+    locator.handle = &midiFile;
+    locator.readAt = EAS_BatchReadAt;
+    locator.size = EAS_BatchSize;
+    if ((result = EAS_OpenFile(pEASData, &locator, &stream)) != EAS_SUCCESS)
+    {
+        EAS_Shutdown(pEASData);
+        return result;
+    }
+    if ((result = EAS_Prepare(pEASData, stream)) != EAS_SUCCESS)
+    {
+        EAS_CloseFile(pEASData, stream);
+        EAS_Shutdown(pEASData);
+        return result;
+    }
+
+    /* the header is rewritten with the real size at the end */
+    file = NULL;
+    if (pJob->pOutput != NULL)
+    {
+        if ((file = fopen(pJob->pOutput, "wb")) == NULL)
+            result = EAS_ERROR_FILE_OPEN_FAILED;
+        else
+        {
+            setvbuf(file, pWorker->pOutBuffer, _IOFBF, EAS_BATCH_OUT_BUFFER);
+            if (!EAS_BatchWriteHeader(file, pLibConfig, 0))
+                result = EAS_FAILURE;
+        }
+    }
+
+    /* render to the end of the file, then the tail */
+    maxFrames = (EAS_I32) (((long long) pConfig->maxMs * pLibConfig->sampleRate) / 1000);
+    tailFrames = (EAS_I32) (((long long) pConfig->tailMs * pLibConfig->sampleRate) / 1000);
+    while (result == EAS_SUCCESS)
+    {
+        if ((result = EAS_State(pEASData, stream, &state)) != EAS_SUCCESS)
+            break;
+        if ((state == EAS_STATE_STOPPED) || (state == EAS_STATE_ERROR))
+        {
+            if (tailFrames <= 0)
+                break;
+            tailFrames -= pLibConfig->mixBufferSize;
+        }
+        if ((maxFrames > 0) && (pJob->frames >= maxFrames))
+            break;
+
+        if ((result = EAS_Render(pEASData, pWorker->pPCM, pLibConfig->mixBufferSize, &numGenerated)) != EAS_SUCCESS)
+            break;
+        if ((file != NULL) && (fwrite(pWorker->pPCM, sizeof(EAS_PCM) * (size_t) pLibConfig->numChannels, (size_t) numGenerated, file) != (size_t) numGenerated))
+            result = EAS_FAILURE;
+        pJob->frames += numGenerated;
+    }
+
+    if (file != NULL)
+    {
+        if ((result == EAS_SUCCESS) &&
+            ((fseek(file, 0, SEEK_SET) != 0) || !EAS_BatchWriteHeader(file, pLibConfig, pJob->frames)))
+            result = EAS_FAILURE;
+        if ((fclose(file) != 0) && (result == EAS_SUCCESS))
+            result = EAS_ERROR_CLOSE_FAILED;
+    }
+
+    closeResult = EAS_CloseFile(pEASData, stream);
+    if (result == EAS_SUCCESS)
+        result = closeResult;
+    closeResult = EAS_Shutdown(pEASData);
+    if (result == EAS_SUCCESS)
+        result = closeResult;
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchTake()
+ *----------------------------------------------------------------------------
+ * Takes a file from the front of a worker's own range
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 EAS_BatchTake (S_EAS_BATCH_QUEUE *pQueue)
+{
+    unsigned long long range;
+    EAS_U32 next, end;
+
+    range = __atomic_load_n(&pQueue->range, __ATOMIC_ACQUIRE);
+    for (;;)
+    {
+        next = (EAS_U32) (range & 0xffffffffUL);
+        end = (EAS_U32) (range >> 32);
+        if (next >= end)
+            return -1;
+        if (__atomic_compare_exchange_n(&pQueue->range, &range, range + 1, EAS_FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return (EAS_I32) next;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchSteal()
+ *----------------------------------------------------------------------------
+ * Takes a file from the back of another worker's range
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 EAS_BatchSteal (S_EAS_BATCH_QUEUE *pQueue)
+{
+    unsigned long long range;
+    EAS_U32 next, end;
+
+    range = __atomic_load_n(&pQueue->range, __ATOMIC_ACQUIRE);
+    for (;;)
+    {
+        next = (EAS_U32) (range & 0xffffffffUL);
+        end = (EAS_U32) (range >> 32);
+        if (next >= end)
+            return -1;
+        if (__atomic_compare_exchange_n(&pQueue->range, &range, ((unsigned long long) (end - 1) << 32) | next,
+                EAS_FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return (EAS_I32) (end - 1);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchWorker()
+ *----------------------------------------------------------------------------
+ * Worker thread, renders files until all the queues are empty
+ *----------------------------------------------------------------------------
+*/
+static void *EAS_BatchWorker (void *arg)
+{
+    S_EAS_BATCH_WORKER *pWorker = (S_EAS_BATCH_WORKER*) arg;
+    S_EAS_BATCH *pBatch = pWorker->pBatch;
+    S_EAS_BATCH_JOB *pJob;
+    long long start;
+    EAS_I32 job;
+    EAS_I32 i;
+
+    for (;;)
+    {
+        /* own files first, then steal, starting with the next worker */
+        if ((job = EAS_BatchTake(&pBatch->pQueues[pWorker->index])) < 0)
+        {
+            for (i = 1; i < pBatch->numWorkers; i++)
+            {
+                if ((job = EAS_BatchSteal(&pBatch->pQueues[(pWorker->index + i) % pBatch->numWorkers])) >= 0)
+                {
+                    pWorker->numStolen++;
+                    break;
+                }
+            }
+            if (job < 0)
+                break;
+        }
+
+        pJob = &pBatch->pJobs[job];
+        start = EAS_BatchTime();
+        pJob->result = EAS_BatchRenderFile(pWorker, pJob);
+        pJob->usecs = (EAS_I32) (EAS_BatchTime() - start);
+        pJob->thread = pWorker->index;
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchRender()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Renders a list of MIDI files on several threads
+ *
+ * Inputs:
+ * pConfig          - batch configuration, NULL for the defaults
+ * pJobs            - files to render
+ * numJobs          - number of files
+ * pStats           - returned batch results, may be NULL
+ *
+ * Outputs:
+ * returns EAS_SUCCESS if the workers ran, even if some files failed
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_BatchRender (const S_EAS_BATCH_CONFIG *pConfig, S_EAS_BATCH_JOB *pJobs, EAS_I32 numJobs, S_EAS_BATCH_STATS *pStats)
+{
+    S_EAS_BATCH batch;
+    S_EAS_BATCH_WORKER *pWorkers;
+    S_EAS_BATCH_WORKER *pWorker;
+    EAS_RESULT result;
+    long long start;
+    long numCPUs;
+    EAS_I32 numStarted;
+    EAS_I32 first, last;
+    EAS_I32 i;
+
+    if ((pJobs == NULL) || (numJobs < 0))
+        return EAS_ERROR_INVALID_PARAMETER;
+
+    /* defaults */
+    if (pConfig != NULL)
+        batch.config = *pConfig;
+    else
+    {
+        batch.config.numThreads = 0;
+        batch.config.pDLSPath = NULL;
+        batch.config.reverbPreset = EAS_PARAM_REVERB_CHAMBER;
+        batch.config.tailMs = 0;
+        batch.config.maxMs = 0;
+    }
+    batch.numWorkers = batch.config.numThreads;
+    if (batch.numWorkers <= 0)
+    {
+        numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+        batch.numWorkers = (numCPUs > 0) ? (EAS_I32) numCPUs : 1;
+    }
+    if ((batch.numWorkers > numJobs) && (numJobs > 0))
+        batch.numWorkers = numJobs;
+    batch.pJobs = pJobs;
+    batch.pLibConfig = EAS_Config();
+
+    for (i = 0; i < numJobs; i++)
+    {
+        pJobs[i].result = EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+        pJobs[i].frames = 0;
+        pJobs[i].usecs = 0;
+        pJobs[i].thread = -1;
+    }
+
+    pWorkers = calloc((size_t) batch.numWorkers, sizeof(S_EAS_BATCH_WORKER));
+    batch.pQueues = calloc((size_t) batch.numWorkers, sizeof(S_EAS_BATCH_QUEUE));
+    if ((pWorkers == NULL) || (batch.pQueues == NULL))
+    {
+        free(pWorkers);
+        free(batch.pQueues);
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+
+    /* split the files into one range per worker and allocate the buffers */
+    result = EAS_SUCCESS;
+    for (i = 0; i < batch.numWorkers; i++)
+    {
+        pWorker = &pWorkers[i];
+        pWorker->pBatch = &batch;
+        pWorker->index = i;
+        first = (EAS_I32) (((long long) numJobs * i) / batch.numWorkers);
+        last = (EAS_I32) (((long long) numJobs * (i + 1)) / batch.numWorkers);
+        batch.pQueues[i].range = ((unsigned long long) last << 32) | (unsigned long long) first;
+
+        pWorker->pPCM = malloc(sizeof(EAS_PCM) * (size_t) (batch.pLibConfig->mixBufferSize * batch.pLibConfig->numChannels));
+        pWorker->pOutBuffer = malloc(EAS_BATCH_OUT_BUFFER);
+        if ((pWorker->pPCM == NULL) || (pWorker->pOutBuffer == NULL))
+            result = EAS_ERROR_MALLOC_FAILED;
+
+#ifdef DLS_SYNTHESIZER
+        if ((result == EAS_SUCCESS) && (batch.config.pDLSPath != NULL))
+            result = EAS_BatchReadFile(batch.config.pDLSPath, &pWorker->pDLS, &pWorker->dlsAlloc, &pWorker->dlsSize);
+#endif
+        if (result != EAS_SUCCESS)
+            break;
+    }
+
+    /* run the workers */
+    start = EAS_BatchTime();
+    numStarted = 0;
+    if (result == EAS_SUCCESS)
+    {
+        for (numStarted = 0; numStarted < batch.numWorkers; numStarted++)
+        {
+            if (pthread_create(&pWorkers[numStarted].thread, NULL, EAS_BatchWorker, &pWorkers[numStarted]) != 0)
+                break;
+        }
+
+        /* the started workers steal the files of any that did not start */
+        if (numStarted == 0)
+            result = EAS_FAILURE;
+        for (i = 0; i < numStarted; i++)
+            pthread_join(pWorkers[i].thread, NULL);
+    }
+
+    if (pStats != NULL)
+    {
+        memset(pStats, 0, sizeof(S_EAS_BATCH_STATS));
+        pStats->numThreads = numStarted;
+        pStats->wallMs = (EAS_I32) ((EAS_BatchTime() - start) / 1000);
+        for (i = 0; i < numJobs; i++)
+        {
+            pStats->numFiles++;
+            if (pJobs[i].result != EAS_SUCCESS)
+                pStats->numErrors++;
+            pStats->audioSeconds += (double) pJobs[i].frames / batch.pLibConfig->sampleRate;
+        }
+        for (i = 0; i < batch.numWorkers; i++)
+            pStats->numStolen += pWorkers[i].numStolen;
+        if (pStats->wallMs > 0)
+            pStats->realTime = pStats->audioSeconds * 1000.0 / pStats->wallMs;
+    }
+
+    for (i = 0; i < batch.numWorkers; i++)
+    {
+        free(pWorkers[i].pInput);
+        free(pWorkers[i].pDLS);
+        free(pWorkers[i].pPCM);
+        free(pWorkers[i].pOutBuffer);
+    }
+    free(pWorkers);
+    free(batch.pQueues);
+    return result;
+}
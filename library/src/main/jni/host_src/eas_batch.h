@@ -0,0 +1,99 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_batch.h
+ *
+ * Contents and purpose:
+ * Batch rendering of MIDI files to WAV files on several threads. Each
+ * worker thread runs its own EAS instance and takes files from a work
+ * stealing queue, so long files do not hold up the rest of the batch.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_BATCH_H
+#define _EAS_BATCH_H
+
+#include "eas_types.h"
+
+/* for C++ linkage */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* batch configuration */
+typedef struct s_eas_batch_config_tag
+{
+    EAS_I32     numThreads;     /* worker threads, zero for one per CPU */
+    const char  *pDLSPath;      /* DLS collection loaded by every worker, or NULL */
+    EAS_I32     reverbPreset;   /* EAS_PARAM_REVERB_* preset, or -1 for no reverb */
+    EAS_I32     tailMs;         /* time rendered after the file ends */
+    EAS_I32     maxMs;          /* render time limit per file, zero for none */
+} S_EAS_BATCH_CONFIG;
+
+/* one file of the batch */
+typedef struct s_eas_batch_job_tag
+{
+    const char  *pInput;        /* MIDI file */
+    const char  *pOutput;       /* WAV file written, or NULL to discard the audio */
+    EAS_RESULT  result;         /* returned: EAS_SUCCESS or the first error */
+    EAS_I32     frames;         /* returned: sample frames rendered */
+    EAS_I32     usecs;          /* returned: time taken to render the file */
+    EAS_I32     thread;         /* returned: worker that rendered the file */
+} S_EAS_BATCH_JOB;
+
+/* results of the batch */
+typedef struct s_eas_batch_stats_tag
+{
+    EAS_I32     numThreads;     /* worker threads used */
+    EAS_I32     numFiles;       /* files rendered */
+    EAS_I32     numErrors;      /* files that failed */
+    EAS_I32     numStolen;      /* files taken from another worker's queue */
+    EAS_I32     wallMs;         /* elapsed time of the batch */
+    double      audioSeconds;   /* audio rendered */
+    double      realTime;       /* audio time divided by elapsed time */
+} S_EAS_BATCH_STATS;
+
+/*----------------------------------------------------------------------------
+ * EAS_BatchRender()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Renders a list of MIDI files to 16-bit WAV files at the library sample
+ * rate and channel count. The results of each file are returned in its
+ * job entry. Every file is rendered on a freshly initialized instance,
+ * so the output does not depend on the order or the thread count.
+ *
+ * Inputs:
+ * pConfig          - batch configuration, NULL for the defaults
+ * pJobs            - files to render
+ * numJobs          - number of files
+ * pStats           - returned batch results, may be NULL
+ *
+ * Outputs:
+ * returns EAS_SUCCESS if the workers ran, even if some files failed
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_BatchRender (const S_EAS_BATCH_CONFIG *pConfig, S_EAS_BATCH_JOB *pJobs, EAS_I32 numJobs, S_EAS_BATCH_STATS *pStats);
+
+#ifdef __cplusplus
+} /* end extern "C" */
+#endif
+
+#endif /* _EAS_BATCH_H */
@@ -0,0 +1,172 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_batch_main.c
+ *
+ * Contents and purpose:
+ * Command line batch renderer, renders MIDI files to WAV files on
+ * several threads and reports the time taken.
+ *
+ * eas_batch [-j threads] [-d dls] [-o outdir] [-r preset] [-t tailms] [-m maxms] files...
+ *
+ * Without -o the audio is rendered and discarded, which measures the
+ * synthesizer alone.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas.h"
+#include "eas_reverb.h"
+#include "eas_batch.h"
+
+/*----------------------------------------------------------------------------
+ * Usage()
+ *----------------------------------------------------------------------------
+*/
+static void Usage (const char *pName)
+{
+    fprintf(stderr, "Usage: %s [-j threads] [-d dls] [-o outdir] [-r preset] [-t tailms] [-m maxms] files...\n", pName);
+    fprintf(stderr, "  -j  worker threads, default one per CPU\n");
+    fprintf(stderr, "  -d  DLS collection\n");
+    fprintf(stderr, "  -o  directory for the WAV files, default discard the audio\n");
+    fprintf(stderr, "  -r  reverb preset 0-3, -1 for none, default %d\n", EAS_PARAM_REVERB_CHAMBER);
+    fprintf(stderr, "  -t  time rendered after the end of each file\n");
+    fprintf(stderr, "  -m  render time limit per file\n");
+}
+
+/*----------------------------------------------------------------------------
+ * OutputPath()
+ *----------------------------------------------------------------------------
+ * Returns outdir/name.wav for input path/name.mid
+ *----------------------------------------------------------------------------
+*/
+static char *OutputPath (const char *pDir, const char *pInput)
+{
+    const char *pName;
+    const char *pExt;
+    char *pPath;
+    size_t nameLen;
+
+    pName = strrchr(pInput, '/');
+    pName = (pName != NULL) ? pName + 1 : pInput;
+    pExt = strrchr(pName, '.');
+    nameLen = (pExt != NULL) ? (size_t) (pExt - pName) : strlen(pName);
+
+    if ((pPath = malloc(strlen(pDir) + nameLen + 6)) == NULL)
+        return NULL;
+    sprintf(pPath, "%s/%.*s.wav", pDir, (int) nameLen, pName);
+    return pPath;
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    S_EAS_BATCH_CONFIG config;
+    S_EAS_BATCH_STATS stats;
+    S_EAS_BATCH_JOB *pJobs;
+    const char *pOutDir;
+    EAS_RESULT result;
+    EAS_I32 numJobs;
+    int i;
+
+    config.numThreads = 0;
+    config.pDLSPath = NULL;
+    config.reverbPreset = EAS_PARAM_REVERB_CHAMBER;
+    config.tailMs = 0;
+    config.maxMs = 0;
+    pOutDir = NULL;
+
+    /* options */
+    for (i = 1; (i < argc) && (argv[i][0] == '-'); i++)
+    {
+        if ((argv[i][1] == 0) || (argv[i][2] != 0) || (i + 1 >= argc))
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+        switch (argv[i][1])
+        {
+            case 'j':
+                config.numThreads = atoi(argv[++i]);
+                break;
+            case 'd':
+                config.pDLSPath = argv[++i];
+                break;
+            case 'o':
+                pOutDir = argv[++i];
+                break;
+            case 'r':
+                config.reverbPreset = atoi(argv[++i]);
+                break;
+            case 't':
+                config.tailMs = atoi(argv[++i]);
+                break;
+            case 'm':
+                config.maxMs = atoi(argv[++i]);
+                break;
+            default:
+                Usage(argv[0]);
+                return 1;
+        }
+    }
+    if (i >= argc)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    numJobs = argc - i;
+    if ((pJobs = calloc((size_t) numJobs, sizeof(S_EAS_BATCH_JOB))) == NULL)
+        return 1;
+    for (numJobs = 0; i < argc; i++, numJobs++)
+    {
+        pJobs[numJobs].pInput = argv[i];
+        if ((pOutDir != NULL) && ((pJobs[numJobs].pOutput = OutputPath(pOutDir, argv[i])) == NULL))
+            return 1;
+    }
+
+    result = EAS_BatchRender(&config, pJobs, numJobs, &stats);
+
+    for (i = 0; i < numJobs; i++)
+    {
+        if (pJobs[i].result == EAS_SUCCESS)
+            printf("%s: %ld frames in %ld ms on thread %ld\n", pJobs[i].pInput,
+                (long) pJobs[i].frames, (long) (pJobs[i].usecs / 1000), (long) pJobs[i].thread);
+        else
+            printf("%s: error %ld\n", pJobs[i].pInput, (long) pJobs[i].result);
+        free((void*) pJobs[i].pOutput);
+    }
+    free(pJobs);
+
+    if (result != EAS_SUCCESS)
+    {
+        fprintf(stderr, "EAS_BatchRender error %ld\n", (long) result);
+        return 1;
+    }
+    printf("%ld files, %ld errors, %ld threads, %ld stolen\n", (long) stats.numFiles,
+        (long) stats.numErrors, (long) stats.numThreads, (long) stats.numStolen);
+    printf("%.1f s of audio in %ld ms, %.1fx real time\n", stats.audioSeconds,
+        (long) stats.wallMs, stats.realTime);
+    return (stats.numErrors != 0) ? 1 : 0;
+}
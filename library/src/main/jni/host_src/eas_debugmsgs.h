@@ -82,6 +82,8 @@
 { 0x1a54b6e8, 0x00000004, "eas_hostmm.c[162]: HWMemCpy: bad amount: %d\n" },
 { 0x1a54b6e8, 0x00000005, "eas_hostmm.c[179]: HWMemSet: bad amount: %d\n" },
 { 0x1a54b6e8, 0x00000006, "eas_hostmm.c[196]: HWMemCmp: bad amount: %d\n" },
+{ 0x1a54b6e8, 0x00000007, "eas_hostmm.c[268]: HWMalloc: %d bytes allocated from the heap while memory is locked\n" },
+{ 0x1a54b6e8, 0x00000008, "eas_hostmm.c[329]: HWFree: %d bytes returned to the heap while memory is locked\n" },
 /* Auto-generated from source file: eas_config.c */
 /* Auto-generated from source file: eas_main.c */
 { 0xe624f4d9, 0x00000005, "eas_main.c[106]: Play length: %d.%03d (secs)\n" },
@@ -36,6 +36,7 @@
 #define _EAS_HOST_H
 
 #include "eas_types.h"
+#include "eas_rtcheck.h"
 
 /* for C++ linkage */
 #ifdef __cplusplus
@@ -58,6 +59,8 @@ extern EAS_I32 EAS_HWMemCmp(const void *s1, const void *s2, EAS_I32 n);
 /* memory allocation */
 extern void *EAS_HWMalloc(EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size);
 extern void EAS_HWFree(EAS_HW_DATA_HANDLE hwInstData, void *p);
+extern void EAS_HWLockMemory(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL lock);
+extern void EAS_HWGetMemoryStats(EAS_HW_DATA_HANDLE hwInstData, S_EAS_MEM_STATS *pStats);
 
 /* file I/O */
 extern EAS_RESULT EAS_HWOpenFile(EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locator, EAS_FILE_HANDLE *pFile, EAS_FILE_MODE mode);
@@ -81,6 +84,11 @@ extern EAS_RESULT EAS_HWBackLight(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state)
 } /* end extern "C" */
 #endif
 
+/* record allocations made from the render path */
+#ifdef _RT_CHECK
+#define EAS_HWMalloc(hwInstData, size) (EAS_RT_CHECK("EAS_HWMalloc"), EAS_HWMalloc(hwInstData, size))
+#define EAS_HWFree(hwInstData, p) (EAS_RT_CHECK("EAS_HWFree"), EAS_HWFree(hwInstData, p))
+#endif
 
 /* host yield function */
 extern EAS_BOOL EAS_HWYield(EAS_HW_DATA_HANDLE hwInstData);
@@ -12,7 +12,15 @@
  * Modify this file to suit the needs of your particular system.
  *
  * EAS_MAX_FILE_HANDLES sets the maximum number of MIDI streams within
- * a MIDI type 1 file that can be played.
+ * a MIDI type 1 file that can be played. File handles are allocated
+ * in groups of EAS_FILE_HANDLE_GROUP as they are needed, and closed
+ * handles are kept on a free list for reuse.
+ *
+ * EAS_HWMalloc serves allocations up to EAS_POOL_MAX_SIZE from per
+ * instance pools of power of 2 size classes. Freed blocks go back to
+ * their pool, so reopening a stream or an effect reuses the memory of
+ * the last one instead of calling malloc. Larger allocations, such as
+ * the DLS tables, go directly to the heap.
  *
  * EAS_HW_FILE is a structure to support the file I/O functions. It
  * comprises the file descriptor, the file read pointer, and
@@ -63,6 +71,10 @@
 /* Only for debugging LED, vibrate, and backlight functions */
 #include "eas_report.h"
 
+/* the functions themselves are not call sites */
+#undef EAS_HWMalloc
+#undef EAS_HWFree
+
 /* this module requires dynamic memory support */
 #ifdef _STATIC_MEMORY
 #error "eas_hostmm.c requires the dynamic memory model!\n"
@@ -75,6 +87,35 @@
 #define EAS_MAX_FILE_HANDLES    100
 #endif
 
+/* number of file handles allocated at a time */
+#ifndef EAS_FILE_HANDLE_GROUP
+#define EAS_FILE_HANDLE_GROUP   8
+#endif
+
+/* size of the read-ahead block of each file handle, must be a power of 2 */
+#ifndef EAS_FILE_BLOCK_SIZE
+#define EAS_FILE_BLOCK_SIZE     4096
+#endif
+
+/* allocation pools, size classes from EAS_POOL_MIN_SIZE to EAS_POOL_MAX_SIZE */
+#define EAS_POOL_MIN_SIZE       32
+#define EAS_POOL_CLASSES        12
+#define EAS_POOL_MAX_SIZE       (EAS_POOL_MIN_SIZE << (EAS_POOL_CLASSES - 1))
+#define EAS_POOL_LARGE          -1
+
+/* header in front of every allocation, padded to keep the
+ * alignment of malloc for the caller */
+typedef union eas_hw_block_tag
+{
+    struct
+    {
+        union eas_hw_block_tag *pNext;  /* next free block in the pool */
+        EAS_I32 size;                   /* requested size */
+        EAS_I32 sizeClass;              /* pool index or EAS_POOL_LARGE */
+    } hdr;
+    EAS_U8 pad[16];
+} EAS_HW_BLOCK;
+
 /*
  * this structure and the related function are here
  * to support the ability to create duplicate handles
@@ -89,15 +130,35 @@ typedef struct eas_hw_file_tag
     int (*size)(void *handle);
     int filePos;
     void *handle;
+    EAS_U8 *block;          /* read-ahead block, allocated on first read */
+    int blockPos;           /* file position of the first byte in the block */
+    int blockLen;           /* valid bytes in the block */
+    struct eas_hw_file_tag *pNext;  /* next handle on the free list */
 } EAS_HW_FILE;
 
+typedef struct eas_hw_file_group_tag
+{
+    struct eas_hw_file_group_tag *pNext;
+    EAS_HW_FILE files[EAS_FILE_HANDLE_GROUP];
+} EAS_HW_FILE_GROUP;
+
 typedef struct eas_hw_inst_data_tag
 {
-    EAS_HW_FILE files[EAS_MAX_FILE_HANDLES];
+    EAS_HW_FILE_GROUP *pGroups;     /* all allocated handles */
+    EAS_HW_FILE *pFreeFiles;        /* handles not in use */
+    int numOpen;                    /* number of handles in use */
+    EAS_HW_BLOCK *pPools[EAS_POOL_CLASSES]; /* free blocks of each size class */
+    S_EAS_MEM_STATS memStats;       /* allocation statistics */
+    EAS_BOOL memLocked;             /* report allocations from the heap */
 } EAS_HW_INST_DATA;
 
 pthread_key_t EAS_sigbuskey;
 
+static void EAS_HWAllocStats (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size);
+static EAS_RESULT EAS_HWAllocFile (EAS_HW_DATA_HANDLE hwInstData, EAS_HW_FILE **pFile);
+static int EAS_HWFillBlock (EAS_HW_FILE *file);
+static void EAS_HWFreeBlock (EAS_HW_FILE *file);
+
 /*----------------------------------------------------------------------------
  * EAS_HWInit
  *
@@ -107,24 +168,17 @@ pthread_key_t EAS_sigbuskey;
 */
 EAS_RESULT EAS_HWInit (EAS_HW_DATA_HANDLE *pHWInstData)
 {
-    EAS_HW_FILE *file;
-    int i;
 
-    /* need to track file opens for duplicate handles */
+    /* need to track file opens for duplicate handles, the
+     * handles themselves are allocated on first use */
     *pHWInstData = malloc(sizeof(EAS_HW_INST_DATA));
     if (!(*pHWInstData))
         return EAS_ERROR_MALLOC_FAILED;
 
     EAS_HWMemSet(*pHWInstData, 0, sizeof(EAS_HW_INST_DATA));
 
-    file = (*pHWInstData)->files;
-    for (i = 0; i < EAS_MAX_FILE_HANDLES; i++)
-    {
-        file->handle = NULL;
-        file++;
-    }
-
-
+    /* start the thread that outputs messages logged while rendering */
+    EAS_LogStart();
     return EAS_SUCCESS;
 }
 
@@ -137,8 +191,33 @@ EAS_RESULT EAS_HWInit (EAS_HW_DATA_HANDLE *pHWInstData)
 */
 EAS_RESULT EAS_HWShutdown (EAS_HW_DATA_HANDLE hwInstData)
 {
+    EAS_HW_FILE_GROUP *group;
+    EAS_HW_BLOCK *block;
+    int i;
+
+    /* release the pooled memory */
+    for (i = 0; i < EAS_POOL_CLASSES; i++)
+    {
+        while ((block = hwInstData->pPools[i]) != NULL)
+        {
+            hwInstData->pPools[i] = block->hdr.pNext;
+            free(block);
+        }
+    }
+
+    /* free the file handles and their read-ahead blocks */
+    while ((group = hwInstData->pGroups) != NULL)
+    {
+        for (i = 0; i < EAS_FILE_HANDLE_GROUP; i++)
+            EAS_HWFreeBlock(&group->files[i]);
+        hwInstData->pGroups = group->pNext;
+        free(group);
+    }
 
     free(hwInstData);
+
+    /* stop the log thread if this is the last instance */
+    EAS_LogStop();
     return EAS_SUCCESS;
 }
 
@@ -153,11 +232,70 @@ EAS_RESULT EAS_HWShutdown (EAS_HW_DATA_HANDLE hwInstData)
 /*lint -esym(715, hwInstData) hwInstData available for customer use */
 void *EAS_HWMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
 {
+    EAS_HW_BLOCK *block;
+    EAS_I32 blockSize;
+    EAS_I32 sizeClass;
+
     /* Since this whole library loves signed sizes, let's not let
      * negative or 0 values through */
     if (size <= 0)
       return NULL;
-    return malloc((size_t) size);
+
+    /* find the size class */
+    sizeClass = EAS_POOL_LARGE;
+    blockSize = size;
+    if ((hwInstData != NULL) && (size <= EAS_POOL_MAX_SIZE))
+    {
+        for (sizeClass = 0, blockSize = EAS_POOL_MIN_SIZE; blockSize < size; sizeClass++)
+            blockSize <<= 1;
+
+        /* reuse a free block */
+        if ((block = hwInstData->pPools[sizeClass]) != NULL)
+        {
+            hwInstData->pPools[sizeClass] = block->hdr.pNext;
+            block->hdr.size = size;
+            EAS_HWAllocStats(hwInstData, size);
+            return block + 1;
+        }
+    }
+
+    /* the pool is empty, allocate from the heap */
+    if ((size_t) blockSize > (size_t) INT_MAX - sizeof(EAS_HW_BLOCK))
+        return NULL;
+    if ((block = malloc(sizeof(EAS_HW_BLOCK) + (size_t) blockSize)) == NULL)
+        return NULL;
+    block->hdr.pNext = NULL;
+    block->hdr.size = size;
+    block->hdr.sizeClass = sizeClass;
+
+    if (hwInstData != NULL)
+    {
+        hwInstData->memStats.heapAllocs++;
+        hwInstData->memStats.heapBytes += (EAS_I32) sizeof(EAS_HW_BLOCK) + blockSize;
+        if (hwInstData->memLocked)
+        {
+            hwInstData->memStats.lockedAllocs++;
+            EAS_ReportEx(_EAS_SEVERITY_ERROR, 0x1a54b6e8, 0x00000007 , size);
+        }
+        EAS_HWAllocStats(hwInstData, size);
+    }
+    return block + 1;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWAllocStats
+ *
+ * Updates the allocation statistics for a new allocation
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_HWAllocStats (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
+{
+    hwInstData->memStats.numAllocs++;
+    hwInstData->memStats.bytesInUse += size;
+    if (hwInstData->memStats.bytesInUse > hwInstData->memStats.peakBytes)
+        hwInstData->memStats.peakBytes = hwInstData->memStats.bytesInUse;
 }
 
 /*----------------------------------------------------------------------------
@@ -171,7 +309,63 @@ void *EAS_HWMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
 /*lint -esym(715, hwInstData) hwInstData available for customer use */
 void EAS_HWFree (EAS_HW_DATA_HANDLE hwInstData, void *p)
 {
-    free(p);
+    EAS_HW_BLOCK *block;
+
+    if (p == NULL)
+        return;
+    block = (EAS_HW_BLOCK*) p - 1;
+
+    if (hwInstData == NULL)
+    {
+        free(block);
+        return;
+    }
+
+    hwInstData->memStats.numFrees++;
+    hwInstData->memStats.bytesInUse -= block->hdr.size;
+
+    /* pooled blocks are kept for the next allocation of the same class */
+    if (block->hdr.sizeClass != EAS_POOL_LARGE)
+    {
+        block->hdr.pNext = hwInstData->pPools[block->hdr.sizeClass];
+        hwInstData->pPools[block->hdr.sizeClass] = block;
+        return;
+    }
+
+    hwInstData->memStats.heapBytes -= (EAS_I32) sizeof(EAS_HW_BLOCK) + block->hdr.size;
+    if (hwInstData->memLocked)
+    {
+        hwInstData->memStats.lockedAllocs++;
+        EAS_ReportEx(_EAS_SEVERITY_ERROR, 0x1a54b6e8, 0x00000008 , block->hdr.size);
+    }
+    free(block);
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWLockMemory
+ *
+ * When locked, allocations and frees that reach the heap are reported and
+ * counted in the statistics
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWLockMemory (EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL lock)
+{
+    hwInstData->memLocked = lock;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWGetMemoryStats
+ *
+ * Returns the allocation statistics of the instance
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWGetMemoryStats (EAS_HW_DATA_HANDLE hwInstData, S_EAS_MEM_STATS *pStats)
+{
+    *pStats = hwInstData->memStats;
 }
 
 /*----------------------------------------------------------------------------
@@ -236,8 +430,7 @@ EAS_I32 EAS_HWMemCmp (const void *s1, const void *s2, EAS_I32 amount)
 EAS_RESULT EAS_HWOpenFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locator, EAS_FILE_HANDLE *pFile, EAS_FILE_MODE mode)
 {
     EAS_HW_FILE *file;
-    int fd;
-    int i, temp;
+    EAS_RESULT result;
 
     /* set return value to NULL */
     *pFile = NULL;
@@ -246,25 +439,59 @@ EAS_RESULT EAS_HWOpenFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locat
     if (mode != EAS_FILE_READ)
         return EAS_ERROR_INVALID_FILE_MODE;
 
-    /* find an empty entry in the file table */
-    file = hwInstData->files;
-    for (i = 0; i < EAS_MAX_FILE_HANDLES; i++)
+    /* get a free handle */
+    if ((result = EAS_HWAllocFile(hwInstData, &file)) != EAS_SUCCESS)
+        return result;
+
+    file->handle = locator->handle;
+    file->readAt = locator->readAt;
+    file->size = locator->size;
+    file->filePos = 0;
+    file->blockLen = 0;
+    *pFile = file;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWAllocFile
+ *
+ * Takes a handle from the free list, allocating a new group of handles
+ * when the list is empty
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_HWAllocFile (EAS_HW_DATA_HANDLE hwInstData, EAS_HW_FILE **pFile)
+{
+    EAS_HW_FILE_GROUP *group;
+    int i;
+
+    /* too many open files */
+    if (hwInstData->numOpen >= EAS_MAX_FILE_HANDLES)
+        return EAS_ERROR_MAX_FILES_OPEN;
+
+    if (hwInstData->pFreeFiles == NULL)
     {
-        /* is this slot being used? */
-        if (file->handle == NULL)
+        group = malloc(sizeof(EAS_HW_FILE_GROUP));
+        if (group == NULL)
+            return EAS_ERROR_MALLOC_FAILED;
+        EAS_HWMemSet(group, 0, sizeof(EAS_HW_FILE_GROUP));
+
+        /* link the new handles in order so they are used first to last */
+        for (i = EAS_FILE_HANDLE_GROUP - 1; i >= 0; i--)
         {
-            file->handle = locator->handle;
-            file->readAt = locator->readAt;
-            file->size = locator->size;
-            file->filePos = 0;
-            *pFile = file;
-            return EAS_SUCCESS;
+            group->files[i].pNext = hwInstData->pFreeFiles;
+            hwInstData->pFreeFiles = &group->files[i];
         }
-        file++;
+        group->pNext = hwInstData->pGroups;
+        hwInstData->pGroups = group;
     }
 
-    /* too many open files */
-    return EAS_ERROR_MAX_FILES_OPEN;
+    *pFile = hwInstData->pFreeFiles;
+    hwInstData->pFreeFiles = (*pFile)->pNext;
+    (*pFile)->pNext = NULL;
+    hwInstData->numOpen++;
+    return EAS_SUCCESS;
 }
 
 
@@ -280,6 +507,8 @@ EAS_RESULT EAS_HWOpenFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locat
 EAS_RESULT EAS_HWReadFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, void *pBuffer, EAS_I32 n, EAS_I32 *pBytesRead)
 {
     EAS_I32 count;
+    EAS_I32 copied;
+    EAS_I32 avail;
 
     /* make sure we have a valid handle */
     if (file->handle == NULL)
@@ -288,18 +517,44 @@ EAS_RESULT EAS_HWReadFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file,
     if (n < 0)
       return EAS_EOF;
 
+    /* small reads are copied from the read-ahead block, large
+     * ones go straight to the file */
+    copied = 0;
+    while (copied < n)
+    {
+        avail = file->blockPos + file->blockLen - file->filePos;
+        if ((file->filePos < file->blockPos) || (avail <= 0))
+        {
+            if ((n - copied) >= EAS_FILE_BLOCK_SIZE)
+                break;
+            if ((avail = EAS_HWFillBlock(file)) <= 0)
+                break;
+        }
+        if (avail > n - copied)
+            avail = n - copied;
+        memcpy((EAS_U8*) pBuffer + copied, file->block + (file->filePos - file->blockPos), (size_t) avail);
+        file->filePos += avail;
+        copied += avail;
+    }
+    if (copied == n)
+    {
+        *pBytesRead = n;
+        return EAS_SUCCESS;
+    }
+
     /* calculate the bytes to read */
     count = file->size(file->handle) - file->filePos;
-    if (n < count)
-        count = n;
+    if (n - copied < count)
+        count = n - copied;
     if (count < 0)
       return EAS_EOF;
 
     /* copy the data to the requested location, and advance the pointer */
     if (count) {
-        count = file->readAt(file->handle, pBuffer, file->filePos, count);
+        count = file->readAt(file->handle, (EAS_U8*) pBuffer + copied, file->filePos, count);
     }
     file->filePos += count;
+    count += copied;
     *pBytesRead = count;
 
     /* were n bytes read? */
@@ -308,6 +563,64 @@ EAS_RESULT EAS_HWReadFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file,
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWFillBlock
+ *
+ * Loads the aligned block containing the current file position. Returns the
+ * number of bytes available from the current position, zero or less if the
+ * block cannot be used.
+ *
+ *----------------------------------------------------------------------------
+*/
+static int EAS_HWFillBlock (EAS_HW_FILE *file)
+{
+    int pos;
+    int count;
+
+    /* allocate the block on first use, without it reads go to the file */
+    if (file->block == NULL)
+    {
+        file->block = malloc(EAS_FILE_BLOCK_SIZE);
+        if (file->block == NULL)
+            return 0;
+    }
+
+    /* read the block, short at the end of the file */
+    file->blockLen = 0;
+    pos = file->filePos & ~(EAS_FILE_BLOCK_SIZE - 1);
+    count = file->size(file->handle) - pos;
+    if ((file->filePos < 0) || (count <= file->filePos - pos))
+        return 0;
+    if (count > EAS_FILE_BLOCK_SIZE)
+        count = EAS_FILE_BLOCK_SIZE;
+    count = file->readAt(file->handle, file->block, pos, count);
+    if (count <= 0)
+        return 0;
+
+    file->blockPos = pos;
+    file->blockLen = count;
+    return pos + count - file->filePos;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWFreeBlock
+ *
+ * Frees the read-ahead block of a file handle
+ *
+ *----------------------------------------------------------------------------
+*/
+static void EAS_HWFreeBlock (EAS_HW_FILE *file)
+{
+    if (file->block != NULL)
+    {
+        free(file->block);
+        file->block = NULL;
+    }
+    file->blockLen = 0;
+}
+
 /*----------------------------------------------------------------------------
  *
  * EAS_HWGetByte
@@ -320,6 +633,16 @@ EAS_RESULT EAS_HWReadFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file,
 EAS_RESULT EAS_HWGetByte (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, void *p)
 {
     EAS_I32 numread;
+    unsigned int offset;
+
+    /* fast path, byte is in the read-ahead block */
+    offset = (unsigned int) (file->filePos - file->blockPos);
+    if (offset < (unsigned int) file->blockLen)
+    {
+        *((EAS_U8*) p) = file->block[offset];
+        file->filePos++;
+        return EAS_SUCCESS;
+    }
     return EAS_HWReadFile(hwInstData, file, p, 1, &numread);
 }
 
@@ -336,12 +659,24 @@ EAS_RESULT EAS_HWGetWord (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, v
 {
     EAS_RESULT result;
     EAS_U8 c1, c2;
+    unsigned int offset;
 
-    /* read 2 bytes from the file */
-    if ((result = EAS_HWGetByte(hwInstData, file, &c1)) != EAS_SUCCESS)
-        return result;
-    if ((result = EAS_HWGetByte(hwInstData, file, &c2)) != EAS_SUCCESS)
-        return result;
+    /* fast path, both bytes are in the read-ahead block */
+    offset = (unsigned int) (file->filePos - file->blockPos);
+    if ((offset < (unsigned int) file->blockLen) && ((unsigned int) file->blockLen - offset > 1))
+    {
+        c1 = file->block[offset];
+        c2 = file->block[offset + 1];
+        file->filePos += 2;
+    }
+    else
+    {
+        /* read 2 bytes from the file */
+        if ((result = EAS_HWGetByte(hwInstData, file, &c1)) != EAS_SUCCESS)
+            return result;
+        if ((result = EAS_HWGetByte(hwInstData, file, &c2)) != EAS_SUCCESS)
+            return result;
+    }
 
     /* order them as requested */
     if (msbFirst)
@@ -365,16 +700,30 @@ EAS_RESULT EAS_HWGetDWord (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file,
 {
     EAS_RESULT result;
     EAS_U8 c1, c2,c3,c4;
+    unsigned int offset;
 
-    /* read 4 bytes from the file */
-    if ((result = EAS_HWGetByte(hwInstData, file, &c1)) != EAS_SUCCESS)
-        return result;
-    if ((result = EAS_HWGetByte(hwInstData, file, &c2)) != EAS_SUCCESS)
-        return result;
-    if ((result = EAS_HWGetByte(hwInstData, file, &c3)) != EAS_SUCCESS)
-        return result;
-    if ((result = EAS_HWGetByte(hwInstData, file, &c4)) != EAS_SUCCESS)
-        return result;
+    /* fast path, all 4 bytes are in the read-ahead block */
+    offset = (unsigned int) (file->filePos - file->blockPos);
+    if ((offset < (unsigned int) file->blockLen) && ((unsigned int) file->blockLen - offset > 3))
+    {
+        c1 = file->block[offset];
+        c2 = file->block[offset + 1];
+        c3 = file->block[offset + 2];
+        c4 = file->block[offset + 3];
+        file->filePos += 4;
+    }
+    else
+    {
+        /* read 4 bytes from the file */
+        if ((result = EAS_HWGetByte(hwInstData, file, &c1)) != EAS_SUCCESS)
+            return result;
+        if ((result = EAS_HWGetByte(hwInstData, file, &c2)) != EAS_SUCCESS)
+            return result;
+        if ((result = EAS_HWGetByte(hwInstData, file, &c3)) != EAS_SUCCESS)
+            return result;
+        if ((result = EAS_HWGetByte(hwInstData, file, &c4)) != EAS_SUCCESS)
+            return result;
+    }
 
     /* order them as requested */
     if (msbFirst)
@@ -405,6 +754,26 @@ EAS_RESULT EAS_HWFilePos (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, E
     return EAS_SUCCESS;
 } /* end EAS_HWFilePos */
 
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWFileLength
+ *
+ * Returns the length of the file
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, hwInstData) hwInstData available for customer use */
+EAS_RESULT EAS_HWFileLength (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, EAS_I32 *pLength)
+{
+
+    /* make sure we have a valid handle */
+    if (file->handle == NULL)
+        return EAS_ERROR_INVALID_HANDLE;
+
+    *pLength = file->size(file->handle);
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  *
  * EAS_HWFileSeek
@@ -468,33 +837,25 @@ EAS_RESULT EAS_HWFileSeekOfs (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fil
 EAS_RESULT EAS_HWDupHandle (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file, EAS_FILE_HANDLE *pDupFile)
 {
     EAS_HW_FILE *dupFile;
-    int i;
+    EAS_RESULT result;
 
     /* make sure we have a valid handle */
     if (file->handle == NULL)
         return EAS_ERROR_INVALID_HANDLE;
 
-    /* find an empty entry in the file table */
-    dupFile = hwInstData->files;
-    for (i = 0; i < EAS_MAX_FILE_HANDLES; i++)
-    {
-        /* is this slot being used? */
-        if (dupFile->handle == NULL)
-        {
-            /* copy info from the handle to be duplicated */
-            dupFile->handle = file->handle;
-            dupFile->filePos = file->filePos;
-            dupFile->readAt = file->readAt;
-            dupFile->size = file->size;
-
-            *pDupFile = dupFile;
-            return EAS_SUCCESS;
-        }
-        dupFile++;
-    }
+    /* get a free handle */
+    if ((result = EAS_HWAllocFile(hwInstData, &dupFile)) != EAS_SUCCESS)
+        return result;
 
-    /* too many open files */
-    return EAS_ERROR_MAX_FILES_OPEN;
+    /* copy info from the handle to be duplicated */
+    dupFile->handle = file->handle;
+    dupFile->filePos = file->filePos;
+    dupFile->readAt = file->readAt;
+    dupFile->size = file->size;
+    dupFile->blockLen = 0;
+
+    *pDupFile = dupFile;
+    return EAS_SUCCESS;
 }
 
 /*----------------------------------------------------------------------------
@@ -507,15 +868,18 @@ EAS_RESULT EAS_HWDupHandle (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file,
 */
 EAS_RESULT EAS_HWCloseFile (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE file1)
 {
-    EAS_HW_FILE *file2,*dupFile;
-    int i;
-
 
     /* make sure we have a valid handle */
     if (file1->handle == NULL)
         return EAS_ERROR_INVALID_HANDLE;
 
+    /* return the handle to the free list, the block buffer
+     * is kept for the next file opened with this handle */
     file1->handle = NULL;
+    file1->blockLen = 0;
+    file1->pNext = hwInstData->pFreeFiles;
+    hwInstData->pFreeFiles = file1;
+    hwInstData->numOpen--;
     return EAS_SUCCESS;
 }
 
@@ -593,3 +957,141 @@ EAS_BOOL EAS_HWYield (EAS_HW_DATA_HANDLE hwInstData)
     return EAS_FALSE;
 }
 
+
+#ifdef _RT_CHECK
+/* render depth of the calling thread */
+static __thread int rtDepth;
+
+/* call sites reached from the render path, shared by all threads */
+static S_EAS_RT_SITE rtSites[EAS_RT_MAX_SITES];
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWRTEnter
+ *
+ * Marks the calling thread as rendering. Calls may nest.
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWRTEnter (void)
+{
+    rtDepth++;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWRTLeave
+ *
+ * Ends a call to EAS_HWRTEnter
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWRTLeave (void)
+{
+    rtDepth--;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWRTCheck
+ *
+ * Records the call site if the calling thread is rendering. Sites are
+ * claimed with an atomic compare and swap so the check itself does not
+ * lock or allocate. Sites beyond EAS_RT_MAX_SITES are counted in the
+ * last entry.
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWRTCheck (const char *pWhat, const char *pFile, int line)
+{
+    S_EAS_RT_SITE *pSite;
+    int i;
+
+    if (rtDepth <= 0)
+        return;
+
+    for (i = 0; i < EAS_RT_MAX_SITES; i++)
+    {
+        pSite = &rtSites[i];
+
+        /* claim an empty entry */
+        if (__atomic_load_n(&pSite->pFile, __ATOMIC_ACQUIRE) == NULL)
+        {
+            const char *pEmpty = NULL;
+            if (__atomic_compare_exchange_n(&pSite->pFile, &pEmpty, pFile, EAS_FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                pSite->pWhat = pWhat;
+                __atomic_store_n(&pSite->line, line, __ATOMIC_RELEASE);
+                break;
+            }
+        }
+
+        /* wait for the line of a freshly claimed entry */
+        while (__atomic_load_n(&pSite->line, __ATOMIC_ACQUIRE) == 0)
+            ;
+        if ((pSite->pFile == pFile) && (pSite->line == line))
+            break;
+    }
+    if (i == EAS_RT_MAX_SITES)
+        pSite = &rtSites[EAS_RT_MAX_SITES - 1];
+    __atomic_fetch_add(&pSite->count, 1, __ATOMIC_RELAXED);
+
+#ifdef _RT_CHECK_TRAP
+    abort();
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWRTGetSites
+ *
+ * Copies the recorded call sites and returns the number of sites
+ *
+ *----------------------------------------------------------------------------
+*/
+int EAS_HWRTGetSites (S_EAS_RT_SITE *pSites, int maxSites)
+{
+    int i;
+
+    for (i = 0; (i < EAS_RT_MAX_SITES) && (i < maxSites); i++)
+    {
+        if (__atomic_load_n(&rtSites[i].line, __ATOMIC_ACQUIRE) == 0)
+            break;
+        pSites[i] = rtSites[i];
+    }
+    return i;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWRTClearSites
+ *
+ * Forgets the recorded call sites, must not be called while rendering
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWRTClearSites (void)
+{
+    EAS_HWMemSet(rtSites, 0, sizeof(rtSites));
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWRTReport
+ *
+ * Prints the recorded call sites to a stdio file, one per line
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWRTReport (void *file)
+{
+    S_EAS_RT_SITE sites[EAS_RT_MAX_SITES];
+    int numSites;
+    int i;
+
+    numSites = EAS_HWRTGetSites(sites, EAS_RT_MAX_SITES);
+    for (i = 0; i < numSites; i++)
+        fprintf((FILE*) file, "%s:%d: %s called %d times while rendering\n",
+            sites[i].pFile, sites[i].line, sites[i].pWhat, sites[i].count);
+}
+#endif
@@ -28,6 +28,11 @@
  *----------------------------------------------------------------------------
 */
 
+/* for clock_gettime */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #ifdef _lint
 #include "lint_stdlib.h"
 #else
@@ -36,13 +41,23 @@
 #include <stdarg.h>
 #endif
 
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <android/log.h>
+
 #include "eas_report.h"
 
+/* the functions themselves are not call sites */
+#undef EAS_ReportEx
+#undef EAS_Report
+#undef EAS_ReportX
+
 static int severityLevel = 9999;
 
 /* debug file */
 static FILE *debugFile = NULL;
-int flush = 0;
+static int flush = 0;
 
 #ifndef _NO_DEBUG_PREPROCESSOR
 
@@ -262,3 +277,341 @@ void EAS_SetDebugFile (void *file, int flushAfterWrite)
     flush = flushAfterWrite;
 } /* end EAS_SetDebugFile */
 
+/*----------------------------------------------------------------------------
+ * Asynchronous log
+ *
+ * Messages logged from the render thread with ALOGE_RT and ALOGW_RT are
+ * written to a lock-free ring as a format string and two arguments. A
+ * background thread formats and outputs them every EAS_LOG_PERIOD ms,
+ * sooner when it is woken by EAS_LogWake, which the render thread must
+ * not call, and when it is stopped by the last EAS_LogStop. Each format
+ * string is limited to EAS_LOG_RATE_LIMIT messages per EAS_LOG_RATE_WINDOW ms, and
+ * the number of messages suppressed is output with the next one let
+ * through. When the ring is full, messages are dropped and counted.
+ *----------------------------------------------------------------------------
+*/
+#define EAS_LOG_TAG             "MidiDriver"
+#define EAS_LOG_RING_SIZE       256     /* must be a power of 2 */
+#define EAS_LOG_RATE_IDS        64      /* must be a power of 2 */
+#define EAS_LOG_RATE_LIMIT      10
+#define EAS_LOG_RATE_WINDOW     1000
+#define EAS_LOG_PERIOD          200
+
+typedef struct
+{
+    unsigned long seq;          /* ring position the entry is ready for */
+    int prio;
+    int suppressed;             /* messages suppressed before this one */
+    const char *fmt;
+    long arg1;
+    long arg2;
+} S_EAS_LOG_RECORD;
+
+typedef struct
+{
+    const char *fmt;            /* format string identifying the message */
+    unsigned long windowStart;  /* start of the rate window in ms */
+    int count;                  /* messages in the window */
+    int suppressed;             /* messages suppressed since the last one */
+} S_EAS_LOG_RATE;
+
+static S_EAS_LOG_RECORD logRing[EAS_LOG_RING_SIZE];
+static S_EAS_LOG_RATE logRates[EAS_LOG_RATE_IDS];
+static unsigned long logHead;
+static unsigned long logTail;
+static unsigned long logDropped;
+static int logStarted;
+static pthread_once_t logOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t logDrainLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* log thread, started by the first EAS_LogStart and stopped by the last
+ * EAS_LogStop */
+static pthread_mutex_t logThreadLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t logThread;
+static int logUsers;
+static int logRunning;
+
+/* wakes the log thread, logWake and logStop are protected by logWaitLock,
+ * logWakeCond uses the monotonic clock and is set up by EAS_LogInit */
+static pthread_mutex_t logWaitLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t logWakeCond;
+static int logWake;
+static int logStop;
+
+/*----------------------------------------------------------------------------
+ * EAS_LogTime()
+ *
+ * Returns a monotonic time in ms
+ *----------------------------------------------------------------------------
+*/
+static unsigned long EAS_LogTime (void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long) ts.tv_sec * 1000 + (unsigned long) ts.tv_nsec / 1000000;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LogRateCheck()
+ *
+ * Applies the rate limit of a message. Returns -1 if the message is
+ * suppressed, otherwise the number of messages suppressed before it.
+ *----------------------------------------------------------------------------
+*/
+static int EAS_LogRateCheck (const char *fmt)
+{
+    S_EAS_LOG_RATE *pRate;
+    const char *pId;
+    unsigned long now;
+    unsigned long start;
+    int i, index;
+
+    /* find or claim the entry of this format string */
+    index = (int) ((unsigned long) fmt >> 3);
+    for (i = 0; i < EAS_LOG_RATE_IDS; i++, index++)
+    {
+        pRate = &logRates[index & (EAS_LOG_RATE_IDS - 1)];
+        pId = __atomic_load_n(&pRate->fmt, __ATOMIC_ACQUIRE);
+        if (pId == NULL)
+        {
+            if (__atomic_compare_exchange_n(&pRate->fmt, &pId, fmt, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                pId = fmt;
+        }
+        if (pId == fmt)
+            break;
+    }
+
+    /* the table is full, no rate limit */
+    if (i == EAS_LOG_RATE_IDS)
+        return 0;
+
+    /* start a new window */
+    now = EAS_LogTime();
+    start = __atomic_load_n(&pRate->windowStart, __ATOMIC_RELAXED);
+    if ((now - start >= EAS_LOG_RATE_WINDOW) &&
+        __atomic_compare_exchange_n(&pRate->windowStart, &start, now, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        __atomic_store_n(&pRate->count, 0, __ATOMIC_RELAXED);
+
+    if (__atomic_fetch_add(&pRate->count, 1, __ATOMIC_RELAXED) >= EAS_LOG_RATE_LIMIT)
+    {
+        __atomic_fetch_add(&pRate->suppressed, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    return __atomic_exchange_n(&pRate->suppressed, 0, __ATOMIC_RELAXED);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LogAsync()
+ *
+ * Queues a message for the log thread. Does not lock, allocate or format,
+ * so it can be called from the render thread. The arguments are passed
+ * as long, so the format should use %ld or %lx for them.
+ *----------------------------------------------------------------------------
+*/
+void EAS_LogAsync (int prio, const char *fmt, long arg1, long arg2)
+{
+    S_EAS_LOG_RECORD *pRecord;
+    unsigned long pos;
+    unsigned long seq;
+    int suppressed;
+
+    if (!__atomic_load_n(&logStarted, __ATOMIC_ACQUIRE))
+        return;
+
+    if ((suppressed = EAS_LogRateCheck(fmt)) < 0)
+        return;
+
+    /* claim a free entry */
+    pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        pRecord = &logRing[pos & (EAS_LOG_RING_SIZE - 1)];
+        seq = __atomic_load_n(&pRecord->seq, __ATOMIC_ACQUIRE);
+        if (seq == pos)
+        {
+            if (__atomic_compare_exchange_n(&logHead, &pos, pos + 1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+
+        /* the ring is full */
+        else if ((long) (seq - pos) < 0)
+        {
+            __atomic_fetch_add(&logDropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else
+            pos = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+    }
+
+    pRecord->prio = prio;
+    pRecord->suppressed = suppressed;
+    pRecord->fmt = fmt;
+    pRecord->arg1 = arg1;
+    pRecord->arg2 = arg2;
+    __atomic_store_n(&pRecord->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LogFlush()
+ *
+ * Formats and outputs the queued messages. Called by the log thread, and
+ * by tests that need the output before the thread is woken.
+ *----------------------------------------------------------------------------
+*/
+void EAS_LogFlush (void)
+{
+    S_EAS_LOG_RECORD *pRecord;
+    unsigned long dropped;
+
+    pthread_mutex_lock(&logDrainLock);
+    for (;;)
+    {
+        pRecord = &logRing[logTail & (EAS_LOG_RING_SIZE - 1)];
+        if (__atomic_load_n(&pRecord->seq, __ATOMIC_ACQUIRE) != logTail + 1)
+            break;
+
+        if (pRecord->suppressed)
+            __android_log_print(pRecord->prio, EAS_LOG_TAG, "%d similar messages suppressed", pRecord->suppressed);
+        __android_log_print(pRecord->prio, EAS_LOG_TAG, pRecord->fmt, pRecord->arg1, pRecord->arg2);
+
+        /* release the entry for the next pass around the ring */
+        __atomic_store_n(&pRecord->seq, logTail + EAS_LOG_RING_SIZE, __ATOMIC_RELEASE);
+        __atomic_store_n(&logTail, logTail + 1, __ATOMIC_RELAXED);
+    }
+
+    dropped = __atomic_exchange_n(&logDropped, 0, __ATOMIC_RELAXED);
+    if (dropped)
+        __android_log_print(ANDROID_LOG_WARN, EAS_LOG_TAG, "%lu log messages dropped", dropped);
+    pthread_mutex_unlock(&logDrainLock);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LogThread()
+ *
+ * Drains the ring every EAS_LOG_PERIOD ms and each time it is woken,
+ * until it is stopped, so the output never waits for MIDI input
+ *----------------------------------------------------------------------------
+*/
+static void *EAS_LogThread (void *arg)
+{
+    struct timespec deadline;
+
+    pthread_mutex_lock(&logWaitLock);
+    while (!logStop)
+    {
+        if (!logWake)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_nsec += EAS_LOG_PERIOD * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            if ((pthread_cond_timedwait(&logWakeCond, &logWaitLock, &deadline) != ETIMEDOUT) || logStop)
+                continue;
+        }
+        logWake = 0;
+        pthread_mutex_unlock(&logWaitLock);
+        EAS_LogFlush();
+        pthread_mutex_lock(&logWaitLock);
+    }
+    pthread_mutex_unlock(&logWaitLock);
+    return arg;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LogInit()
+ *
+ * Initializes the ring and the wake condition, once
+ *----------------------------------------------------------------------------
+*/
+static void EAS_LogInit (void)
+{
+    pthread_condattr_t attr;
+    unsigned long i;
+
+    for (i = 0; i < EAS_LOG_RING_SIZE; i++)
+        logRing[i].seq = i;
+
+    /* the drain period must not jump with the wall clock */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&logWakeCond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LogWake()
+ *
+ * Wakes the log thread if messages are queued, so they are output
+ * before the next EAS_LOG_PERIOD. Must not be called from the render
+ * thread, as it locks and may make a system call.
+ *----------------------------------------------------------------------------
+*/
+void EAS_LogWake (void)
+{
+    if (!__atomic_load_n(&logStarted, __ATOMIC_ACQUIRE))
+        return;
+
+    /* nothing to output */
+    if ((__atomic_load_n(&logHead, __ATOMIC_RELAXED) == __atomic_load_n(&logTail, __ATOMIC_RELAXED)) &&
+        (__atomic_load_n(&logDropped, __ATOMIC_RELAXED) == 0))
+        return;
+
+    pthread_mutex_lock(&logWaitLock);
+    logWake = 1;
+    pthread_cond_signal(&logWakeCond);
+    pthread_mutex_unlock(&logWaitLock);
+} /* end EAS_LogWake */
+
+/*----------------------------------------------------------------------------
+ * EAS_LogStart()
+ *
+ * Starts the log thread if it is not running, and counts the users so
+ * the last EAS_LogStop stops it. Must not be called from the render
+ * thread. Messages queued while it is not running are discarded.
+ *----------------------------------------------------------------------------
+*/
+void EAS_LogStart (void)
+{
+    pthread_once(&logOnce, EAS_LogInit);
+
+    pthread_mutex_lock(&logThreadLock);
+    if (logUsers++ == 0)
+    {
+        logStop = 0;
+        logWake = 0;
+        if (pthread_create(&logThread, NULL, EAS_LogThread, NULL) == 0)
+        {
+            logRunning = 1;
+            __atomic_store_n(&logStarted, 1, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&logThreadLock);
+} /* end EAS_LogStart */
+
+/*----------------------------------------------------------------------------
+ * EAS_LogStop()
+ *
+ * Stops and joins the log thread when the last user stops, then outputs
+ * the messages still queued. Must not be called from the render thread.
+ *----------------------------------------------------------------------------
+*/
+void EAS_LogStop (void)
+{
+    pthread_mutex_lock(&logThreadLock);
+    if ((logUsers > 0) && (--logUsers == 0) && logRunning)
+    {
+        __atomic_store_n(&logStarted, 0, __ATOMIC_RELEASE);
+        pthread_mutex_lock(&logWaitLock);
+        logStop = 1;
+        pthread_cond_signal(&logWakeCond);
+        pthread_mutex_unlock(&logWaitLock);
+        pthread_join(logThread, NULL);
+        logRunning = 0;
+        EAS_LogFlush();
+    }
+    pthread_mutex_unlock(&logThreadLock);
+} /* end EAS_LogStop */
@@ -34,6 +34,8 @@
 #ifndef _EAS_REPORT_H
 #define _EAS_REPORT_H
 
+#include "eas_rtcheck.h"
+
 #define _EAS_SEVERITY_NOFILTER 0
 #define _EAS_SEVERITY_FATAL 1
 #define _EAS_SEVERITY_ERROR 2
@@ -67,7 +69,24 @@ extern void EAS_ReportX (int severity, const char* fmt, ...);
 
 #endif
 
+/* record reports made from the render path */
+#ifdef _RT_CHECK
+#ifndef _NO_DEBUG_PREPROCESSOR
+#define EAS_ReportEx(...) (EAS_RT_CHECK("EAS_ReportEx"), EAS_ReportEx(__VA_ARGS__))
+#else
+#define EAS_Report(...) (EAS_RT_CHECK("EAS_Report"), EAS_Report(__VA_ARGS__))
+#define EAS_ReportX(...) (EAS_RT_CHECK("EAS_ReportX"), EAS_ReportX(__VA_ARGS__))
+#endif
+#endif
+
 extern void EAS_SetDebugLevel (int severity);
+
+/* asynchronous log for the render thread, see ALOGE_RT in log/log.h */
+extern void EAS_LogStart (void);
+extern void EAS_LogStop (void);
+extern void EAS_LogWake (void);
+extern void EAS_LogAsync (int prio, const char *fmt, long arg1, long arg2);
+extern void EAS_LogFlush (void);
 extern void EAS_SetDebugFile (void *file, int flushAfterWrite);
 
 #ifdef __cplusplus
@@ -0,0 +1,79 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_rtcheck.h
+ *
+ * Contents and purpose:
+ * Debug checks for the render path. When the library is built with
+ * _RT_CHECK, EAS_Render marks the calling thread as rendering, and the
+ * memory allocation, report, log and lock wrappers record their call
+ * site whenever they are called from a rendering thread. The recorded
+ * sites can be read back or printed after a test run. With
+ * _RT_CHECK_TRAP the first violation also aborts, so it can be caught
+ * in a debugger.
+ *
+ * Without _RT_CHECK the macros compile to nothing.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_RTCHECK_H
+#define _EAS_RTCHECK_H
+
+/* for C++ linkage */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _RT_CHECK
+
+/* maximum number of distinct call sites recorded */
+#define EAS_RT_MAX_SITES        64
+
+/* a call site that was reached from the render path */
+typedef struct s_eas_rt_site_tag
+{
+    const char  *pWhat;     /* name of the function or macro called */
+    const char  *pFile;     /* source file of the call */
+    int         line;       /* source line of the call */
+    int         count;      /* number of calls from the render path */
+} S_EAS_RT_SITE;
+
+extern void EAS_HWRTEnter (void);
+extern void EAS_HWRTLeave (void);
+extern void EAS_HWRTCheck (const char *pWhat, const char *pFile, int line);
+extern int EAS_HWRTGetSites (S_EAS_RT_SITE *pSites, int maxSites);
+extern void EAS_HWRTClearSites (void);
+extern void EAS_HWRTReport (void *file);
+
+#define EAS_RT_ENTER()          EAS_HWRTEnter()
+#define EAS_RT_LEAVE()          EAS_HWRTLeave()
+#define EAS_RT_CHECK(what)      EAS_HWRTCheck(what, __FILE__, __LINE__)
+
+#else
+
+#define EAS_RT_ENTER()          ((void) 0)
+#define EAS_RT_LEAVE()          ((void) 0)
+#define EAS_RT_CHECK(what)      ((void) 0)
+
+#endif
+
+#ifdef __cplusplus
+} /* end extern "C" */
+#endif
+
+#endif /* _EAS_RTCHECK_H */
@@ -35,6 +35,8 @@
 #ifndef _EAS_TYPES_H
 #define _EAS_TYPES_H
 
+#include <stdint.h>
+
 /* EAS_RESULT return codes */
 typedef long EAS_RESULT;
 #define EAS_SUCCESS                         0
@@ -133,6 +135,15 @@ typedef long EAS_LONG;
 /* audio output type */
 typedef short EAS_PCM;
 
+/* mix buffer type, fixed at 32 bits so it does not widen with long on 64-bit targets */
+typedef int32_t EAS_MIX_SAMPLE;
+
+/* MIDI 2.0 Universal MIDI Packet word, exactly 32 bits like EAS_MIX_SAMPLE */
+typedef uint32_t EAS_UMP_WORD;
+
+/* floating point output type, full scale is +/-1.0 */
+typedef float EAS_FLOAT;
+
 /* file open modes */
 typedef EAS_I32 EAS_FILE_MODE;
 #define EAS_FILE_READ   1
@@ -267,6 +278,18 @@ typedef enum
     IMODE_PLAY_PARTIAL
 } E_I_MODE_PLAY_MODE;
 
+/* memory allocation statistics returned by EAS_GetMemoryStats */
+typedef struct s_eas_mem_stats_tag
+{
+    EAS_I32     bytesInUse;         /* bytes allocated and not freed */
+    EAS_I32     peakBytes;          /* highest value of bytesInUse */
+    EAS_I32     heapBytes;          /* bytes held from the heap, including pooled free blocks */
+    EAS_I32     numAllocs;          /* number of allocations */
+    EAS_I32     numFrees;           /* number of frees */
+    EAS_I32     heapAllocs;         /* allocations that could not be served from a pool */
+    EAS_I32     lockedAllocs;       /* heap allocations and frees made while memory was locked */
+} S_EAS_MEM_STATS;
+
 typedef EAS_BOOL (*EAS_EXT_PRG_CHG_FUNC) (EAS_VOID_PTR pInstData, S_EXT_AUDIO_PRG_CHG *pPrgChg);
 typedef EAS_BOOL (*EAS_EXT_EVENT_FUNC) (EAS_VOID_PTR pInstData, S_EXT_AUDIO_EVENT *pEvent);
 
@@ -21,7 +21,7 @@
 @****************************************************************
 @
 @   where:
-@	long *pInputBuffer
+@	EAS_MIX_SAMPLE *pInputBuffer
 @	PASSED IN: r0
 @
 @	EAS_PCM *pOutputBuffer
@@ -101,8 +101,10 @@ typedef struct s_eas_data_tag
     EAS_VOID_PTR                    pMetricsData;
 #endif
 
-    EAS_I32                         *pMixBuffer;
+    EAS_MIX_SAMPLE                  *pMixBuffer;
     EAS_PCM                         *pOutputAudioBuffer;
+    EAS_FLOAT                       *pFloatOutputBuffer;
+    EAS_PCM                         *pFloatScratchBuffer;
 
 #ifdef AUX_MIXER
     S_EAS_AUX_MIXER                 auxMixer;
@@ -124,6 +126,8 @@ typedef struct s_eas_data_tag
     EAS_I16                         masterGain;
     EAS_U8                          masterVolume;
     EAS_BOOL8                       staticMemoryModel;
+    EAS_BOOL8                       mixBufferClear;
+    EAS_BOOL8                       idle;
 #ifdef FILE_HEADER_SEARCH
     EAS_BOOL8                       searchHeaderFlag;
 #endif
@@ -31,6 +31,7 @@
 #define _EAS_EFFECTS_H
 
 #include "eas_types.h"
+#include "eas_state.h"
 
 typedef struct
 {
@@ -39,6 +40,8 @@ typedef struct
     EAS_RESULT  (*pfShutdown)(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
     EAS_RESULT  (*pFGetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
     EAS_RESULT  (*pFSetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+    void        (*pfSaveState)(EAS_VOID_PTR pInstData, S_EAS_STATE_BUFFER *pState);
+    EAS_RESULT  (*pfRestoreState)(EAS_VOID_PTR pInstData, S_EAS_STATE_BUFFER *pState);
 } S_EFFECTS_INTERFACE;
 
 typedef struct
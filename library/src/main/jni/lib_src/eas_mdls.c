@@ -439,6 +439,7 @@ static EAS_I16 ConvertSustain (EAS_I32 sustain);
 static EAS_I16 ConvertLFOPhaseIncrement (EAS_I32 pitchCents);
 static EAS_I8 ConvertPan (EAS_I32 pan);
 static EAS_U8 ConvertQ (EAS_I32 q);
+static EAS_U32 DLSChecksum (const EAS_U8 *pData, EAS_I32 size);
 
 #ifdef _DEBUG_DLS
 static void DumpDLS (S_EAS *pEAS);
@@ -711,6 +712,7 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
     /* if successful, return a pointer to the EAS collection */
     if (result == EAS_SUCCESS)
     {
+        dls.pDLS->checksum = DLSChecksum(PtrOfs(dls.pDLS, sizeof(S_EAS)), size - (EAS_I32) sizeof(S_EAS));
         *ppDLS = dls.pDLS;
 #ifdef _DEBUG_DLS
         DumpDLS(dls.pDLS);
@@ -765,6 +767,35 @@ void DLSAddRef (S_DLS *pDLS)
         pDLS->refCount++;
 }
 
+/*----------------------------------------------------------------------------
+ * DLSChecksum ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * FNV-1a hash of the converted collection, which holds no pointers, so
+ * the same collection loaded into another instance gives the same hash.
+ * Saved states use it to identify the collection.
+ *
+ * Inputs:
+ * pData - converted programs, regions, articulations and samples
+ * size - size of the data in bytes
+ *
+ * Outputs:
+ * returns the hash
+ *----------------------------------------------------------------------------
+*/
+static EAS_U32 DLSChecksum (const EAS_U8 *pData, EAS_I32 size)
+{
+    EAS_U32 hash;
+
+    hash = 0x811c9dc5;
+    while (size-- > 0)
+    {
+        hash ^= *pData++;
+        hash = (EAS_U32) ((hash * 0x01000193) & 0xffffffff);
+    }
+    return hash;
+}
+
 /*----------------------------------------------------------------------------
  * NextChunk ()
  *----------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 #include "eas_midi.h"
 #include "eas_vm_protos.h"
 #include "eas_parser.h"
+#include "eas_midictrl.h"
 
 #ifdef JET_INTERFACE
 #include "jet_data.h"
@@ -68,9 +69,58 @@ typedef enum
     eSysExIgnore
 } E_SYSEX_STATES;
 
+/* controller numbers for the coalescing slots that hold a control change */
+static const EAS_U8 coalesceControllers[MIDI_COALESCE_SLOTS] =
+{
+    0,
+    0,
+    MIDI_CONTROLLER_MOD_WHEEL,
+    MIDI_CONTROLLER_VOLUME,
+    MIDI_CONTROLLER_PAN,
+    MIDI_CONTROLLER_EXPRESSION
+};
+
+/* number of data bytes in a channel message, indexed by (status >> 4) - 8 */
+static const EAS_U8 midiDataBytes[7] =
+{
+    2,      /* 0x80 note off */
+    2,      /* 0x90 note on */
+    2,      /* 0xa0 poly pressure */
+    2,      /* 0xb0 control change */
+    1,      /* 0xc0 program change */
+    1,      /* 0xd0 channel pressure */
+    2       /* 0xe0 pitch bend */
+};
+
+/* number of words in a Universal MIDI Packet, indexed by message type */
+static const EAS_U8 umpPacketWords[16] =
+{
+    1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4
+};
+
+/* UMP message types */
+#define UMP_TYPE_MIDI1_VOICE        0x2
+#define UMP_TYPE_SYSEX7             0x3
+#define UMP_TYPE_MIDI2_VOICE        0x4
+
+/* UMP SysEx7 packet status */
+#define UMP_SYSEX_COMPLETE          0x0
+#define UMP_SYSEX_START             0x1
+#define UMP_SYSEX_CONTINUE          0x2
+#define UMP_SYSEX_END               0x3
+
+/* MIDI 2.0 channel voice opcodes not found in MIDI 1.0 */
+#define UMP_OPCODE_REGISTERED       0x2
+#define UMP_OPCODE_ASSIGNABLE       0x3
+
 /* local prototypes */
 static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_INT parserMode);
 static EAS_RESULT ProcessSysExMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 c, EAS_INT parserMode);
+static EAS_RESULT ProcessUMPMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 status, EAS_U8 d1, EAS_U8 d2, EAS_INT parserMode);
+static EAS_RESULT ProcessUMPVoice2 (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_UMP_WORD *pWords, EAS_INT parserMode);
+static EAS_RESULT ProcessUMPSysEx (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_UMP_WORD *pWords, EAS_INT parserMode);
+static EAS_BOOL CoalesceMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream);
+static void FlushCoalescedChannel (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_COALESCE *pCoalesce, EAS_U8 channel);
 
 /*----------------------------------------------------------------------------
  * EAS_InitMIDIStream()
@@ -93,6 +143,7 @@ void EAS_InitMIDIStream (S_MIDI_STREAM *pMIDIStream)
     pMIDIStream->pending = EAS_FALSE;
     pMIDIStream->runningStatus = 0;
     pMIDIStream->status = 0;
+    pMIDIStream->pCoalesce = NULL;
 }
 
 /*----------------------------------------------------------------------------
@@ -129,6 +180,10 @@ EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_ST
             {
                 if (parserMode == eParserModeMetaData)
                     return EAS_SUCCESS;
+
+                /* SysEx can reset the synth, apply held controllers first */
+                if ((c == 0xf0) && (pMIDIStream->pCoalesce != NULL))
+                    EAS_FlushMIDIStream(pEASData, pSynth, pMIDIStream);
                 return ProcessSysExMessage(pEASData, pSynth, pMIDIStream, c, parserMode);
             }
 
@@ -212,6 +267,386 @@ EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_ST
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_ParseMIDIBuffer()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parses a buffer of MIDI data. Complete channel messages, with or without
+ * running status, are decoded a message at a time using the data length
+ * table and dispatched directly. SysEx, system common and real-time bytes
+ * and messages split across buffers go through EAS_ParseMIDIStream, so the
+ * stream state is the same as if every byte had been pushed individually.
+ *
+ * Inputs:
+ * pBuffer          - pointer to MIDI data
+ * count            - number of bytes in the buffer
+ *
+ * Outputs:
+ * returns EAS_RESULT (EAS_SUCCESS is OK)
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseMIDIBuffer (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_U8 *pBuffer, EAS_I32 count, EAS_INT parserMode)
+{
+    const EAS_U8 *pEnd;
+    const EAS_U8 *pData;
+    EAS_RESULT result;
+    EAS_U8 status;
+    EAS_INT numData;
+    EAS_INT length;
+
+    pEnd = pBuffer + count;
+    while (pBuffer < pEnd)
+    {
+        /* new status byte, or a data byte continuing running status */
+        if (*pBuffer & 0x80)
+        {
+            status = *pBuffer;
+            length = 1;
+        }
+        else if (!pMIDIStream->byte3)
+        {
+            status = pMIDIStream->runningStatus;
+            length = 0;
+        }
+        else
+            status = 0;
+
+        /* decode complete channel messages in one step */
+        if ((status >= 0x80) && (status < 0xf0))
+        {
+            numData = midiDataBytes[(status >> 4) - 8];
+            length += numData;
+            pData = pBuffer + length - numData;
+
+            if ((pEnd - pBuffer >= length) &&
+                ((pData[0] & 0x80) == 0) &&
+                ((numData < 2) || ((pData[1] & 0x80) == 0)))
+            {
+                pMIDIStream->runningStatus = status;
+                pMIDIStream->status = status;
+                pMIDIStream->byte3 = EAS_FALSE;
+                pMIDIStream->pending = EAS_FALSE;
+                pMIDIStream->d1 = pData[0];
+                if (numData == 2)
+                    pMIDIStream->d2 = pData[1];
+                pBuffer += length;
+
+                if (parserMode != eParserModeMetaData)
+                {
+                    if ((result = ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, parserMode)) != EAS_SUCCESS)
+                        return result;
+                }
+                continue;
+            }
+        }
+
+        /* everything else goes through the byte parser */
+        if ((result = EAS_ParseMIDIStream(pEASData, pSynth, pMIDIStream, *pBuffer++, parserMode)) != EAS_SUCCESS)
+            return result;
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_ParseMIDIEvents()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Processes an array of decoded channel messages, skipping the byte
+ * parser. The message fields of the stream are restored afterwards, so
+ * a message split across byte writes is not disturbed.
+ *
+ * Inputs:
+ * pEvents          - pointer to array of events
+ * count            - number of events
+ *
+ * Outputs:
+ * returns EAS_ERROR_PARAMETER_RANGE at the first invalid event
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseMIDIEvents (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const S_EAS_MIDI_EVENT *pEvents, EAS_I32 count, EAS_INT parserMode)
+{
+    EAS_RESULT result;
+    EAS_U8 status;
+    EAS_U8 d1;
+    EAS_U8 d2;
+
+    /* save the byte parser message fields */
+    status = pMIDIStream->status;
+    d1 = pMIDIStream->d1;
+    d2 = pMIDIStream->d2;
+
+    result = EAS_SUCCESS;
+    for (; count > 0; count--, pEvents++)
+    {
+        if ((pEvents->status < 0x80) || (pEvents->status >= 0xf0) ||
+            ((pEvents->data1 | pEvents->data2) & 0x80))
+        {
+            result = EAS_ERROR_PARAMETER_RANGE;
+            break;
+        }
+
+        pMIDIStream->status = pEvents->status;
+        pMIDIStream->d1 = pEvents->data1;
+        pMIDIStream->d2 = pEvents->data2;
+        if ((result = ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, parserMode)) != EAS_SUCCESS)
+            break;
+    }
+
+    pMIDIStream->status = status;
+    pMIDIStream->d1 = d1;
+    pMIDIStream->d2 = d2;
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_ParseUMPStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Processes an array of Universal MIDI Packet words. Packets are always
+ * word aligned and carry no running status, so the packet size comes
+ * straight from the message type table. Channel voice messages are
+ * dispatched directly and SysEx7 data goes to the SysEx parser. Utility,
+ * system and data messages the synthesizer has no use for are skipped.
+ *
+ * Inputs:
+ * pWords           - pointer to array of packet words
+ * count            - number of words
+ *
+ * Outputs:
+ * returns EAS_ERROR_PARAMETER_RANGE if the last packet is incomplete
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseUMPStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_UMP_WORD *pWords, EAS_I32 count, EAS_INT parserMode)
+{
+    EAS_RESULT result;
+    EAS_UMP_WORD word;
+    EAS_INT numWords;
+    EAS_U8 status;
+    EAS_U8 d1;
+    EAS_U8 d2;
+
+    /* save the byte parser message fields */
+    status = pMIDIStream->status;
+    d1 = pMIDIStream->d1;
+    d2 = pMIDIStream->d2;
+
+    result = EAS_SUCCESS;
+    while (count > 0)
+    {
+        word = *pWords;
+        numWords = umpPacketWords[word >> 28];
+        if (numWords > count)
+        {
+            result = EAS_ERROR_PARAMETER_RANGE;
+            break;
+        }
+
+        switch (word >> 28)
+        {
+        case UMP_TYPE_MIDI1_VOICE:
+            result = ProcessUMPMessage(pEASData, pSynth, pMIDIStream, (EAS_U8) (word >> 16),
+                (EAS_U8) ((word >> 8) & 0x7f), (EAS_U8) (word & 0x7f), parserMode);
+            break;
+
+        case UMP_TYPE_MIDI2_VOICE:
+            result = ProcessUMPVoice2(pEASData, pSynth, pMIDIStream, pWords, parserMode);
+            break;
+
+        case UMP_TYPE_SYSEX7:
+            result = ProcessUMPSysEx(pEASData, pSynth, pMIDIStream, pWords, parserMode);
+            break;
+
+        default:
+            break;
+        }
+        if (result != EAS_SUCCESS)
+            break;
+
+        pWords += numWords;
+        count -= numWords;
+    }
+
+    pMIDIStream->status = status;
+    pMIDIStream->d1 = d1;
+    pMIDIStream->d2 = d2;
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * ProcessUMPMessage()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Dispatches a MIDI 1.0 channel message decoded from a packet
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ProcessUMPMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 status, EAS_U8 d1, EAS_U8 d2, EAS_INT parserMode)
+{
+    /* system messages are not carried by channel voice packets */
+    if ((status < 0x80) || (status >= 0xf0) || (parserMode == eParserModeMetaData))
+        return EAS_SUCCESS;
+
+    pMIDIStream->status = status;
+    pMIDIStream->d1 = d1;
+    pMIDIStream->d2 = d2;
+    return ProcessMIDIMessage(pEASData, pSynth, pMIDIStream, parserMode);
+}
+
+/*----------------------------------------------------------------------------
+ * ProcessUMPVoice2()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts a MIDI 2.0 channel voice packet to the MIDI 1.0 messages the
+ * synthesizer understands. Velocities, controllers and pressure keep
+ * their top 7 bits and pitch bend its top 14 bits. A MIDI 2.0 note on is
+ * never a note off, so a velocity of zero plays at 1. Registered and
+ * assignable controllers become RPN and NRPN controller sequences.
+ * Per-note messages are ignored.
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ProcessUMPVoice2 (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_UMP_WORD *pWords, EAS_INT parserMode)
+{
+    EAS_RESULT result;
+    EAS_UMP_WORD data;
+    EAS_U8 controllers[4];
+    EAS_U8 values[4];
+    EAS_U8 channel;
+    EAS_U8 index;
+    EAS_U8 value;
+    EAS_INT i;
+
+    channel = (EAS_U8) ((pWords[0] >> 16) & 0x0f);
+    index = (EAS_U8) ((pWords[0] >> 8) & 0x7f);
+    data = pWords[1];
+
+    switch ((pWords[0] >> 20) & 0x0f)
+    {
+    case 0x8:
+        return ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0x80 | channel, index, (EAS_U8) (data >> 25), parserMode);
+
+    case 0x9:
+        value = (EAS_U8) (data >> 25);
+        if (value == 0)
+            value = 1;
+        return ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0x90 | channel, index, value, parserMode);
+
+    case 0xa:
+    case 0xb:
+        return ProcessUMPMessage(pEASData, pSynth, pMIDIStream, (EAS_U8) ((pWords[0] >> 16) & 0xf0) | channel,
+            index, (EAS_U8) (data >> 25), parserMode);
+
+    case 0xc:
+        /* bank select travels with the program change when the valid flag is set */
+        if (pWords[0] & 1)
+        {
+            if ((result = ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0xb0 | channel,
+                MIDI_CONTROLLER_BANK_SELECT_MSB, (EAS_U8) ((data >> 8) & 0x7f), parserMode)) != EAS_SUCCESS)
+                return result;
+            if ((result = ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0xb0 | channel,
+                MIDI_CONTROLLER_BANK_SELECT_LSB, (EAS_U8) (data & 0x7f), parserMode)) != EAS_SUCCESS)
+                return result;
+        }
+        return ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0xc0 | channel, (EAS_U8) ((data >> 24) & 0x7f), 0, parserMode);
+
+    case 0xd:
+        return ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0xd0 | channel, (EAS_U8) (data >> 25), 0, parserMode);
+
+    case 0xe:
+        return ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0xe0 | channel,
+            (EAS_U8) ((data >> 18) & 0x7f), (EAS_U8) (data >> 25), parserMode);
+
+    case UMP_OPCODE_REGISTERED:
+    case UMP_OPCODE_ASSIGNABLE:
+        if (((pWords[0] >> 20) & 0x0f) == UMP_OPCODE_REGISTERED)
+        {
+            controllers[0] = MIDI_CONTROLLER_SELECT_RPN_MSB;
+            controllers[1] = MIDI_CONTROLLER_SELECT_RPN_LSB;
+        }
+        else
+        {
+            controllers[0] = MIDI_CONTROLLER_SELECT_NRPN_MSB;
+            controllers[1] = MIDI_CONTROLLER_SELECT_NRPN_LSB;
+        }
+        controllers[2] = MIDI_CONTROLLER_ENTER_DATA_MSB;
+        controllers[3] = MIDI_CONTROLLER_ENTER_DATA_LSB;
+        values[0] = index;
+        values[1] = (EAS_U8) (pWords[0] & 0x7f);
+        values[2] = (EAS_U8) (data >> 25);
+        values[3] = (EAS_U8) ((data >> 18) & 0x7f);
+
+        for (i = 0; i < 4; i++)
+        {
+            if ((result = ProcessUMPMessage(pEASData, pSynth, pMIDIStream, 0xb0 | channel,
+                controllers[i], values[i], parserMode)) != EAS_SUCCESS)
+                return result;
+        }
+        return EAS_SUCCESS;
+
+    default:
+        return EAS_SUCCESS;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * ProcessUMPSysEx()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Feeds the data bytes of a SysEx7 packet to the SysEx parser, adding the
+ * start and end bytes that packets leave implicit
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ProcessUMPSysEx (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_UMP_WORD *pWords, EAS_INT parserMode)
+{
+    EAS_RESULT result;
+    EAS_INT packetStatus;
+    EAS_INT numBytes;
+    EAS_INT i;
+    EAS_U8 c;
+
+    if (parserMode == eParserModeMetaData)
+        return EAS_SUCCESS;
+
+    packetStatus = (EAS_INT) ((pWords[0] >> 20) & 0x0f);
+    numBytes = (EAS_INT) ((pWords[0] >> 16) & 0x0f);
+    if (numBytes > 6)
+        numBytes = 6;
+
+    if ((packetStatus == UMP_SYSEX_COMPLETE) || (packetStatus == UMP_SYSEX_START))
+    {
+        /* SysEx can reset the synth, apply held controllers first */
+        if (pMIDIStream->pCoalesce != NULL)
+            EAS_FlushMIDIStream(pEASData, pSynth, pMIDIStream);
+        if ((result = ProcessSysExMessage(pEASData, pSynth, pMIDIStream, 0xf0, parserMode)) != EAS_SUCCESS)
+            return result;
+    }
+
+    /* data bytes follow the status and count, two in the first word and four in the second */
+    for (i = 0; i < numBytes; i++)
+    {
+        if (i < 2)
+            c = (EAS_U8) (pWords[0] >> (8 - 8 * i));
+        else
+            c = (EAS_U8) (pWords[1] >> (24 - 8 * (i - 2)));
+        if ((result = ProcessSysExMessage(pEASData, pSynth, pMIDIStream, c & 0x7f, parserMode)) != EAS_SUCCESS)
+            return result;
+    }
+
+    if ((packetStatus == UMP_SYSEX_COMPLETE) || (packetStatus == UMP_SYSEX_END))
+        return ProcessSysExMessage(pEASData, pSynth, pMIDIStream, 0xf7, parserMode);
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * ProcessMIDIMessage()
  *----------------------------------------------------------------------------
@@ -233,6 +668,13 @@ static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_M
 {
     EAS_U8 channel;
 
+    /* hold continuous controllers until the end of the frame */
+    if ((pMIDIStream->pCoalesce != NULL) && (parserMode == eParserModePlay))
+    {
+        if (CoalesceMIDIMessage(pEASData, pSynth, pMIDIStream))
+            return EAS_SUCCESS;
+    }
+
     channel = pMIDIStream->status & 0x0f;
     switch (pMIDIStream->status & 0xf0)
     {
@@ -308,6 +750,236 @@ static EAS_RESULT ProcessMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_M
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * CoalesceMIDIMessage()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Holds pitch bend, channel pressure and continuous controller messages
+ * so that only the latest value per channel and controller reaches the
+ * synthesizer each frame. Any other message flushes the held values for
+ * its channel first, so their order relative to notes, program changes
+ * and mode messages is preserved.
+ *
+ * Inputs:
+ * pEASData         - pointer to synthesizer instance data
+ * pSynth           - pointer to synthesizer
+ * pMIDIStream      - pointer to MIDI stream with a complete message
+ *
+ * Outputs:
+ * returns EAS_TRUE if the message was held and must not be processed
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL CoalesceMIDIMessage (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream)
+{
+    S_MIDI_COALESCE *pCoalesce;
+    EAS_U8 channel;
+    EAS_INT slot;
+
+    pCoalesce = pMIDIStream->pCoalesce;
+    channel = pMIDIStream->status & 0x0f;
+
+    /* find the slot for this message */
+    switch (pMIDIStream->status & 0xf0)
+    {
+    case 0xb0:
+        switch (pMIDIStream->d1)
+        {
+        case MIDI_CONTROLLER_MOD_WHEEL:
+            slot = MIDI_COALESCE_MOD_WHEEL;
+            break;
+        case MIDI_CONTROLLER_VOLUME:
+            slot = MIDI_COALESCE_VOLUME;
+            break;
+        case MIDI_CONTROLLER_PAN:
+            slot = MIDI_COALESCE_PAN;
+            break;
+        case MIDI_CONTROLLER_EXPRESSION:
+            slot = MIDI_COALESCE_EXPRESSION;
+            break;
+        default:
+            slot = -1;
+            break;
+        }
+        break;
+
+    case 0xd0:
+        slot = MIDI_COALESCE_PRESSURE;
+        break;
+
+    case 0xe0:
+        slot = MIDI_COALESCE_PITCH_BEND;
+        break;
+
+    default:
+        slot = -1;
+        break;
+    }
+
+    /* not a continuous controller, apply held values first */
+    if (slot < 0)
+    {
+        if (pCoalesce->pendingSlots[channel])
+            FlushCoalescedChannel(pEASData, pSynth, pCoalesce, channel);
+        return EAS_FALSE;
+    }
+
+    /* replace any value already held for this slot */
+    if (pCoalesce->pendingSlots[channel] & (1 << slot))
+        pCoalesce->coalescedCount++;
+    pCoalesce->pendingSlots[channel] |= (EAS_U8) (1 << slot);
+    pCoalesce->pendingChannels |= (EAS_U16) (1 << channel);
+    pCoalesce->values[channel][slot][0] = pMIDIStream->d1;
+    pCoalesce->values[channel][slot][1] = pMIDIStream->d2;
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * FlushCoalescedChannel()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sends the held controller values for a channel to the synthesizer
+ *
+ *----------------------------------------------------------------------------
+*/
+static void FlushCoalescedChannel (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_COALESCE *pCoalesce, EAS_U8 channel)
+{
+    EAS_U8 *pValue;
+    EAS_INT pending;
+    EAS_INT slot;
+
+    pending = pCoalesce->pendingSlots[channel];
+    pCoalesce->pendingSlots[channel] = 0;
+    pCoalesce->pendingChannels &= (EAS_U16) ~(1 << channel);
+
+    for (slot = 0; pending; slot++, pending >>= 1)
+    {
+        if ((pending & 1) == 0)
+            continue;
+
+        pValue = pCoalesce->values[channel][slot];
+        switch (slot)
+        {
+        case MIDI_COALESCE_PITCH_BEND:
+            VMPitchBend(pSynth, channel, pValue[0], pValue[1]);
+            break;
+
+        case MIDI_COALESCE_PRESSURE:
+            VMChannelPressure(pSynth, channel, pValue[0]);
+            break;
+
+        default:
+            VMControlChange(pEASData->pVoiceMgr, pSynth, channel, coalesceControllers[slot], pValue[1]);
+            break;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_FlushMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sends all held controller values to the synthesizer. Called once per
+ * frame for live MIDI streams with coalescing enabled.
+ *
+ * Inputs:
+ * pEASData         - pointer to synthesizer instance data
+ * pSynth           - pointer to synthesizer
+ * pMIDIStream      - pointer to MIDI stream
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_FlushMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream)
+{
+    S_MIDI_COALESCE *pCoalesce;
+    EAS_U8 channel;
+
+    pCoalesce = pMIDIStream->pCoalesce;
+    if (pCoalesce == NULL)
+        return;
+
+    for (channel = 0; pCoalesce->pendingChannels; channel++)
+    {
+        if (pCoalesce->pendingSlots[channel])
+            FlushCoalescedChannel(pEASData, pSynth, pCoalesce, channel);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SaveMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the byte parser state of a MIDI stream and any controller values
+ * held by coalescing. JET track data belongs to the open stream and is
+ * not saved.
+ *
+ * Inputs:
+ * pMIDIStream      - pointer to MIDI stream
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_SaveMIDIStream (S_MIDI_STREAM *pMIDIStream, S_EAS_STATE_BUFFER *pState)
+{
+    S_MIDI_COALESCE *pCoalesce;
+
+    EAS_StateWrite(pState, &pMIDIStream->byte3, (EAS_I32) sizeof(pMIDIStream->byte3));
+    EAS_StateWrite(pState, &pMIDIStream->pending, (EAS_I32) sizeof(pMIDIStream->pending));
+    EAS_StateWrite(pState, &pMIDIStream->sysExState, (EAS_I32) sizeof(pMIDIStream->sysExState));
+    EAS_StateWrite(pState, &pMIDIStream->runningStatus, (EAS_I32) sizeof(pMIDIStream->runningStatus));
+    EAS_StateWrite(pState, &pMIDIStream->status, (EAS_I32) sizeof(pMIDIStream->status));
+    EAS_StateWrite(pState, &pMIDIStream->d1, (EAS_I32) sizeof(pMIDIStream->d1));
+    EAS_StateWrite(pState, &pMIDIStream->d2, (EAS_I32) sizeof(pMIDIStream->d2));
+    EAS_StateWrite(pState, &pMIDIStream->flags, (EAS_I32) sizeof(pMIDIStream->flags));
+
+    if ((pCoalesce = pMIDIStream->pCoalesce) != NULL)
+    {
+        EAS_StateWrite(pState, &pCoalesce->pendingChannels, (EAS_I32) sizeof(pCoalesce->pendingChannels));
+        EAS_StateWrite(pState, pCoalesce->pendingSlots, (EAS_I32) sizeof(pCoalesce->pendingSlots));
+        EAS_StateWrite(pState, pCoalesce->values, (EAS_I32) sizeof(pCoalesce->values));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RestoreMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the MIDI stream state saved by EAS_SaveMIDIStream. Coalescing
+ * must be enabled or disabled as it was when the state was saved.
+ *
+ * Inputs:
+ * pMIDIStream      - pointer to MIDI stream
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_RestoreMIDIStream (S_MIDI_STREAM *pMIDIStream, S_EAS_STATE_BUFFER *pState)
+{
+    S_MIDI_COALESCE *pCoalesce;
+
+    EAS_StateRead(pState, &pMIDIStream->byte3, (EAS_I32) sizeof(pMIDIStream->byte3));
+    EAS_StateRead(pState, &pMIDIStream->pending, (EAS_I32) sizeof(pMIDIStream->pending));
+    EAS_StateRead(pState, &pMIDIStream->sysExState, (EAS_I32) sizeof(pMIDIStream->sysExState));
+    EAS_StateRead(pState, &pMIDIStream->runningStatus, (EAS_I32) sizeof(pMIDIStream->runningStatus));
+    EAS_StateRead(pState, &pMIDIStream->status, (EAS_I32) sizeof(pMIDIStream->status));
+    EAS_StateRead(pState, &pMIDIStream->d1, (EAS_I32) sizeof(pMIDIStream->d1));
+    EAS_StateRead(pState, &pMIDIStream->d2, (EAS_I32) sizeof(pMIDIStream->d2));
+    EAS_StateRead(pState, &pMIDIStream->flags, (EAS_I32) sizeof(pMIDIStream->flags));
+
+    if ((pCoalesce = pMIDIStream->pCoalesce) != NULL)
+    {
+        EAS_StateRead(pState, &pCoalesce->pendingChannels, (EAS_I32) sizeof(pCoalesce->pendingChannels));
+        EAS_StateRead(pState, pCoalesce->pendingSlots, (EAS_I32) sizeof(pCoalesce->pendingSlots));
+        EAS_StateRead(pState, pCoalesce->values, (EAS_I32) sizeof(pCoalesce->values));
+    }
+}
+
 /*----------------------------------------------------------------------------
  * ProcessSysExMessage()
  *----------------------------------------------------------------------------
@@ -67,5 +67,119 @@ void EAS_InitMIDIStream (S_MIDI_STREAM *pMIDIStream);
 */
 EAS_RESULT EAS_ParseMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, EAS_U8 c, EAS_INT parserMode);
 
+/*----------------------------------------------------------------------------
+ * EAS_ParseMIDIBuffer()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parses a buffer of MIDI data, decoding complete channel messages a
+ * message at a time. Equivalent to calling EAS_ParseMIDIStream for each
+ * byte in the buffer.
+ *
+ * Inputs:
+ * pBuffer      - pointer to MIDI data
+ * count        - number of bytes in the buffer
+ *
+ * Outputs:
+ * returns EAS_RESULT (EAS_SUCCESS is OK)
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseMIDIBuffer (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_U8 *pBuffer, EAS_I32 count, EAS_INT parserMode);
+
+/*----------------------------------------------------------------------------
+ * EAS_ParseMIDIEvents()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Processes an array of decoded channel messages. The byte parser state
+ * of the stream is preserved.
+ *
+ * Inputs:
+ * pEvents      - pointer to array of events
+ * count        - number of events
+ *
+ * Outputs:
+ * returns EAS_RESULT (EAS_SUCCESS is OK)
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseMIDIEvents (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const S_EAS_MIDI_EVENT *pEvents, EAS_I32 count, EAS_INT parserMode);
+
+/*----------------------------------------------------------------------------
+ * EAS_ParseUMPStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Processes an array of MIDI 2.0 Universal MIDI Packet words. The byte
+ * parser state of the stream is preserved.
+ *
+ * Inputs:
+ * pWords       - pointer to array of packet words
+ * count        - number of words
+ *
+ * Outputs:
+ * returns EAS_RESULT (EAS_SUCCESS is OK)
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_ParseUMPStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream, const EAS_UMP_WORD *pWords, EAS_I32 count, EAS_INT parserMode);
+
+/*----------------------------------------------------------------------------
+ * EAS_FlushMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sends any controller values held by coalescing to the synthesizer.
+ *
+ * Inputs:
+ * pMIDIStream      - pointer to MIDI stream
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_FlushMIDIStream (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pMIDIStream);
+
+/*----------------------------------------------------------------------------
+ * EAS_SaveMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the parser state of a MIDI stream, see EAS_SaveState.
+ *
+ * Inputs:
+ * pMIDIStream      - pointer to MIDI stream
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_SaveMIDIStream (S_MIDI_STREAM *pMIDIStream, S_EAS_STATE_BUFFER *pState);
+
+/*----------------------------------------------------------------------------
+ * EAS_RestoreMIDIStream()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the parser state saved by EAS_SaveMIDIStream.
+ *
+ * Inputs:
+ * pMIDIStream      - pointer to MIDI stream
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_RestoreMIDIStream (S_MIDI_STREAM *pMIDIStream, S_EAS_STATE_BUFFER *pState);
+
 #endif /* #define _EAS_MIDI_H */
 
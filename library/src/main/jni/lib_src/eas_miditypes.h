@@ -34,6 +34,33 @@
 #include "eas_data.h"
 #include "eas_parser.h"
 
+/*----------------------------------------------------------------------------
+ * S_MIDI_COALESCE
+ *
+ * Holds the latest value of continuous controllers received on a live
+ * MIDI stream until the next frame or the next non-controller event on
+ * the same channel
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#define MIDI_COALESCE_CHANNELS      16
+#define MIDI_COALESCE_PITCH_BEND    0       /* slot for pitch bend */
+#define MIDI_COALESCE_PRESSURE      1       /* slot for channel pressure */
+#define MIDI_COALESCE_MOD_WHEEL     2       /* slot for controller 1 */
+#define MIDI_COALESCE_VOLUME        3       /* slot for controller 7 */
+#define MIDI_COALESCE_PAN           4       /* slot for controller 10 */
+#define MIDI_COALESCE_EXPRESSION    5       /* slot for controller 11 */
+#define MIDI_COALESCE_SLOTS         6
+
+typedef struct s_midi_coalesce_tag
+{
+    EAS_U32             coalescedCount;     /* number of events dropped */
+    EAS_U16             pendingChannels;    /* channels with pending slots */
+    EAS_U8              pendingSlots[MIDI_COALESCE_CHANNELS];
+    EAS_U8              values[MIDI_COALESCE_CHANNELS][MIDI_COALESCE_SLOTS][2];
+} S_MIDI_COALESCE;
+
 /*----------------------------------------------------------------------------
  * S_MIDI_STREAM
  *
@@ -55,6 +82,7 @@ typedef struct s_midi_stream_tag
 #ifdef JET_INTERFACE
     EAS_U32             jetData;            /* JET data */
 #endif
+    S_MIDI_COALESCE     *pCoalesce;         /* controller coalescing, NULL if disabled */
 } S_MIDI_STREAM;
 
 /* flags for S_MIDI_STREAM.flags */
@@ -84,6 +112,109 @@ typedef struct s_smf_stream_tag
     S_MIDI_STREAM       midiStream;         /* MIDI stream state */
 } S_SMF_STREAM;
 
+/*----------------------------------------------------------------------------
+ *
+ * S_SMF_EVENT
+ *
+ * One entry of the pre-merged SMF event timeline. Channel messages are
+ * stored fully decoded, with running status resolved. For SysEx the
+ * status is 0xf0 and the message is in the timeline SysEx buffer as a
+ * 4-byte length followed by the data. A status of zero marks the end.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+typedef struct s_smf_event_tag
+{
+    EAS_I32             time;               /* event time in milliseconds/256 */
+    S_EAS_MIDI_EVENT    event;              /* decoded MIDI message */
+    EAS_U8              stream;             /* index of stream the event came from */
+} S_SMF_EVENT;
+
+/*----------------------------------------------------------------------------
+ *
+ * S_SMF_TIMELINE
+ *
+ * All tracks of an SMF file decoded at prepare time into a single time
+ * sorted event array, with tempo changes already applied to the event
+ * times. Playback walks the array instead of parsing the file.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+typedef struct s_smf_timeline_tag
+{
+    S_SMF_EVENT         *pEvents;           /* time sorted event array */
+    EAS_U8              *pSysEx;            /* SysEx messages referenced by the events */
+    EAS_I32             numEvents;          /* number of events, including end marker */
+    EAS_I32             maxEvents;          /* allocated size of event array */
+    EAS_I32             sysExSize;          /* bytes used in SysEx buffer */
+    EAS_I32             maxSysEx;           /* allocated size of SysEx buffer */
+    EAS_I32             event;              /* index of next event */
+    EAS_I32             sysExPos;           /* offset of next SysEx message */
+    EAS_I32             timeBase;           /* time of first event, until the first reset */
+} S_SMF_TIMELINE;
+
+/*----------------------------------------------------------------------------
+ *
+ * S_SMF_STREAM_STATE
+ *
+ * Parser state of one stream saved in a locate checkpoint. In timeline
+ * mode the file position and ticks are not used.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+typedef struct s_smf_stream_state_tag
+{
+    EAS_I32             filePos;            /* file position of next event */
+    EAS_U32             ticks;              /* time of next event in stream */
+    S_MIDI_STREAM       midiStream;         /* MIDI stream state */
+} S_SMF_STREAM_STATE;
+
+/*----------------------------------------------------------------------------
+ *
+ * S_SMF_CHECKPOINT
+ *
+ * Parser and synth state at one point of the file. Each checkpoint is
+ * followed in memory by one S_SMF_STREAM_STATE per stream.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+typedef struct s_smf_checkpoint_tag
+{
+    S_SYNTH_STATE       synth;              /* synth channel state */
+    EAS_I32             time;               /* time of next event in milliseconds/256 */
+    EAS_I32             event;              /* index of next timeline event */
+    EAS_I32             sysExPos;           /* offset of next timeline SysEx message */
+    EAS_U16             tickConv;           /* current MIDI tick to msec conversion */
+    EAS_U16             nextStream;         /* index of stream with next event */
+    EAS_U8              flags;              /* parser flags */
+} S_SMF_CHECKPOINT;
+
+/*----------------------------------------------------------------------------
+ *
+ * S_SMF_CHECKPOINTS
+ *
+ * Checkpoints recorded while the file plays, so that EAS_Locate can
+ * start from the closest one instead of parsing from the beginning.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+typedef struct s_smf_checkpoints_tag
+{
+    EAS_U8              *pRecords;          /* checkpoint records */
+    EAS_I32             recordSize;         /* size of one record, including stream states */
+    EAS_I32             numCheckpoints;     /* number of recorded checkpoints */
+    EAS_I32             interval;           /* time between checkpoints in milliseconds/256 */
+    EAS_I32             nextTime;           /* time of next checkpoint in milliseconds/256 */
+    EAS_I32             horizon;            /* latest event time parsed in milliseconds/256 */
+    EAS_I32             locates;            /* number of locates started from a checkpoint */
+    EAS_BOOL8           recording;          /* parser time is consistent with checkpoints */
+} S_SMF_CHECKPOINTS;
+
 /*----------------------------------------------------------------------------
  *
  * S_SMF_DATA
@@ -110,12 +241,16 @@ typedef struct s_smf_data_tag
     EAS_U16             ppqn;               /* ticks per quarter note */
     EAS_U8              state;              /* current state EAS_STATE_XXXX */
     EAS_U8              flags;              /* flags - see definitions below */
+    S_SMF_TIMELINE      *pTimeline;         /* pre-merged event timeline, NULL if parsing the file */
+    S_SMF_CHECKPOINTS   *pCheckpoints;      /* locate checkpoints, NULL if disabled */
+    EAS_I32             checkpointInterval; /* checkpoint interval in msecs, zero to disable */
 } S_SMF_DATA;
 
 #define SMF_FLAGS_CHASE_MODE        0x01    /* chase mode - skip to first note */
 #define SMF_FLAGS_HAS_TIME_SIG      0x02    /* time signature encountered at time 0 */
 #define SMF_FLAGS_HAS_TEMPO         0x04    /* tempo encountered at time 0  */
 #define SMF_FLAGS_HAS_GM_ON         0x08    /* GM System On encountered at time 0 */
+#define SMF_FLAGS_TIMELINE          0x10    /* build event timeline at prepare time */
 #define SMF_FLAGS_JET_STREAM        0x80    /* JET in use - keep strict timing */
 
 /* combo flags indicate setup bar */
@@ -132,6 +267,7 @@ typedef struct s_interactive_midi_tag
 #endif
     S_SYNTH     *pSynth;            /* pointer to synth */
     S_MIDI_STREAM       stream;             /* stream data */
+    S_MIDI_COALESCE     coalesce;           /* controller coalescing state */
 } S_INTERACTIVE_MIDI;
 
 #endif /* #ifndef _EAS_MIDITYPES_H */
@@ -41,11 +41,15 @@
 #include "eas_mixer.h"
 #include "eas_config.h"
 #include "eas_report.h"
+#include "eas_reverb.h"
 
 #ifdef _MAXIMIZER_ENABLED
 EAS_I32 MaximizerProcess (EAS_VOID_PTR pInstData, EAS_I32 *pSrc, EAS_I32 *pDst, EAS_I32 numSamples);
 #endif
 
+static void EAS_MixEnginePostFloat (S_EAS_DATA *pEASData, EAS_U16 gain, EAS_I32 numSamples);
+static EAS_BOOL EAS_MixEngineIdle (S_EAS_DATA *pEASData);
+
 /*------------------------------------
  * defines
  *------------------------------------
@@ -54,6 +58,9 @@ EAS_I32 MaximizerProcess (EAS_VOID_PTR pInstData, EAS_I32 *pSrc, EAS_I32 *pDst,
 /* need to boost stereo by ~3dB to compensate for the panner */
 #define STEREO_3DB_GAIN_BOOST       512
 
+/* clips a float sample to the range of the 16-bit output */
+#define CLIP_FLOAT(x)               ((x) > 1.0f ? 1.0f : ((x) < -1.0f ? -1.0f : (x)))
+
 /*----------------------------------------------------------------------------
  * EAS_MixEngineInit()
  *----------------------------------------------------------------------------
@@ -77,13 +84,21 @@ EAS_RESULT EAS_MixEngineInit (S_EAS_DATA *pEASData)
     if (pEASData->staticMemoryModel)
         pEASData->pMixBuffer = EAS_CMEnumData(EAS_CM_MIX_BUFFER);
     else
-        pEASData->pMixBuffer = EAS_HWMalloc(pEASData->hwInstData, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_I32));
+        pEASData->pMixBuffer = EAS_HWMalloc(pEASData->hwInstData, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_MIX_SAMPLE));
     if (pEASData->pMixBuffer == NULL)
     {
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_FATAL, "Failed to allocate mix buffer memory\n"); */ }
         return EAS_ERROR_MALLOC_FAILED;
     }
-    EAS_HWMemSet((void *)(pEASData->pMixBuffer), 0, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_I32));
+    EAS_HWMemSet((void *)(pEASData->pMixBuffer), 0, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * sizeof(EAS_MIX_SAMPLE));
+
+    /* scratch for EAS_RenderFloat, holds the 16-bit dry and wet side-chain buffers */
+    if (!pEASData->staticMemoryModel)
+    {
+        pEASData->pFloatScratchBuffer = EAS_HWMalloc(pEASData->hwInstData, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS * 2 * sizeof(EAS_PCM));
+        if (pEASData->pFloatScratchBuffer == NULL)
+            return EAS_ERROR_MALLOC_FAILED;
+    }
 
     return EAS_SUCCESS;
 }
@@ -107,11 +122,15 @@ EAS_RESULT EAS_MixEngineInit (S_EAS_DATA *pEASData)
 void EAS_MixEnginePrep (S_EAS_DATA *pEASData, EAS_I32 numSamples)
 {
 
+    /* mix buffer is still clear if nothing was rendered last frame */
+    if (pEASData->mixBufferClear)
+        return;
+
     /* clear the mix buffer */
 #if (NUM_OUTPUT_CHANNELS == 2)
-    EAS_HWMemSet(pEASData->pMixBuffer, 0, numSamples * (EAS_I32) sizeof(long) * 2);
+    EAS_HWMemSet(pEASData->pMixBuffer, 0, numSamples * (EAS_I32) sizeof(EAS_MIX_SAMPLE) * 2);
 #else
-    EAS_HWMemSet(pEASData->pMixBuffer, 0, (EAS_I32) numSamples * (EAS_I32) sizeof(long));
+    EAS_HWMemSet(pEASData->pMixBuffer, 0, (EAS_I32) numSamples * (EAS_I32) sizeof(EAS_MIX_SAMPLE));
 #endif
 
     /* need to clear other side-chain effect buffers (chorus & reverb) */
@@ -136,6 +155,17 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
 {
     EAS_U16 gain;
 
+    /* synth is idle, write silence and skip the DSP */
+    pEASData->idle = (EAS_BOOL8) EAS_MixEngineIdle(pEASData);
+    if (pEASData->idle)
+    {
+        if (pEASData->pFloatOutputBuffer != NULL)
+            EAS_HWMemSet(pEASData->pFloatOutputBuffer, 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_FLOAT));
+        else
+            EAS_HWMemSet(pEASData->pOutputAudioBuffer, 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_PCM));
+        return;
+    }
+
 //3 dls: Need to restore the mix engine metrics
 
     /* calculate the gain multiplier */
@@ -168,6 +198,13 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
     gain = gain >> 4;
 #endif
 
+    /* float output has its own mixdown */
+    if (pEASData->pFloatOutputBuffer != NULL)
+    {
+        EAS_MixEnginePostFloat(pEASData, gain, numSamples);
+        return;
+    }
+
     /* convert 32-bit mix buffer to 16-bit output format */
 #if (NUM_OUTPUT_CHANNELS == 2)
     SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) ((EAS_U16) numSamples * 2));
@@ -216,6 +253,7 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
             pEASData->pOutputAudioBuffer,
             (EAS_PCM*) pEASData->pMixBuffer,
             numSamples);
+    pEASData->mixBufferClear = EAS_FALSE;
 #endif
 
 #ifdef _TONECONTROLEQ_ENABLED
@@ -250,6 +288,123 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
 
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineIdle
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns true if the frame is silent: no voices were rendered into the
+ * mix buffer and the effects have no tail left to play out.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ *
+ * Outputs:
+ *
+ * Notes:
+ * Only the reverb reports its tail, so any other active effects
+ * module keeps the mixer running.
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL EAS_MixEngineIdle (S_EAS_DATA *pEASData)
+{
+    EAS_INT module;
+
+    /* voices were rendered this frame */
+    if (!pEASData->mixBufferClear)
+        return EAS_FALSE;
+
+    for (module = 0; module < NUM_EFFECTS_MODULES; module++)
+    {
+        if (pEASData->effectsModules[module].effectData == NULL)
+            continue;
+
+#ifdef _REVERB_ENABLED
+        /* reverb is idle when its tail has died away */
+        if (module == EAS_MODULE_REVERB)
+        {
+            EAS_I32 idle;
+
+            if ((*pEASData->effectsModules[module].effect->pFGetParam)
+                (pEASData->effectsModules[module].effectData, EAS_PARAM_REVERB_IDLE, &idle) != EAS_SUCCESS)
+                return EAS_FALSE;
+            if (!idle)
+                return EAS_FALSE;
+            continue;
+        }
+#endif
+
+        return EAS_FALSE;
+    }
+
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_MixEnginePostFloat
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Final mixdown for EAS_RenderFloat. The 32-bit mix buffer is scaled
+ * straight to float, so the output keeps the bits below the 16-bit
+ * LSB, and is clipped to +/-1.0 where the 16-bit output saturates.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ * gain             - master gain, as passed to SynthMasterGain
+ * numSamples       - number of sample frames
+ *
+ * Outputs:
+ *
+ * Notes:
+ * The reverb works on 16-bit delay lines, so it is fed a saturated
+ * copy of the dry signal and writes its wet output into a cleared
+ * side-chain buffer, which is then summed into the float output.
+ * The dry signal is clipped before the sum and the sum after it, as
+ * the 16-bit path does, so the two outputs differ by less than 2 LSB;
+ * loud passages mixed hotter than full scale would otherwise reach
+ * the device as out of range samples.
+ * The other effects modules are not supported in this mode.
+ *----------------------------------------------------------------------------
+*/
+static void EAS_MixEnginePostFloat (S_EAS_DATA *pEASData, EAS_U16 gain, EAS_I32 numSamples)
+{
+    EAS_FLOAT *pOutputBuffer;
+    EAS_FLOAT scale;
+    EAS_INT count;
+    EAS_INT i;
+
+    pOutputBuffer = pEASData->pFloatOutputBuffer;
+    count = (EAS_INT) numSamples * NUM_OUTPUT_CHANNELS;
+
+    /* same overall scale as SynthMasterGain, with 16-bit full scale at 1.0 */
+    scale = (EAS_FLOAT) gain * (1.0f / 2147483648.0f);
+    for (i = 0; i < count; i++)
+        pOutputBuffer[i] = CLIP_FLOAT((EAS_FLOAT) pEASData->pMixBuffer[i] * scale);
+
+#ifdef _REVERB_ENABLED
+    if (pEASData->effectsModules[EAS_MODULE_REVERB].effectData)
+    {
+        EAS_PCM *pDry;
+        EAS_PCM *pWet;
+
+        pDry = pEASData->pFloatScratchBuffer;
+        pWet = pDry + count;
+
+        /* 16-bit copy of the dry signal feeds the reverb input */
+        SynthMasterGain(pEASData->pMixBuffer, pDry, gain, (EAS_U16) count);
+        EAS_HWMemSet(pWet, 0, count * (EAS_I32) sizeof(EAS_PCM));
+
+        (*pEASData->effectsModules[EAS_MODULE_REVERB].effect->pfProcess)
+            (pEASData->effectsModules[EAS_MODULE_REVERB].effectData,
+            pDry,
+            pWet,
+            numSamples);
+
+        for (i = 0; i < count; i++)
+            pOutputBuffer[i] = CLIP_FLOAT(pOutputBuffer[i] + (EAS_FLOAT) pWet[i] * (1.0f / 32768.0f));
+    }
+#endif
+}
+
 #ifndef NATIVE_EAS_KERNEL
 /*----------------------------------------------------------------------------
  * SynthMasterGain
@@ -261,24 +416,33 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
  *
  * Outputs:
  *
+ * Notes:
+ * The loop is kept free of branches and uses fixed-width types so
+ * the compiler can vectorize it on targets without a native kernel.
+ * The product is widened to 64 bits to match the 48-bit SMULWB
+ * result of the ARM-E version.
  *----------------------------------------------------------------------------
 */
-void SynthMasterGain (long *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_U16 numSamples) {
+void SynthMasterGain (EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_U16 numSamples) {
+
+    EAS_INT i;
+
+#ifdef EAS_SIMD_MIXER
+    /* use the SIMD kernel if there is one for this CPU */
+    if (EAS_SIMDMasterGain(pInputBuffer, pOutputBuffer, nGain, numSamples))
+        return;
+#endif
 
     /* loop through the buffer */
-    while (numSamples) {
-        long s;
+    for (i = 0; i < numSamples; i++) {
+        int64_t s;
 
-        numSamples--;
         /* read a sample from the input buffer and add some guard bits */
-        s = *pInputBuffer++;
-
-        /* add some guard bits */
         /*lint -e{704} <avoid divide for performance>*/
-        s = s >> 7;
+        s = pInputBuffer[i] >> 7;
 
         /* apply master gain */
-        s *= (long) nGain;
+        s *= nGain;
 
         /* shift to lower 16-bits */
         /*lint -e{704} <avoid divide for performance>*/
@@ -287,7 +451,7 @@ void SynthMasterGain (long *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain,
         /* saturate */
         s = SATURATE(s);
 
-        *pOutputBuffer++ = (EAS_PCM)s;
+        pOutputBuffer[i] = (EAS_PCM) s;
     }
 }
 #endif
@@ -314,6 +478,8 @@ EAS_RESULT EAS_MixEngineShutdown (S_EAS_DATA *pEASData)
     /* check Configuration Module for static memory allocation */
     if (!pEASData->staticMemoryModel && (pEASData->pMixBuffer != NULL))
         EAS_HWFree(pEASData->hwInstData, pEASData->pMixBuffer);
+    if (!pEASData->staticMemoryModel && (pEASData->pFloatScratchBuffer != NULL))
+        EAS_HWFree(pEASData->hwInstData, pEASData->pFloatScratchBuffer);
 
     return EAS_SUCCESS;
 }
@@ -336,7 +502,7 @@ EAS_RESULT EAS_MixEngineShutdown (S_EAS_DATA *pEASData)
  *              bit 1 = stereo output
  *----------------------------------------------------------------------------
 */
-void EAS_MixStream (EAS_PCM *pInputBuffer, EAS_I32 *pMixBuffer, EAS_I32 numSamples, EAS_I32 gainLeft, EAS_I32 gainRight, EAS_I32 gainIncLeft, EAS_I32 gainIncRight, EAS_I32 flags)
+void EAS_MixStream (EAS_PCM *pInputBuffer, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 numSamples, EAS_I32 gainLeft, EAS_I32 gainRight, EAS_I32 gainIncLeft, EAS_I32 gainIncRight, EAS_I32 flags)
 {
     EAS_I32 temp;
     EAS_INT src, dest;
@@ -40,7 +40,18 @@
 
 #include "eas_effects.h"
 
-extern void SynthMasterGain( long *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_U16 nNumLoopSamples);
+extern void SynthMasterGain( EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_U16 nNumLoopSamples);
+
+#ifdef EAS_SIMD_MIXER
+/*----------------------------------------------------------------------------
+ * SIMD kernels (eas_mixer_simd.c)
+ *----------------------------------------------------------------------------
+ * These return EAS_FALSE if there is no SIMD version for this CPU or
+ * buffer length, in which case the caller runs the C loop.
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL EAS_SIMDMasterGain (const EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_I32 numSamples);
+#endif
 
 /*----------------------------------------------------------------------------
  * EAS_MixEngineInit()
@@ -130,7 +141,7 @@ EAS_RESULT EAS_MixEngineShutdown (EAS_DATA_HANDLE pEASData);
  *              bit 1 = stereo output
  *----------------------------------------------------------------------------
 */
-void EAS_MixStream (EAS_PCM *pInputBuffer, EAS_I32 *pMixBuffer, EAS_I32 numSamples, EAS_I32 gainLeft, EAS_I32 gainRight, EAS_I32 gainIncLeft, EAS_I32 gainIncRight, EAS_I32 flags);
+void EAS_MixStream (EAS_PCM *pInputBuffer, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 numSamples, EAS_I32 gainLeft, EAS_I32 gainRight, EAS_I32 gainIncLeft, EAS_I32 gainIncRight, EAS_I32 flags);
 #endif
 
 #endif /* #ifndef _EAS_MIXER_H */
@@ -0,0 +1,198 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_mixer_simd.c
+ *
+ * Contents and purpose:
+ * SIMD versions of the master gain loop for targets that do not have
+ * a native ARM-E kernel. NEON is used on ARM, SSE4.1
+ * and AVX2 on x86. The x86 versions are selected at run time.
+ *
+ * All kernels are bit exact with the C version in eas_mixer.c. The
+ * caller falls back to the C loop when a kernel returns EAS_FALSE.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include "eas_types.h"
+#include "eas_mixer.h"
+
+#ifdef EAS_SIMD_MIXER
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EAS_SIMD_NEON
+#elif defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#define EAS_SIMD_X86
+#endif
+
+/*----------------------------------------------------------------------------
+ * Master gain
+ *
+ * The C version computes ((s >> 7) * nGain) >> 9 with a wide product.
+ * To stay in 32-bit lanes the shifted sample a = s >> 7 is split into
+ * a = (hi << 9) + lo, where lo is 0..511. Then
+ *
+ *     (a * nGain) >> 9 == hi * nGain + ((lo * nGain) >> 9)
+ *
+ * exactly, and neither product can overflow while nGain < 0x8000.
+ *----------------------------------------------------------------------------
+*/
+#define MASTER_GAIN_SPLIT_BITS  9
+#define MASTER_GAIN_SPLIT_MASK  ((1 << MASTER_GAIN_SPLIT_BITS) - 1)
+#define MASTER_GAIN_MAX_SIMD    0x7fff
+
+#ifdef EAS_SIMD_NEON
+/*----------------------------------------------------------------------------
+ * MasterGainNEON
+ *----------------------------------------------------------------------------
+*/
+static void MasterGainNEON (const EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_I32 numSamples)
+{
+    int32x4_t mask = vdupq_n_s32(MASTER_GAIN_SPLIT_MASK);
+    int32_t gain = (int32_t) nGain;
+
+    while (numSamples > 0)
+    {
+        int32x4_t a0 = vshrq_n_s32(vld1q_s32(pInputBuffer), 7);
+        int32x4_t a1 = vshrq_n_s32(vld1q_s32(pInputBuffer + 4), 7);
+
+        int32x4_t r0 = vmulq_n_s32(vshrq_n_s32(a0, MASTER_GAIN_SPLIT_BITS), gain);
+        int32x4_t r1 = vmulq_n_s32(vshrq_n_s32(a1, MASTER_GAIN_SPLIT_BITS), gain);
+        r0 = vaddq_s32(r0, vshrq_n_s32(vmulq_n_s32(vandq_s32(a0, mask), gain), MASTER_GAIN_SPLIT_BITS));
+        r1 = vaddq_s32(r1, vshrq_n_s32(vmulq_n_s32(vandq_s32(a1, mask), gain), MASTER_GAIN_SPLIT_BITS));
+
+        /* saturating narrow to 16 bits */
+        vst1q_s16(pOutputBuffer, vcombine_s16(vqmovn_s32(r0), vqmovn_s32(r1)));
+
+        pInputBuffer += 8;
+        pOutputBuffer += 8;
+        numSamples -= 8;
+    }
+}
+#endif
+
+#ifdef EAS_SIMD_X86
+/*----------------------------------------------------------------------------
+ * MasterGainSSE41
+ *----------------------------------------------------------------------------
+*/
+__attribute__((target("sse4.1")))
+static void MasterGainSSE41 (const EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_I32 numSamples)
+{
+    __m128i mask = _mm_set1_epi32(MASTER_GAIN_SPLIT_MASK);
+    __m128i gain = _mm_set1_epi32((int32_t) nGain);
+
+    while (numSamples > 0)
+    {
+        __m128i a0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i *) pInputBuffer), 7);
+        __m128i a1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i *) (pInputBuffer + 4)), 7);
+
+        __m128i r0 = _mm_mullo_epi32(_mm_srai_epi32(a0, MASTER_GAIN_SPLIT_BITS), gain);
+        __m128i r1 = _mm_mullo_epi32(_mm_srai_epi32(a1, MASTER_GAIN_SPLIT_BITS), gain);
+        r0 = _mm_add_epi32(r0, _mm_srai_epi32(_mm_mullo_epi32(_mm_and_si128(a0, mask), gain), MASTER_GAIN_SPLIT_BITS));
+        r1 = _mm_add_epi32(r1, _mm_srai_epi32(_mm_mullo_epi32(_mm_and_si128(a1, mask), gain), MASTER_GAIN_SPLIT_BITS));
+
+        /* saturating pack to 16 bits */
+        _mm_storeu_si128((__m128i *) pOutputBuffer, _mm_packs_epi32(r0, r1));
+
+        pInputBuffer += 8;
+        pOutputBuffer += 8;
+        numSamples -= 8;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * MasterGainAVX2
+ *----------------------------------------------------------------------------
+*/
+__attribute__((target("avx2")))
+static void MasterGainAVX2 (const EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_I32 numSamples)
+{
+    __m256i mask = _mm256_set1_epi32(MASTER_GAIN_SPLIT_MASK);
+    __m256i gain = _mm256_set1_epi32((int32_t) nGain);
+
+    /* 16 samples per pass, the SSE4.1 loop picks up any remainder */
+    while (numSamples >= 16)
+    {
+        __m256i a0 = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *) pInputBuffer), 7);
+        __m256i a1 = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *) (pInputBuffer + 8)), 7);
+
+        __m256i r0 = _mm256_mullo_epi32(_mm256_srai_epi32(a0, MASTER_GAIN_SPLIT_BITS), gain);
+        __m256i r1 = _mm256_mullo_epi32(_mm256_srai_epi32(a1, MASTER_GAIN_SPLIT_BITS), gain);
+        r0 = _mm256_add_epi32(r0, _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_and_si256(a0, mask), gain), MASTER_GAIN_SPLIT_BITS));
+        r1 = _mm256_add_epi32(r1, _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_and_si256(a1, mask), gain), MASTER_GAIN_SPLIT_BITS));
+
+        /* pack works within 128-bit lanes, so put the quadwords back in order */
+        _mm256_storeu_si256((__m256i *) pOutputBuffer, _mm256_permute4x64_epi64(_mm256_packs_epi32(r0, r1), 0xd8));
+
+        pInputBuffer += 16;
+        pOutputBuffer += 16;
+        numSamples -= 16;
+    }
+
+    if (numSamples > 0)
+        MasterGainSSE41(pInputBuffer, pOutputBuffer, nGain, numSamples);
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * EAS_SIMDMasterGain
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * SIMD version of SynthMasterGain
+ *
+ * Inputs:
+ *
+ * Outputs:
+ * Returns EAS_TRUE if the buffer was processed
+ *
+ * Notes:
+ * numSamples must be a multiple of 8
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL EAS_SIMDMasterGain (const EAS_MIX_SAMPLE *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_I32 numSamples)
+{
+    if ((numSamples & 7) || (nGain > MASTER_GAIN_MAX_SIMD))
+        return EAS_FALSE;
+
+#if defined(EAS_SIMD_NEON)
+    MasterGainNEON(pInputBuffer, pOutputBuffer, nGain, numSamples);
+    return EAS_TRUE;
+
+#elif defined(EAS_SIMD_X86)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        MasterGainAVX2(pInputBuffer, pOutputBuffer, nGain, numSamples);
+        return EAS_TRUE;
+    }
+
+#ifndef __SSE4_1__
+    if (!__builtin_cpu_supports("sse4.1"))
+        return EAS_FALSE;
+#endif
+
+    MasterGainSSE41(pInputBuffer, pOutputBuffer, nGain, numSamples);
+    return EAS_TRUE;
+
+#else
+    return EAS_FALSE;
+#endif
+}
+
+#endif
@@ -92,7 +92,14 @@ typedef enum
     PARSER_DATA_NOTE_COUNT,
     PARSER_DATA_MAX_PCM_STREAMS,
     PARSER_DATA_GAIN_OFFSET,
-    PARSER_DATA_PLAY_MODE
+    PARSER_DATA_PLAY_MODE,
+    PARSER_DATA_TIMELINE,
+    PARSER_DATA_CHECKPOINT_INTERVAL,
+    PARSER_DATA_CHECKPOINT_LOCATES,
+
+    /* the value is a pointer to an S_EAS_STATE_BUFFER, see eas_state.h */
+    PARSER_DATA_SAVE_STATE,
+    PARSER_DATA_RESTORE_STATE
 } E_PARSER_DATA;
 
 #endif /* #ifndef _EAS_PARSER_H */
@@ -685,10 +685,112 @@ EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
 }
 
 /*----------------------------------------------------------------------------
- * EAS_Render()
+ * EAS_SetTimelineMode()
  *----------------------------------------------------------------------------
  * Purpose:
- * Parse the Midi data and render PCM audio data.
+ * Enables the pre-merged event timeline for an SMF file. Must be called
+ * before EAS_Prepare.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - file handle
+ * enable           - EAS_TRUE to build the timeline
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetTimelineMode (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_BOOL enable)
+{
+    if (pStream->pParserModule == NULL)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    return EAS_SetStreamParameter(pEASData, pStream, PARSER_DATA_TIMELINE, (EAS_I32) enable);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetCheckpointInterval()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the interval of the SMF locate checkpoints. Must be called before
+ * EAS_Prepare.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - file handle
+ * milliseconds     - checkpoint interval, zero disables checkpoints
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetCheckpointInterval (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_I32 milliseconds)
+{
+    if (pStream->pParserModule == NULL)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    return EAS_SetStreamParameter(pEASData, pStream, PARSER_DATA_CHECKPOINT_INTERVAL, milliseconds);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_LockMemory()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reports allocations that reach the heap from now on
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * lock             - EAS_TRUE to lock, EAS_FALSE to unlock
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_LockMemory (EAS_DATA_HANDLE pEASData, EAS_BOOL lock)
+{
+    if (pEASData->staticMemoryModel)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    EAS_HWLockMemory(pEASData->hwInstData, lock);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_GetMemoryStats()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the allocation statistics of the instance
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pStats           - pointer to the structure to fill
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetMemoryStats (EAS_DATA_HANDLE pEASData, S_EAS_MEM_STATS *pStats)
+{
+    if (pEASData->staticMemoryModel)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    EAS_HWGetMemoryStats(pEASData->hwInstData, pStats);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderBuffer()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parse the Midi data and render PCM audio data, called by EAS_Render.
  *
  * Inputs:
  *  pEASData        - buffer for internal EAS data
@@ -701,7 +803,7 @@ EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
  *
  *----------------------------------------------------------------------------
 */
-EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+static EAS_RESULT EAS_RenderBuffer (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
 {
     S_FILE_PARSER_INTERFACE *pParserModule;
     EAS_RESULT result;
@@ -846,6 +948,9 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
         return result;
     }
 
+    /* nothing was mixed, so the mix buffer need not be cleared next frame */
+    pEASData->mixBufferClear = (EAS_BOOL8) (voicesRendered == 0);
+
 #ifdef _METRICS_ENABLED
     /* stop the render timer */
     if (pEASData->pMetricsData) {
@@ -939,6 +1044,113 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_Render()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parse the Midi data and render PCM audio data.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    EAS_RESULT result;
+
+    /* with _RT_CHECK, mark the thread as rendering */
+    EAS_RT_ENTER();
+    result = EAS_RenderBuffer(pEASData, pOut, numRequested, pNumGenerated);
+    EAS_RT_LEAVE();
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RenderFloat()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Parse the Midi data and render floating point audio data.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if audio data was successfully rendered
+ *
+ * Notes:
+ * This runs the normal render with the 16-bit output redirected to a
+ * scratch buffer. EAS_MixEnginePost sees the float buffer and writes
+ * the final mix there instead.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderFloat (EAS_DATA_HANDLE pEASData, EAS_FLOAT *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    EAS_RESULT result;
+
+    /* scratch buffer is not available in the static memory model */
+    if (pEASData->pFloatScratchBuffer == NULL)
+    {
+        *pNumGenerated = 0;
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    }
+
+    pEASData->pFloatOutputBuffer = pOut;
+    result = EAS_Render(pEASData, pEASData->pFloatScratchBuffer, numRequested, pNumGenerated);
+    pEASData->pFloatOutputBuffer = NULL;
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_GetIdle()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns whether the last rendered buffer was idle.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pIdle           - pointer to variable to receive the idle flag
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetIdle (EAS_DATA_HANDLE pEASData, EAS_BOOL *pIdle)
+{
+    *pIdle = pEASData->idle;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetVoiceStealPolicy()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Selects how a voice is chosen for stealing when all voices are in use.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  policy          - one of the EAS_STEAL_POLICY values
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetVoiceStealPolicy (EAS_DATA_HANDLE pEASData, EAS_I32 policy)
+{
+    return VMSetStealPolicy(pEASData->pVoiceMgr, policy);
+}
+
 #ifdef JET_INTERFACE
 /*----------------------------------------------------------------------------
  * EAS_SetTransposition)
@@ -1015,6 +1227,13 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
         /* if play state, advance time */
         if ((parserState >= EAS_STATE_READY) && (parserState <= EAS_STATE_PAUSING))
             pStream->time += pStream->frameLength;
+
+        /* untimed parsers get one event call per frame to apply deferred input */
+        if (pParserModule->pfEvent)
+        {
+            if ((result = (*pParserModule->pfEvent)(pEASData, pStream->handle, parseMode)) != EAS_SUCCESS)
+                return result;
+        }
         done = EAS_TRUE;
     }
 
@@ -1054,7 +1273,7 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
                 if (pParserModule->pfEvent) {
                     if ((result = (*pParserModule->pfEvent)(pEASData, pStream->handle, parseMode))
                             != EAS_SUCCESS) {
-                        ALOGE("%s() pfEvent returned %ld", __func__, result);
+                        ALOGE_RT("EAS_ParseEvents() pfEvent returned %ld", result, 0);
                         return result;
                     }
                 }
@@ -1065,9 +1284,7 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
                 // when scanning the entire file in a single call to this function.
                 // OTA files will only do infinite loops when in eParserModePlay.
                 if (++eventCount >= MAX_EVENT_COUNT && parseMode == eParserModePlay) {
-                    ALOGE("%s() aborting, %d events. Infinite loop in song file?!",
-                            __func__, eventCount);
-                    android_errorWriteLog(0x534e4554, "68664359");
+                    ALOGE_RT("EAS_ParseEvents() aborting, %ld events. Infinite loop in song file?!", eventCount, 0);
                     return EAS_ERROR_FILE_POS;
                 }
             }
@@ -1375,7 +1592,13 @@ EAS_PUBLIC EAS_RESULT EAS_Locate (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream,
         if (!parserLocate)
         {
             if (result == EAS_SUCCESS)
+            {
                 pStream->time = requestedTime << 8;
+
+                /* timed parsers have parsed up to the requested time, as below */
+                if (pParserModule->pfTime != NULL)
+                    pStream->streamFlags |= STREAM_FLAGS_PARSED;
+            }
             return result;
         }
     }
@@ -1424,6 +1647,346 @@ EAS_PUBLIC EAS_RESULT EAS_GetLocation (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStr
     return EAS_SUCCESS;
 }
 
+/* saved state header, see EAS_SaveState */
+#define EAS_STATE_MAGIC         0x53534145      /* "EASS" */
+#define EAS_STATE_VERSION       2
+
+typedef struct s_eas_state_header_tag
+{
+    EAS_U32             magic;
+    EAS_U32             version;
+    EAS_I32             size;                   /* size of the state including the header */
+    EAS_U32             checksum;               /* checksum of the state after the header */
+    EAS_I32             sampleRate;
+    EAS_U16             numVoices;              /* MAX_SYNTH_VOICES */
+    EAS_U16             numChannels;            /* NUM_SYNTH_CHANNELS */
+    EAS_U16             voiceSize;              /* sizeof(S_SYNTH_VOICE) */
+    EAS_U16             channelSize;            /* sizeof(S_SYNTH_CHANNEL) */
+    EAS_U16             engineVoiceSize;        /* sizeof(S_WT_VOICE) or zero */
+    EAS_U16             streamMask;             /* streams open */
+    EAS_U16             effectsMask;            /* effects modules present */
+    EAS_U16             reserved;
+    EAS_I32             streamStateSize[MAX_NUMBER_STREAMS];
+} S_EAS_STATE_HEADER;
+
+/*----------------------------------------------------------------------------
+ * EAS_StateChecksum()
+ *----------------------------------------------------------------------------
+ * Fletcher style checksum of the state data, cheap enough to leave the
+ * save and restore in the microsecond range
+ *----------------------------------------------------------------------------
+*/
+static EAS_U32 EAS_StateChecksum (const EAS_U8 *pData, EAS_I32 size)
+{
+    EAS_U32 sum1;
+    EAS_U32 sum2;
+
+    sum1 = sum2 = 0;
+    while (size-- > 0)
+    {
+        sum1 += *pData++;
+        sum2 += sum1;
+    }
+    return (EAS_U32) (((sum2 & 0xffff) << 16) | (sum1 & 0xffff));
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_StateLayout()
+ *----------------------------------------------------------------------------
+ * Fills in the parts of the header that describe this build and instance
+ *----------------------------------------------------------------------------
+*/
+static void EAS_StateLayout (S_EAS_DATA *pEASData, S_EAS_STATE_HEADER *pHeader)
+{
+    EAS_INT i;
+
+    EAS_HWMemSet(pHeader, 0, sizeof(S_EAS_STATE_HEADER));
+    pHeader->magic = EAS_STATE_MAGIC;
+    pHeader->version = EAS_STATE_VERSION;
+    pHeader->sampleRate = _OUTPUT_SAMPLE_RATE;
+    pHeader->numVoices = MAX_SYNTH_VOICES;
+    pHeader->numChannels = NUM_SYNTH_CHANNELS;
+    pHeader->voiceSize = sizeof(S_SYNTH_VOICE);
+    pHeader->channelSize = sizeof(S_SYNTH_CHANNEL);
+#ifdef _WT_SYNTH
+    pHeader->engineVoiceSize = sizeof(S_WT_VOICE);
+#endif
+
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+        if (pEASData->streams[i].pParserModule != NULL)
+            pHeader->streamMask |= (EAS_U16) (1 << i);
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+        if ((pEASData->effectsModules[i].effect != NULL) && (pEASData->effectsModules[i].effectData != NULL))
+            pHeader->effectsMask |= (EAS_U16) (1 << i);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SaveStreamState()
+ *----------------------------------------------------------------------------
+ * Asks the parser of a stream to save its state
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_SaveStreamState (S_EAS_DATA *pEASData, EAS_HANDLE pStream, S_EAS_STATE_BUFFER *pState)
+{
+    EAS_RESULT result;
+
+    result = EAS_GetStreamParameter(pEASData, pStream, PARSER_DATA_SAVE_STATE, (EAS_I32*) pState);
+    if (result == EAS_ERROR_INVALID_PARAMETER)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SaveStateData()
+ *----------------------------------------------------------------------------
+ * Writes everything after the header: the parsers, the voice manager,
+ * the stream times and the effects, and records the parser state sizes
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_SaveStateData (S_EAS_DATA *pEASData, S_EAS_STATE_HEADER *pHeader, S_EAS_STATE_BUFFER *pState)
+{
+    S_EAS_STREAM *pStream;
+    S_EFFECTS_MODULE *pModule;
+    EAS_RESULT result;
+    EAS_I32 pos;
+    EAS_INT i;
+
+    /* parsers first, the SMF parser checks its mode before restoring */
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if ((pHeader->streamMask & (1 << i)) == 0)
+            continue;
+        pos = pState->pos;
+        if ((result = EAS_SaveStreamState(pEASData, &pEASData->streams[i], pState)) != EAS_SUCCESS)
+            return result;
+        pHeader->streamStateSize[i] = pState->pos - pos;
+    }
+
+    if ((result = VMSaveState(pEASData->pVoiceMgr, pState)) != EAS_SUCCESS)
+        return result;
+
+    EAS_StateWrite(pState, &pEASData->renderTime, sizeof(pEASData->renderTime));
+    EAS_StateWrite(pState, &pEASData->masterGain, sizeof(pEASData->masterGain));
+    EAS_StateWrite(pState, &pEASData->masterVolume, sizeof(pEASData->masterVolume));
+    EAS_StateWrite(pState, &pEASData->idle, sizeof(pEASData->idle));
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if ((pHeader->streamMask & (1 << i)) == 0)
+            continue;
+        pStream = &pEASData->streams[i];
+        EAS_StateWrite(pState, &pStream->time, sizeof(pStream->time));
+        EAS_StateWrite(pState, &pStream->frameLength, sizeof(pStream->frameLength));
+        EAS_StateWrite(pState, &pStream->repeatCount, sizeof(pStream->repeatCount));
+        EAS_StateWrite(pState, &pStream->volume, sizeof(pStream->volume));
+        EAS_StateWrite(pState, &pStream->streamFlags, sizeof(pStream->streamFlags));
+    }
+
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if ((pHeader->effectsMask & (1 << i)) == 0)
+            continue;
+        pModule = &pEASData->effectsModules[i];
+        if (pModule->effect->pfSaveState == NULL)
+            return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+        (*pModule->effect->pfSaveState)(pModule->effectData, pState);
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SaveState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the playback state of the instance: the open streams, the
+ * channels and voices of the synthesizer and the effects.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pBuffer          - buffer for the state, NULL to get the size needed
+ * bufferSize       - size of the buffer in bytes
+ * pStateSize       - receives the size of the state in bytes
+ *
+ * Outputs:
+ * EAS_BUFFER_SIZE_MISMATCH if the buffer is too small, with the
+ * size needed in pStateSize
+ *
+ * Side Effects:
+ * The state holds no pointers; sample addresses are saved relative to
+ * their sound library. The size changes with the number of voices in
+ * use and whether the reverb tail has died away, so measure just before
+ * saving or allow for the largest state.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SaveState (EAS_DATA_HANDLE pEASData, void *pBuffer, EAS_I32 bufferSize, EAS_I32 *pStateSize)
+{
+    S_EAS_STATE_HEADER header;
+    S_EAS_STATE_BUFFER state;
+    EAS_RESULT result;
+
+#ifdef JET_INTERFACE
+    if (pEASData->jetHandle != NULL)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+
+    if (pBuffer == NULL)
+        bufferSize = 0;
+    EAS_StateLayout(pEASData, &header);
+    EAS_StateInit(&state, pBuffer, bufferSize);
+    state.pos = sizeof(S_EAS_STATE_HEADER);
+    if ((result = EAS_SaveStateData(pEASData, &header, &state)) != EAS_SUCCESS)
+        return result;
+
+    *pStateSize = state.pos;
+    if (pBuffer == NULL)
+        return EAS_SUCCESS;
+    if (state.pos > bufferSize)
+        return EAS_BUFFER_SIZE_MISMATCH;
+
+    header.size = state.pos;
+    header.checksum = EAS_StateChecksum(state.pData + sizeof(S_EAS_STATE_HEADER), state.pos - (EAS_I32) sizeof(S_EAS_STATE_HEADER));
+    EAS_HWMemCpy(pBuffer, &header, sizeof(S_EAS_STATE_HEADER));
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RestoreStateData()
+ *----------------------------------------------------------------------------
+ * Reads everything after the header in the order EAS_SaveStateData
+ * wrote it. Called twice by EAS_RestoreState, to check and to commit.
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_RestoreStateData (S_EAS_DATA *pEASData, const S_EAS_STATE_HEADER *pHeader, S_EAS_STATE_BUFFER *pState)
+{
+    S_EAS_STREAM *pStream;
+    S_EFFECTS_MODULE *pModule;
+    EAS_RESULT result;
+    EAS_INT i;
+
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if ((pHeader->streamMask & (1 << i)) == 0)
+            continue;
+        if ((result = EAS_SetStreamParameter(pEASData, &pEASData->streams[i], PARSER_DATA_RESTORE_STATE, (EAS_I32) pState)) != EAS_SUCCESS)
+            return (result == EAS_ERROR_INVALID_PARAMETER) ? EAS_ERROR_FEATURE_NOT_AVAILABLE : result;
+    }
+
+    if ((result = VMRestoreState(pEASData->pVoiceMgr, pState)) != EAS_SUCCESS)
+        return result;
+
+    EAS_StateRead(pState, &pEASData->renderTime, sizeof(pEASData->renderTime));
+    EAS_StateRead(pState, &pEASData->masterGain, sizeof(pEASData->masterGain));
+    EAS_StateRead(pState, &pEASData->masterVolume, sizeof(pEASData->masterVolume));
+    EAS_StateRead(pState, &pEASData->idle, sizeof(pEASData->idle));
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if ((pHeader->streamMask & (1 << i)) == 0)
+            continue;
+        pStream = &pEASData->streams[i];
+        EAS_StateRead(pState, &pStream->time, sizeof(pStream->time));
+        EAS_StateRead(pState, &pStream->frameLength, sizeof(pStream->frameLength));
+        EAS_StateRead(pState, &pStream->repeatCount, sizeof(pStream->repeatCount));
+        EAS_StateRead(pState, &pStream->volume, sizeof(pStream->volume));
+        EAS_StateRead(pState, &pStream->streamFlags, sizeof(pStream->streamFlags));
+    }
+
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if ((pHeader->effectsMask & (1 << i)) == 0)
+            continue;
+        pModule = &pEASData->effectsModules[i];
+        if (pModule->effect->pfRestoreState == NULL)
+            return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+        if ((result = (*pModule->effect->pfRestoreState)(pModule->effectData, pState)) != EAS_SUCCESS)
+            return result;
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_RestoreState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores a state saved by EAS_SaveState.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pBuffer          - saved state
+ * size             - size of the saved state in bytes
+ *
+ * Outputs:
+ * EAS_ERROR_INCOMPATIBLE_VERSION if the state is from another build
+ * EAS_ERROR_NOT_VALID_IN_THIS_STATE if the instance has different
+ * streams or effects open than the one that was saved
+ * EAS_ERROR_SOUND_LIBRARY if a different sound library is loaded
+ *
+ * Side Effects:
+ * The instance must have the same files opened and prepared, in the same
+ * order, and the same DLS collections loaded as the saved instance. It
+ * may be the saved instance itself or another one. The whole state is
+ * checked before anything is changed, so a state that is rejected
+ * leaves the instance as it was.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RestoreState (EAS_DATA_HANDLE pEASData, const void *pBuffer, EAS_I32 size)
+{
+    S_EAS_STATE_HEADER header;
+    S_EAS_STATE_HEADER layout;
+    S_EAS_STATE_BUFFER state;
+    EAS_RESULT result;
+    EAS_INT i;
+
+#ifdef JET_INTERFACE
+    if (pEASData->jetHandle != NULL)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+
+    /* check the header */
+    if ((pBuffer == NULL) || (size < (EAS_I32) sizeof(S_EAS_STATE_HEADER)))
+        return EAS_ERROR_DATA_INCONSISTENCY;
+    EAS_HWMemCpy(&header, pBuffer, sizeof(S_EAS_STATE_HEADER));
+    if (header.magic != EAS_STATE_MAGIC)
+        return EAS_ERROR_UNRECOGNIZED_FORMAT;
+    EAS_StateLayout(pEASData, &layout);
+    if ((header.version != layout.version) ||
+        (header.sampleRate != layout.sampleRate) ||
+        (header.numVoices != layout.numVoices) ||
+        (header.numChannels != layout.numChannels) ||
+        (header.voiceSize != layout.voiceSize) ||
+        (header.channelSize != layout.channelSize) ||
+        (header.engineVoiceSize != layout.engineVoiceSize))
+        return EAS_ERROR_INCOMPATIBLE_VERSION;
+    if ((header.size != size) ||
+        (header.checksum != EAS_StateChecksum((const EAS_U8*) pBuffer + sizeof(S_EAS_STATE_HEADER), size - (EAS_I32) sizeof(S_EAS_STATE_HEADER))))
+        return EAS_ERROR_DATA_INCONSISTENCY;
+    if ((header.streamMask != layout.streamMask) || (header.effectsMask != layout.effectsMask))
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+
+    /* the parsers measure their own state to check the streams match */
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if ((header.streamMask & (1 << i)) == 0)
+            continue;
+        EAS_StateInit(&state, NULL, 0);
+        if ((result = EAS_SaveStreamState(pEASData, &pEASData->streams[i], &state)) != EAS_SUCCESS)
+            return result;
+        if (state.pos != header.streamStateSize[i])
+            return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+    }
+
+    /* check the whole state before changing anything */
+    EAS_StateInit(&state, (void*) pBuffer, size);
+    state.pos = sizeof(S_EAS_STATE_HEADER);
+    state.check = EAS_TRUE;
+    if ((result = EAS_RestoreStateData(pEASData, &header, &state)) != EAS_SUCCESS)
+        return result;
+    if (state.pos != size)
+        return EAS_ERROR_DATA_INCONSISTENCY;
+
+    state.pos = sizeof(S_EAS_STATE_HEADER);
+    state.check = EAS_FALSE;
+    return EAS_RestoreStateData(pEASData, &header, &state);
+}
+
 #ifdef JET_INTERFACE
 /*----------------------------------------------------------------------------
  * EAS_Pause()
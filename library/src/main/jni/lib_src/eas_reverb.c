@@ -48,6 +48,11 @@ static void ReverbProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 static EAS_RESULT ReverbShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
 static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+static void ReverbSaveState (EAS_VOID_PTR pInstData, S_EAS_STATE_BUFFER *pState);
+static EAS_RESULT ReverbRestoreState (EAS_VOID_PTR pInstData, S_EAS_STATE_BUFFER *pState);
+
+/* clears the delay line and filter states */
+static void ReverbClearTail (S_REVERB_OBJECT *pReverbData);
 
 /* common effects interface for configuration module */
 const S_EFFECTS_INTERFACE EAS_Reverb =
@@ -56,7 +61,9 @@ const S_EFFECTS_INTERFACE EAS_Reverb =
     ReverbProcess,
     ReverbShutdown,
     ReverbGetParam,
-    ReverbSetParam
+    ReverbSetParam,
+    ReverbSaveState,
+    ReverbRestoreState
 };
 
 
@@ -538,9 +545,12 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
     EAS_I32 nEarlyOut;
 
     EAS_I32 tempValue;
+    EAS_I32 nLevel;
 
 
     // get the base address
+    nLevel = 0;
+
     nBase = pReverbData->m_nBaseIndex;
 
     for (i=0; i < nNumSamplesToAdd; i++)
@@ -548,7 +558,9 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         // ********** Left Allpass - start
         // left input = (left dry/4) + right feedback from previous period
         /*lint -e{702} use shift for performance */
-        nApIn = ((*pInputBuffer++)>>2) + pReverbData->m_nRevOutFbkR;
+        tempValue = *pInputBuffer++;
+        nLevel |= (tempValue < 0) ? -tempValue : tempValue;
+        nApIn = (tempValue>>2) + pReverbData->m_nRevOutFbkR;
 //      nApIn = *pInputBuffer++;    // 1xxx test and debug ap
 
         // fetch allpass delay line out
@@ -577,7 +589,9 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         // ********** Right Allpass - start
         // right input = (right dry/4) + left feedback from previous period
         /*lint -e{702} use shift for performance */
-        nApIn = ((*pInputBuffer++)>>2) + pReverbData->m_nRevOutFbkL;
+        tempValue = *pInputBuffer++;
+        nLevel |= (tempValue < 0) ? -tempValue : tempValue;
+        nApIn = (tempValue>>2) + pReverbData->m_nRevOutFbkL;
 //      nApIn = *pInputBuffer++;    // 1xxx test and debug ap
 
         // fetch allpass delay line out
@@ -713,6 +727,7 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         //scale reverb output by wet level
         /*lint -e{701} use shift for performance */
         tempValue = MULT_EG1_EG1(tempValue, (pReverbData->m_nWet<<1));
+        nLevel |= (tempValue < 0) ? -tempValue : tempValue;
         //sum with output buffer
         tempValue += *pOutputBuffer;
         *pOutputBuffer++ = (EAS_PCM)SATURATE(tempValue);
@@ -752,6 +767,7 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
         //scale reverb output by wet level
         /*lint -e{701} use shift for performance */
         tempValue = MULT_EG1_EG1(tempValue, (pReverbData->m_nWet << 1));
+        nLevel |= (tempValue < 0) ? -tempValue : tempValue;
         //sum with output buffer
         tempValue = tempValue + *pOutputBuffer;
         *pOutputBuffer++ = (EAS_PCM)SATURATE(tempValue);
@@ -769,9 +785,48 @@ static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd,
     // store the most up to date version
     pReverbData->m_nBaseIndex = nBase;
 
+    // track how long input and output have been below the idle threshold
+    if (nLevel >= REVERB_IDLE_THRESHOLD)
+        pReverbData->m_nIdleSamples = 0;
+    else if (pReverbData->m_nIdleSamples < REVERB_BUFFER_SIZE_IN_SAMPLES)
+    {
+        pReverbData->m_nIdleSamples += nNumSamplesToAdd;
+
+        // tail has died away, clear the residue so it restarts from silence
+        if (pReverbData->m_nIdleSamples >= REVERB_BUFFER_SIZE_IN_SAMPLES)
+            ReverbClearTail(pReverbData);
+    }
+
     return EAS_SUCCESS;
 }   /* end Reverb */
 
+/*----------------------------------------------------------------------------
+ * ReverbClearTail
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Clear the delay line and filter states once the tail is inaudible
+ *
+ * Inputs:
+ * pReverbData      - handle to instance data
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbClearTail (S_REVERB_OBJECT *pReverbData)
+{
+    EAS_HWMemSet(pReverbData->m_nDelayLine, 0, (EAS_I32) sizeof(pReverbData->m_nDelayLine));
+    pReverbData->m_nRevOutFbkL = 0;
+    pReverbData->m_nRevOutFbkR = 0;
+    pReverbData->m_zLpf0 = 0;
+    pReverbData->m_zLpf1 = 0;
+    pReverbData->m_sEarlyL.m_zLpf = 0;
+    pReverbData->m_sEarlyR.m_zLpf = 0;
+}   /* end ReverbClearTail */
+
 
 
 /*----------------------------------------------------------------------------
@@ -836,6 +891,11 @@ static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
         case EAS_PARAM_REVERB_DRY:
             *pValue = p->m_nDry;
             break;
+        case EAS_PARAM_REVERB_IDLE:
+            *pValue = (p->m_bBypass ||
+                (p->m_nWet == 0 && p->m_nDry == 32767) ||
+                p->m_nIdleSamples >= REVERB_BUFFER_SIZE_IN_SAMPLES);
+            break;
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -894,6 +954,173 @@ static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
     return EAS_SUCCESS;
 } /* end ReverbSetParam */
 
+/*----------------------------------------------------------------------------
+ * ReverbStateFields()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Passes each member of the reverb state that needs no checking to
+ * pfField, so the save and the restore use the same list. The members
+ * are saved one by one, the state does not depend on the layout of the
+ * reverb object. The delay offsets are masked when they are used.
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbStateFields (S_REVERB_OBJECT *p, S_EAS_STATE_BUFFER *pState, void (*pfField)(S_EAS_STATE_BUFFER *pState, void *pData, EAS_I32 size))
+{
+#define REVERB_STATE_FIELD(field) (*pfField)(pState, &p->field, (EAS_I32) sizeof(p->field))
+    REVERB_STATE_FIELD(m_nMasterVolume);
+    REVERB_STATE_FIELD(m_nUpdateCounter);
+    REVERB_STATE_FIELD(m_nMinSamplesToAdd);
+    REVERB_STATE_FIELD(m_nFlags);
+    REVERB_STATE_FIELD(m_nNumSamplesInOutputBuffer);
+    REVERB_STATE_FIELD(m_nNumSamplesInInputBuffer);
+    REVERB_STATE_FIELD(m_nNumInputSamplesRead);
+    REVERB_STATE_FIELD(m_nBaseIndex);
+    REVERB_STATE_FIELD(m_nRevOutFbkR);
+    REVERB_STATE_FIELD(m_sAp0.m_zApOut);
+    REVERB_STATE_FIELD(m_sAp0.m_nApGain);
+    REVERB_STATE_FIELD(m_sAp0.m_zApIn);
+    REVERB_STATE_FIELD(m_zD0In);
+    REVERB_STATE_FIELD(m_nRevOutFbkL);
+    REVERB_STATE_FIELD(m_sAp1.m_zApOut);
+    REVERB_STATE_FIELD(m_sAp1.m_nApGain);
+    REVERB_STATE_FIELD(m_sAp1.m_zApIn);
+    REVERB_STATE_FIELD(m_zD1In);
+    REVERB_STATE_FIELD(m_zD0Self);
+    REVERB_STATE_FIELD(m_zD1Cross);
+    REVERB_STATE_FIELD(m_zLpf0);
+    REVERB_STATE_FIELD(m_zD1Self);
+    REVERB_STATE_FIELD(m_zD0Cross);
+    REVERB_STATE_FIELD(m_zLpf1);
+    REVERB_STATE_FIELD(m_nSin);
+    REVERB_STATE_FIELD(m_nCos);
+    REVERB_STATE_FIELD(m_nSinIncrement);
+    REVERB_STATE_FIELD(m_nCosIncrement);
+    REVERB_STATE_FIELD(m_nLpfFwd);
+    REVERB_STATE_FIELD(m_nLpfFbk);
+    REVERB_STATE_FIELD(m_nXfadeInterval);
+    REVERB_STATE_FIELD(m_nXfadeCounter);
+    REVERB_STATE_FIELD(m_nPhase);
+    REVERB_STATE_FIELD(m_nPhaseIncrement);
+    REVERB_STATE_FIELD(m_nNoise);
+    REVERB_STATE_FIELD(m_nMaxExcursion);
+    REVERB_STATE_FIELD(m_bUseNoise);
+    REVERB_STATE_FIELD(m_bBypass);
+    REVERB_STATE_FIELD(m_nCurrentRoom);
+    REVERB_STATE_FIELD(m_nWet);
+    REVERB_STATE_FIELD(m_nDry);
+    REVERB_STATE_FIELD(m_nEarly);
+    REVERB_STATE_FIELD(m_nIdleSamples);
+    REVERB_STATE_FIELD(m_sEarlyL.m_zLpf);
+    REVERB_STATE_FIELD(m_sEarlyL.m_nLpfFwd);
+    REVERB_STATE_FIELD(m_sEarlyL.m_nLpfFbk);
+    REVERB_STATE_FIELD(m_sEarlyL.m_zDelay);
+    REVERB_STATE_FIELD(m_sEarlyL.m_nGain);
+    REVERB_STATE_FIELD(m_sEarlyR.m_zLpf);
+    REVERB_STATE_FIELD(m_sEarlyR.m_nLpfFwd);
+    REVERB_STATE_FIELD(m_sEarlyR.m_nLpfFbk);
+    REVERB_STATE_FIELD(m_sEarlyR.m_zDelay);
+    REVERB_STATE_FIELD(m_sEarlyR.m_nGain);
+#undef REVERB_STATE_FIELD
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbWriteField()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves one member for ReverbStateFields
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbWriteField (S_EAS_STATE_BUFFER *pState, void *pData, EAS_I32 size)
+{
+    EAS_StateWrite(pState, pData, size);
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbSaveState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the reverb state, see EAS_SaveState. The delay line is left out
+ * when it is clear, which it is whenever the reverb has been idle.
+ *
+ * Inputs:
+ * pInstData        - handle to instance data
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbSaveState (EAS_VOID_PTR pInstData, S_EAS_STATE_BUFFER *pState)
+{
+    S_REVERB_OBJECT *p;
+    EAS_BOOL8 tail;
+    EAS_INT i;
+
+    p = (S_REVERB_OBJECT*) pInstData;
+    ReverbStateFields(p, pState, ReverbWriteField);
+    EAS_StateWrite(pState, &p->m_nNextRoom, (EAS_I32) sizeof(p->m_nNextRoom));
+
+    tail = EAS_FALSE;
+    for (i = 0; i < REVERB_BUFFER_SIZE_IN_SAMPLES; i++)
+    {
+        if (p->m_nDelayLine[i] != 0)
+        {
+            tail = EAS_TRUE;
+            break;
+        }
+    }
+    EAS_StateWrite(pState, &tail, (EAS_I32) sizeof(tail));
+    if (tail)
+        EAS_StateWrite(pState, p->m_nDelayLine, (EAS_I32) sizeof(p->m_nDelayLine));
+} /* end ReverbSaveState */
+
+/*----------------------------------------------------------------------------
+ * ReverbRestoreState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the reverb state saved by ReverbSaveState
+ *
+ * Inputs:
+ * pInstData        - handle to instance data
+ * pState           - state buffer
+ *
+ * Outputs:
+ * EAS_ERROR_DATA_INCONSISTENCY if the room is not a preset
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ReverbRestoreState (EAS_VOID_PTR pInstData, S_EAS_STATE_BUFFER *pState)
+{
+    S_REVERB_OBJECT *p;
+    EAS_I16 nextRoom;
+    EAS_BOOL8 tail;
+
+    p = (S_REVERB_OBJECT*) pInstData;
+    ReverbStateFields(p, pState, EAS_StateRead);
+
+    /* the next room selects the preset */
+    EAS_StateGet(pState, &nextRoom, (EAS_I32) sizeof(nextRoom));
+    if ((nextRoom < 0) || (nextRoom >= REVERB_MAX_ROOM_TYPE))
+        return EAS_ERROR_DATA_INCONSISTENCY;
+    EAS_StateGet(pState, &tail, (EAS_I32) sizeof(tail));
+    if (!pState->check)
+    {
+        p->m_nNextRoom = nextRoom;
+        if (!tail)
+            EAS_HWMemSet(p->m_nDelayLine, 0, (EAS_I32) sizeof(p->m_nDelayLine));
+    }
+    if (tail)
+        EAS_StateRead(pState, p->m_nDelayLine, (EAS_I32) sizeof(p->m_nDelayLine));
+    return EAS_SUCCESS;
+} /* end ReverbRestoreState */
+
 
 /*----------------------------------------------------------------------------
  * ReverbUpdateRoom
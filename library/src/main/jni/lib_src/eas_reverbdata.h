@@ -171,6 +171,12 @@ EAS_I32 nPanG1 = -1.0 for cos
 #define EAS_REVERB_DRY_MAX              32767
 #define EAS_REVERB_DRY_MIN              0
 
+// the tail is idle once input and wet output stay below -60dB for a
+// whole delay line; the truncating feedback settles into a limit cycle
+// of 20-30 LSB, so the threshold sits just above it. Must be a power
+// of two, the level is tracked by OR-ing sample magnitudes together.
+#define REVERB_IDLE_THRESHOLD           32
+
 /* parameters for each allpass */
 typedef struct
 {
@@ -351,6 +357,8 @@ typedef struct
 
     EAS_I16             m_nEarly;                   // gain for early (widen) signal
 
+    EAS_I32             m_nIdleSamples;             // samples since input or output was above the idle threshold
+
     S_EARLY_REFLECTION_OBJECT   m_sEarlyL;          // left channel early reflections
     S_EARLY_REFLECTION_OBJECT   m_sEarlyR;          // right channel early reflections
 
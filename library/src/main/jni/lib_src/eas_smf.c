@@ -61,6 +61,19 @@ static EAS_RESULT SMF_ParseSysEx (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, S_
 static EAS_RESULT SMF_ParseEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, S_SMF_STREAM *pSMFStream, EAS_INT parserMode);
 static EAS_RESULT SMF_GetDeltaTime (EAS_HW_DATA_HANDLE hwInstData, S_SMF_STREAM *pSMFStream);
 static void SMF_UpdateTime (S_SMF_DATA *pSMFData, EAS_U32 ticks);
+static void SMF_CheckChaseMode (S_SMF_DATA *pSMFData, S_SMF_STREAM *pSMFStream);
+static EAS_RESULT SMF_RewindStreams (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData);
+static EAS_RESULT SMF_BuildTimeline (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData);
+static EAS_RESULT SMF_AddTimelineEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, S_SMF_TIMELINE *pTimeline, S_SMF_STREAM *pSMFStream);
+static S_SMF_EVENT *SMF_NewTimelineEvent (EAS_HW_DATA_HANDLE hwInstData, S_SMF_TIMELINE *pTimeline);
+static void *SMF_GrowBuffer (EAS_HW_DATA_HANDLE hwInstData, void *pBuffer, EAS_I32 size, EAS_I32 newSize);
+static void SMF_FreeTimeline (EAS_HW_DATA_HANDLE hwInstData, S_SMF_TIMELINE *pTimeline);
+static EAS_RESULT SMF_TimelineEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, EAS_INT parserMode);
+static EAS_RESULT SMF_InitCheckpoints (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData);
+static void SMF_FreeCheckpoints (EAS_HW_DATA_HANDLE hwInstData, S_SMF_CHECKPOINTS *pCheckpoints);
+static void SMF_RecordCheckpoint (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData);
+static EAS_RESULT SMF_SaveState (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData, S_EAS_STATE_BUFFER *pState);
+static EAS_RESULT SMF_RestoreState (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData, S_EAS_STATE_BUFFER *pState);
 
 
 /*----------------------------------------------------------------------------
@@ -86,7 +99,7 @@ const S_FILE_PARSER_INTERFACE EAS_SMF_Parser =
     NULL,
     NULL,
 #endif
-    NULL,
+    SMF_Locate,
     SMF_SetData,
     SMF_GetData,
     NULL
@@ -159,6 +172,7 @@ EAS_RESULT SMF_CheckFileType (S_EAS_DATA *pEASData, EAS_FILE_HANDLE fileHandle,
     pSMFData->fileOffset = offset;
     pSMFData->pSynth = NULL;
     pSMFData->time = 0;
+    pSMFData->checkpointInterval = SMF_CHECKPOINT_INTERVAL;
     pSMFData->state = EAS_STATE_OPEN;
     *ppHandle = pSMFData;
 
@@ -204,6 +218,20 @@ EAS_RESULT SMF_Prepare (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
     if ((result = SMF_ParseHeader(pEASData->hwInstData, pSMFData)) != EAS_SUCCESS)
         return result;
 
+    /* decode all the tracks up front if the host asked for it */
+    if ((pSMFData->flags & SMF_FLAGS_TIMELINE) && !pEASData->staticMemoryModel)
+    {
+        if ((result = SMF_BuildTimeline(pEASData, pSMFData)) != EAS_SUCCESS)
+            return result;
+    }
+
+    /* allocate the locate checkpoints */
+    if ((pSMFData->checkpointInterval > 0) && !pEASData->staticMemoryModel)
+    {
+        if ((result = SMF_InitCheckpoints(pEASData->hwInstData, pSMFData)) != EAS_SUCCESS)
+            return result;
+    }
+
     /* ready to play */
     pSMFData->state = EAS_STATE_READY;
     return EAS_SUCCESS;
@@ -293,6 +321,10 @@ EAS_RESULT SMF_Event (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_INT pars
     if (pSMFData->state >= EAS_STATE_OPEN)
         return EAS_SUCCESS;
 
+    /* walk the pre-merged timeline if there is one */
+    if (pSMFData->pTimeline != NULL)
+        return SMF_TimelineEvent(pEASData, pSMFData, parserMode);
+
     if (!pSMFData->nextStream) {
         return EAS_ERROR_FILE_FORMAT;
     }
@@ -361,6 +393,10 @@ EAS_RESULT SMF_Event (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_INT pars
 
         /* update the time of the next event */
         SMF_UpdateTime(pSMFData, pSMFData->nextStream->ticks - ticks);
+
+        /* save the state for locate */
+        if ((pSMFData->pCheckpoints != NULL) && (parserMode != eParserModeMetaData))
+            SMF_RecordCheckpoint(pEASData->hwInstData, pSMFData);
     }
     else
     {
@@ -463,6 +499,12 @@ EAS_RESULT SMF_Close (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
         if (pSMFData->streams)
             EAS_HWFree(pEASData->hwInstData, pSMFData->streams);
 
+        if (pSMFData->pTimeline)
+            SMF_FreeTimeline(pEASData->hwInstData, pSMFData->pTimeline);
+
+        if (pSMFData->pCheckpoints)
+            SMF_FreeCheckpoints(pEASData->hwInstData, pSMFData->pCheckpoints);
+
         /* free the instance data */
         EAS_HWFree(pEASData->hwInstData, pSMFData);
     }
@@ -492,7 +534,6 @@ EAS_RESULT SMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
     S_SMF_DATA* pSMFData;
     EAS_I32 i;
     EAS_RESULT result;
-    EAS_U32 ticks;
 
     pSMFData = (S_SMF_DATA*) pInstData;
 
@@ -502,14 +543,169 @@ EAS_RESULT SMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
     /* reset the synth */
     VMReset(pEASData->pVoiceMgr, pSMFData->pSynth, EAS_TRUE);
 
+    /* start from the default tempo and without chase mode, as after
+     * prepare, so that the parser times match the checkpoint times */
+    pSMFData->tickConv = (EAS_U16) (((SMF_DEFAULT_TIMEBASE * 1024) / pSMFData->ppqn + 500) / 1000);
+    pSMFData->flags &= ~(SMF_FLAGS_CHASE_MODE | SMF_FLAGS_SETUP_BAR);
+
+    /* rewind the timeline, the first event is always at time zero */
+    if (pSMFData->pTimeline != NULL)
+    {
+        pSMFData->pTimeline->event = 0;
+        pSMFData->pTimeline->sysExPos = 0;
+        pSMFData->pTimeline->timeBase = 0;
+        for (i = 0; i < pSMFData->numStreams; i++)
+            EAS_InitMIDIStream(&pSMFData->streams[i].midiStream);
+    }
+
     /* find the start of each track */
+    else if ((result = SMF_RewindStreams(pEASData->hwInstData, pSMFData)) != EAS_SUCCESS)
+        return result;
+
+    /* playing from the start again records checkpoints that are missing */
+    if (pSMFData->pCheckpoints != NULL)
+        pSMFData->pCheckpoints->recording = EAS_TRUE;
+
+    pSMFData->state = EAS_STATE_READY;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_Locate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Locates from the closest checkpoint before the requested time. Falls back
+ * to the generic locate, which parses from the start of the file, if there
+ * is no usable checkpoint.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - pointer to file handle
+ * time             - requested time in milliseconds
+ * pParserLocate    - set to EAS_TRUE if the generic locate must be used
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT SMF_Locate (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 time, EAS_BOOL *pParserLocate)
+{
+    S_SMF_DATA *pSMFData;
+    S_SMF_CHECKPOINTS *pCheckpoints;
+    S_SMF_CHECKPOINT *pCheckpoint;
+    S_SMF_STREAM_STATE *pStreamState;
+    S_SMF_STREAM *pSMFStream;
+    EAS_RESULT result;
+    EAS_I32 i;
+
+    pSMFData = (S_SMF_DATA*) pInstData;
+    pCheckpoints = pSMFData->pCheckpoints;
+    *pParserLocate = EAS_TRUE;
+
+    /* the file must have been parsed past the requested time, so that
+     * the locate cannot run into the end of the file */
+    if ((pCheckpoints == NULL) || (pCheckpoints->numCheckpoints == 0) ||
+        ((pCheckpoints->horizon >> 8) < time) ||
+        (pSMFData->flags & SMF_FLAGS_JET_STREAM) ||
+        (pSMFData->state == EAS_STATE_PAUSING) || (pSMFData->state == EAS_STATE_PAUSED))
+        return EAS_SUCCESS;
+
+    /* find the last checkpoint before the requested time */
+    pCheckpoint = NULL;
+    for (i = 0; i < pCheckpoints->numCheckpoints; i++)
+    {
+        S_SMF_CHECKPOINT *p = (S_SMF_CHECKPOINT*) (pCheckpoints->pRecords + i * pCheckpoints->recordSize);
+        if ((p->time >> 8) >= time)
+            break;
+        pCheckpoint = p;
+    }
+    if (pCheckpoint == NULL)
+        return EAS_SUCCESS;
+
+    /* restore the synth */
+    VMReset(pEASData->pVoiceMgr, pSMFData->pSynth, EAS_TRUE);
+    if (VMSetSynthState(pSMFData->pSynth, &pCheckpoint->synth) != EAS_SUCCESS)
+        return EAS_SUCCESS;
+    *pParserLocate = EAS_FALSE;
+
+    /* restore the parser */
+    pSMFData->time = pCheckpoint->time;
+    pSMFData->tickConv = pCheckpoint->tickConv;
+    pSMFData->flags = (EAS_U8) ((pSMFData->flags & ~(SMF_FLAGS_CHASE_MODE | SMF_FLAGS_SETUP_BAR)) |
+        (pCheckpoint->flags & (SMF_FLAGS_CHASE_MODE | SMF_FLAGS_SETUP_BAR)));
+    if (pSMFData->pTimeline != NULL)
+    {
+        pSMFData->pTimeline->event = pCheckpoint->event;
+        pSMFData->pTimeline->sysExPos = pCheckpoint->sysExPos;
+        pSMFData->pTimeline->timeBase = 0;
+    }
+    else
+        pSMFData->nextStream = &pSMFData->streams[pCheckpoint->nextStream];
+    pStreamState = (S_SMF_STREAM_STATE*) (pCheckpoint + 1);
+    for (i = 0; i < pSMFData->numStreams; i++, pStreamState++)
+    {
+        pSMFStream = &pSMFData->streams[i];
+        if (pSMFData->pTimeline == NULL)
+        {
+            if ((result = EAS_HWFileSeek(pEASData->hwInstData, pSMFStream->fileHandle, pStreamState->filePos)) != EAS_SUCCESS)
+                return result;
+            pSMFStream->ticks = pStreamState->ticks;
+        }
+
+        /* JET track state and coalescing belong to the live stream */
+#ifdef JET_INTERFACE
+        pStreamState->midiStream.jetData = pSMFStream->midiStream.jetData;
+#endif
+        pStreamState->midiStream.pCoalesce = pSMFStream->midiStream.pCoalesce;
+        EAS_HWMemCpy(&pSMFStream->midiStream, &pStreamState->midiStream, sizeof(S_MIDI_STREAM));
+    }
+    pSMFData->state = EAS_STATE_READY;
+    pCheckpoints->recording = EAS_TRUE;
+    pCheckpoints->locates++;
+
+    /* parse the rest of the way */
+    while ((pSMFData->state <= EAS_STATE_PLAY) && ((pSMFData->time >> 8) < time))
+    {
+        if ((result = SMF_Event(pEASData, pSMFData, eParserModeLocate)) != EAS_SUCCESS)
+            return result;
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_RewindStreams()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Positions each stream at its first event and finds the stream with the
+ * earliest event.
+ *
+ * Inputs:
+ * hwInstData       - host instance data
+ * pSMFData         - pointer to parser instance data
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_RewindStreams (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData)
+{
+    EAS_I32 i;
+    EAS_RESULT result;
+    EAS_U32 ticks;
+
     ticks = 0x7fffffffL;
     pSMFData->nextStream = NULL;
     for (i = 0; i < pSMFData->numStreams; i++)
     {
 
         /* reset file position to first byte of data in track */
-        if ((result = EAS_HWFileSeek(pEASData->hwInstData, pSMFData->streams[i].fileHandle, pSMFData->streams[i].startFilePos)) != EAS_SUCCESS)
+        if ((result = EAS_HWFileSeek(hwInstData, pSMFData->streams[i].fileHandle, pSMFData->streams[i].startFilePos)) != EAS_SUCCESS)
             return result;
 
         /* initalize some data */
@@ -517,9 +713,10 @@ EAS_RESULT SMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
 
         /* initalize the MIDI parser data */
         EAS_InitMIDIStream(&pSMFData->streams[i].midiStream);
+        pSMFData->streams[i].midiStream.flags = 0;
 
         /* parse the first delta time in each stream */
-        if ((result = SMF_GetDeltaTime(pEASData->hwInstData,&pSMFData->streams[i])) != EAS_SUCCESS)
+        if ((result = SMF_GetDeltaTime(hwInstData, &pSMFData->streams[i])) != EAS_SUCCESS)
             return result;
         if (pSMFData->streams[i].ticks < ticks)
         {
@@ -528,8 +725,6 @@ EAS_RESULT SMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
         }
     }
 
-
-    pSMFData->state = EAS_STATE_READY;
     return EAS_SUCCESS;
 }
 
@@ -630,6 +825,29 @@ EAS_RESULT SMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 pa
             EAS_HWMemCpy(&pSMFData->metadata, (void*) value, sizeof(S_METADATA_CB));
             break;
 
+        /* set the locate checkpoint interval, zero disables checkpoints */
+        case PARSER_DATA_CHECKPOINT_INTERVAL:
+            if (pSMFData->state != EAS_STATE_OPEN)
+                return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+            if ((value < 0) || (value > SMF_MAX_CHECKPOINT_INTERVAL))
+                return EAS_ERROR_PARAMETER_RANGE;
+            pSMFData->checkpointInterval = value;
+            break;
+
+        /* restore the parser state from a state buffer */
+        case PARSER_DATA_RESTORE_STATE:
+            return SMF_RestoreState(pEASData->hwInstData, pSMFData, (S_EAS_STATE_BUFFER*) value);
+
+        /* decode the file into an event timeline at prepare time */
+        case PARSER_DATA_TIMELINE:
+            if (pSMFData->state != EAS_STATE_OPEN)
+                return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+            if (value)
+                pSMFData->flags |= SMF_FLAGS_TIMELINE;
+            else
+                pSMFData->flags &= ~SMF_FLAGS_TIMELINE;
+            break;
+
 #ifdef JET_INTERFACE
         /* set jet segment and track ID of all tracks for callback function */
         case PARSER_DATA_JET_CB:
@@ -743,6 +961,17 @@ EAS_RESULT SMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 pa
             *pValue = (EAS_I32) pSMFData->pSynth;
             break;
 
+        /* return the number of locates started from a checkpoint */
+        case PARSER_DATA_CHECKPOINT_LOCATES:
+            if (pSMFData->pCheckpoints == NULL)
+                return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+            *pValue = pSMFData->pCheckpoints->locates;
+            break;
+
+        /* append the parser state to a state buffer */
+        case PARSER_DATA_SAVE_STATE:
+            return SMF_SaveState(pEASData->hwInstData, pSMFData, (S_EAS_STATE_BUFFER*) pValue);
+
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -855,15 +1084,13 @@ static EAS_RESULT SMF_ParseMetaEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData
     /* prevent a large unsigned length from being treated as a negative length */
     if ((EAS_I32) len < 0) {
         /* note that EAS_I32 is a long, which can be 64-bits on some computers */
-        ALOGE("%s() negative len = %ld", __func__, (long) len);
-        android_errorWriteLog(0x534e4554, "68953854");
+        ALOGE_RT("SMF_ParseMetaEvent() negative len = %ld", len, 0);
         return EAS_ERROR_FILE_FORMAT;
     }
     /* prevent numeric overflow caused by a very large len, assume pos > 0 */
     const EAS_I32 EAS_I32_MAX = 0x7FFFFFFF;
     if ((EAS_I32) len > (EAS_I32_MAX - pos)) {
-        ALOGE("%s() too large len = %ld", __func__, (long) len);
-        android_errorWriteLog(0x534e4554, "68953854");
+        ALOGE_RT("SMF_ParseMetaEvent() too large len = %ld", len, 0);
         return EAS_ERROR_FILE_FORMAT;
     }
 
@@ -1056,6 +1283,29 @@ static EAS_RESULT SMF_ParseEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, S_
     }
 
     /* chase mode logic */
+    SMF_CheckChaseMode(pSMFData, pSMFStream);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_CheckChaseMode()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Enters chase mode when a setup bar has been parsed at time zero and
+ * leaves it at the first note, so playback skips the silent lead in.
+ *
+ * Inputs:
+ *
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void SMF_CheckChaseMode (S_SMF_DATA *pSMFData, S_SMF_STREAM *pSMFStream)
+{
     if (pSMFData->time == 0)
     {
         if (pSMFData->flags & SMF_FLAGS_CHASE_MODE)
@@ -1066,8 +1316,6 @@ static EAS_RESULT SMF_ParseEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, S_
         else if ((pSMFData->flags & SMF_FLAGS_SETUP_BAR) == SMF_FLAGS_SETUP_BAR)
             pSMFData->flags = (pSMFData->flags & ~SMF_FLAGS_SETUP_BAR) | SMF_FLAGS_CHASE_MODE;
     }
-
-    return EAS_SUCCESS;
 }
 
 /*----------------------------------------------------------------------------
@@ -1264,3 +1512,772 @@ static void SMF_UpdateTime (S_SMF_DATA *pSMFData, EAS_U32 ticks)
     pSMFData->time += (EAS_I32)((temp1 << 8) + (temp2 >> 2));
 }
 
+
+/*----------------------------------------------------------------------------
+ * SMF_BuildTimeline()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Decodes all the tracks into a single time sorted event array. The
+ * streams are merged in the same order SMF_Event plays them and the
+ * event times follow the tempo map, so playback only has to walk the
+ * array. Files the byte parser would treat specially (system common
+ * messages, SysEx continuation packets, broken running status) are
+ * left to the file parser, as are files with a metadata callback.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pSMFData         - pointer to parser instance data
+ *
+ * Outputs:
+ * returns an error only if the streams could not be rewound
+ *
+ * Side Effects:
+ * pSMFData->pTimeline is set if the timeline was built
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_BuildTimeline (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData)
+{
+    S_SMF_TIMELINE *pTimeline;
+    S_SMF_STREAM *pSMFStream;
+    S_SMF_EVENT *pEvent;
+    EAS_RESULT result;
+    EAS_I32 startTime;
+    EAS_I32 i;
+    EAS_U32 ticks;
+    EAS_U32 temp;
+    EAS_U16 tickConv;
+    EAS_U8 flags;
+    EAS_BOOL chase;
+
+    /* metadata is only reported by the file parser */
+    if ((pSMFData->metadata.callback != NULL) || (pSMFData->numStreams > 256))
+        return EAS_SUCCESS;
+
+    pTimeline = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_SMF_TIMELINE));
+    if (pTimeline == NULL)
+        return EAS_SUCCESS;
+    EAS_HWMemSet(pTimeline, 0, sizeof(S_SMF_TIMELINE));
+
+    /* save the state left by the header parser */
+    startTime = pSMFData->time;
+    tickConv = pSMFData->tickConv;
+    flags = pSMFData->flags;
+    chase = EAS_FALSE;
+
+    /* event times start at zero, as they do after a reset */
+    pSMFData->time = 0;
+    result = EAS_SUCCESS;
+    while (pSMFData->nextStream)
+    {
+        pSMFStream = pSMFData->nextStream;
+        ticks = pSMFStream->ticks;
+
+        /* decode the next event, same control flow as SMF_Event */
+        result = SMF_AddTimelineEvent(pEASData, pSMFData, pTimeline, pSMFStream);
+        if (result == EAS_SUCCESS)
+        {
+            SMF_CheckChaseMode(pSMFData, pSMFStream);
+            if (pSMFData->flags & SMF_FLAGS_CHASE_MODE)
+                chase = EAS_TRUE;
+
+            if (pSMFStream->ticks != SMF_END_OF_TRACK)
+            {
+                if ((result = SMF_GetDeltaTime(pEASData->hwInstData, pSMFStream)) == EAS_EOF)
+                    pSMFStream->ticks = SMF_END_OF_TRACK;
+                else if (result != EAS_SUCCESS)
+                    break;
+                else if (pSMFStream->ticks == ticks)
+                    continue;
+            }
+        }
+        else if (result == EAS_EOF)
+            pSMFStream->ticks = SMF_END_OF_TRACK;
+        else
+            break;
+
+        /* find next event in all streams */
+        temp = 0x7ffffff;
+        pSMFData->nextStream = NULL;
+        for (i = 0; i < pSMFData->numStreams; i++)
+        {
+            if (pSMFData->streams[i].ticks < temp)
+            {
+                temp = pSMFData->streams[i].ticks;
+                pSMFData->nextStream = &pSMFData->streams[i];
+            }
+        }
+
+        if (pSMFData->nextStream)
+            SMF_UpdateTime(pSMFData, pSMFData->nextStream->ticks - ticks);
+    }
+
+    /* the first play only chases if the file starts at time zero */
+    if ((pSMFData->nextStream == NULL) && (!chase || (startTime == 0)))
+    {
+        /* end marker carries the time of the last event */
+        if ((pEvent = SMF_NewTimelineEvent(pEASData->hwInstData, pTimeline)) != NULL)
+        {
+            EAS_HWMemSet(pEvent, 0, sizeof(S_SMF_EVENT));
+            pEvent->time = pSMFData->time;
+            pTimeline->timeBase = startTime;
+            pSMFData->pTimeline = pTimeline;
+        }
+    }
+
+    /* restore the parser state for the first play */
+    pSMFData->time = startTime;
+    pSMFData->tickConv = tickConv;
+    pSMFData->flags = flags;
+    result = SMF_RewindStreams(pEASData->hwInstData, pSMFData);
+
+    /* fall back to parsing the file */
+    if (pSMFData->pTimeline != pTimeline)
+        SMF_FreeTimeline(pEASData->hwInstData, pTimeline);
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_AddTimelineEvent()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the next event from a stream and appends it to the timeline.
+ * Meta-events update the tempo and end of track and are not stored.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pSMFData         - pointer to parser instance data
+ * pTimeline        - timeline being built
+ * pSMFStream       - stream to read from
+ *
+ * Outputs:
+ * returns EAS_EOF at the end of the track, EAS_ERROR_FILE_FORMAT if the
+ * event has to be left to the file parser
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_AddTimelineEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, S_SMF_TIMELINE *pTimeline, S_SMF_STREAM *pSMFStream)
+{
+    S_SMF_EVENT *pEvent;
+    EAS_RESULT result;
+    EAS_U8 *pData;
+    EAS_U32 len;
+    EAS_U32 i;
+    EAS_I32 size;
+    EAS_U8 status;
+    EAS_U8 d1;
+    EAS_U8 d2;
+
+    /* get the event type */
+    if ((result = EAS_HWGetByte(pEASData->hwInstData, pSMFStream->fileHandle, &status)) != EAS_SUCCESS)
+        return result;
+
+    /* meta-events only change the timing */
+    if (status == 0xff)
+        return SMF_ParseMetaEvent(pEASData, pSMFData, pSMFStream);
+
+    /* SysEx, stored as length and data */
+    if (status == 0xf0)
+    {
+        if ((result = SMF_GetVarLenData(pEASData->hwInstData, pSMFStream->fileHandle, &len)) != EAS_SUCCESS)
+            return result;
+        if (len > SMF_TIMELINE_MAX_SYSEX)
+            return EAS_ERROR_FILE_FORMAT;
+
+        /* make room for the message */
+        size = (EAS_I32) len + 4;
+        if (pTimeline->sysExSize + size > pTimeline->maxSysEx)
+        {
+            i = pTimeline->maxSysEx ? (EAS_U32) pTimeline->maxSysEx : SMF_TIMELINE_MIN_SYSEX;
+            while ((EAS_I32) i < pTimeline->sysExSize + size)
+                i *= 2;
+            if ((pData = SMF_GrowBuffer(pEASData->hwInstData, pTimeline->pSysEx, pTimeline->sysExSize, (EAS_I32) i)) == NULL)
+                return EAS_ERROR_MALLOC_FAILED;
+            pTimeline->pSysEx = pData;
+            pTimeline->maxSysEx = (EAS_I32) i;
+        }
+        pData = pTimeline->pSysEx + pTimeline->sysExSize;
+        pData[0] = (EAS_U8) (len >> 24);
+        pData[1] = (EAS_U8) (len >> 16);
+        pData[2] = (EAS_U8) (len >> 8);
+        pData[3] = (EAS_U8) len;
+        pData += 4;
+
+        /* only a final EOX is allowed among the data bytes */
+        for (i = 0; i < len; i++)
+        {
+            if (EAS_HWGetByte(pEASData->hwInstData, pSMFStream->fileHandle, &pData[i]) != EAS_SUCCESS)
+                return EAS_ERROR_FILE_FORMAT;
+            if ((pData[i] & 0x80) && ((pData[i] != 0xf7) || (i != len - 1)))
+                return EAS_ERROR_FILE_FORMAT;
+        }
+
+        /* track GM System On for chase mode, as the SysEx parser does */
+        if ((len >= 4) && (pData[0] == 0x7e) && (pData[1] == 0x7f) && (pData[2] == 0x09) && ((pData[3] == 1) || (pData[3] == 3)))
+            pSMFStream->midiStream.flags |= MIDI_FLAG_GM_ON;
+        if (len && (pSMFStream->midiStream.flags & MIDI_FLAG_GM_ON))
+            pSMFData->flags |= SMF_FLAGS_HAS_GM_ON;
+        pSMFStream->midiStream.runningStatus = (len && (pData[len - 1] == 0xf7)) ? 0xf7 : 0xf0;
+
+        if ((pEvent = SMF_NewTimelineEvent(pEASData->hwInstData, pTimeline)) == NULL)
+            return EAS_ERROR_MALLOC_FAILED;
+        pTimeline->sysExSize += size;
+        pEvent->time = pSMFData->time;
+        pEvent->event.status = 0xf0;
+        pEvent->event.data1 = 0;
+        pEvent->event.data2 = 0;
+        pEvent->stream = (EAS_U8) (pSMFStream - pSMFData->streams);
+        return EAS_SUCCESS;
+    }
+
+    /* new status byte or running status, channel messages only */
+    if (status & 0x80)
+    {
+        if (status >= 0xf0)
+            return EAS_ERROR_FILE_FORMAT;
+        pSMFStream->midiStream.runningStatus = status;
+        if ((result = EAS_HWGetByte(pEASData->hwInstData, pSMFStream->fileHandle, &d1)) != EAS_SUCCESS)
+            return result;
+    }
+    else
+    {
+        d1 = status;
+        status = pSMFStream->midiStream.runningStatus;
+        if ((status < 0x80) || (status >= 0xf0))
+            return EAS_ERROR_FILE_FORMAT;
+    }
+
+    /* program change and channel pressure have one data byte */
+    d2 = 0;
+    if ((status & 0xe0) != 0xc0)
+    {
+        if ((result = EAS_HWGetByte(pEASData->hwInstData, pSMFStream->fileHandle, &d2)) != EAS_SUCCESS)
+            return result;
+    }
+    if ((d1 | d2) & 0x80)
+        return EAS_ERROR_FILE_FORMAT;
+
+    if ((pEvent = SMF_NewTimelineEvent(pEASData->hwInstData, pTimeline)) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    pEvent->time = pSMFData->time;
+    pEvent->event.status = status;
+    pEvent->event.data1 = d1;
+    pEvent->event.data2 = d2;
+    pEvent->stream = (EAS_U8) (pSMFStream - pSMFData->streams);
+
+    /* track the first note for chase mode */
+    if (((status & 0xf0) == 0x90) && d2)
+        pSMFStream->midiStream.flags |= MIDI_FLAG_FIRST_NOTE;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_NewTimelineEvent()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Appends an entry to the timeline, doubling the array when it is full
+ *
+ * Inputs:
+ *
+ *
+ * Outputs:
+ * returns a pointer to the new entry, NULL if out of memory
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static S_SMF_EVENT *SMF_NewTimelineEvent (EAS_HW_DATA_HANDLE hwInstData, S_SMF_TIMELINE *pTimeline)
+{
+    S_SMF_EVENT *pEvents;
+    EAS_I32 maxEvents;
+
+    if (pTimeline->numEvents == pTimeline->maxEvents)
+    {
+        maxEvents = pTimeline->maxEvents ? pTimeline->maxEvents * 2 : SMF_TIMELINE_MIN_EVENTS;
+        pEvents = SMF_GrowBuffer(hwInstData, pTimeline->pEvents,
+            pTimeline->numEvents * (EAS_I32) sizeof(S_SMF_EVENT), maxEvents * (EAS_I32) sizeof(S_SMF_EVENT));
+        if (pEvents == NULL)
+            return NULL;
+        pTimeline->pEvents = pEvents;
+        pTimeline->maxEvents = maxEvents;
+    }
+    return &pTimeline->pEvents[pTimeline->numEvents++];
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_GrowBuffer()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Moves a buffer to a larger allocation. The old buffer is left alone if
+ * the allocation fails.
+ *
+ * Inputs:
+ *
+ *
+ * Outputs:
+ * returns the new buffer, NULL if out of memory
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void *SMF_GrowBuffer (EAS_HW_DATA_HANDLE hwInstData, void *pBuffer, EAS_I32 size, EAS_I32 newSize)
+{
+    void *pNew;
+
+    if ((pNew = EAS_HWMalloc(hwInstData, newSize)) == NULL)
+        return NULL;
+    if (pBuffer != NULL)
+    {
+        EAS_HWMemCpy(pNew, pBuffer, size);
+        EAS_HWFree(hwInstData, pBuffer);
+    }
+    return pNew;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_FreeTimeline()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees the timeline and its buffers
+ *
+ * Inputs:
+ *
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void SMF_FreeTimeline (EAS_HW_DATA_HANDLE hwInstData, S_SMF_TIMELINE *pTimeline)
+{
+    if (pTimeline->pEvents != NULL)
+        EAS_HWFree(hwInstData, pTimeline->pEvents);
+    if (pTimeline->pSysEx != NULL)
+        EAS_HWFree(hwInstData, pTimeline->pSysEx);
+    EAS_HWFree(hwInstData, pTimeline);
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_TimelineEvent()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Plays the next event from the timeline. Channel messages skip the byte
+ * parser, SysEx messages are fed to it as they would be from the file.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pSMFData         - pointer to parser instance data
+ * parserMode       - play, locate, mute or metadata
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_TimelineEvent (S_EAS_DATA *pEASData, S_SMF_DATA *pSMFData, EAS_INT parserMode)
+{
+    S_SMF_TIMELINE *pTimeline;
+    S_SMF_STREAM *pSMFStream;
+    S_SMF_EVENT *pEvent;
+    EAS_RESULT result;
+    EAS_U8 *pData;
+    EAS_I32 len;
+
+    pTimeline = pSMFData->pTimeline;
+    pEvent = &pTimeline->pEvents[pTimeline->event];
+
+    /* end of the timeline */
+    if (pEvent->event.status == 0)
+    {
+        pSMFData->state = EAS_STATE_STOPPING;
+        VMReleaseAllVoices(pEASData->pVoiceMgr, pSMFData->pSynth);
+        return EAS_SUCCESS;
+    }
+    pSMFStream = &pSMFData->streams[pEvent->stream];
+
+    /* assume that an error occurred */
+    pSMFData->state = EAS_STATE_ERROR;
+
+#ifdef JET_INTERFACE
+    /* if JET has track muted, set parser mode to mute */
+    if (pSMFStream->midiStream.jetData & MIDI_FLAGS_JET_MUTE)
+        parserMode = eParserModeMute;
+#endif
+
+    /* SysEx goes through the byte parser */
+    if (pEvent->event.status == 0xf0)
+    {
+        pData = pTimeline->pSysEx + pTimeline->sysExPos;
+        len = ((EAS_I32) pData[0] << 24) | ((EAS_I32) pData[1] << 16) | ((EAS_I32) pData[2] << 8) | pData[3];
+        pTimeline->sysExPos += len + 4;
+        if (parserMode != eParserModeMetaData)
+        {
+            if ((result = EAS_ParseMIDIStream(pEASData, pSMFData->pSynth, &pSMFStream->midiStream, 0xf0, parserMode)) != EAS_SUCCESS)
+                return result;
+            for (pData += 4; len > 0; len--)
+            {
+                if ((result = EAS_ParseMIDIStream(pEASData, pSMFData->pSynth, &pSMFStream->midiStream, *pData++, parserMode)) != EAS_SUCCESS)
+                    return result;
+            }
+        }
+    }
+
+    /* channel messages are dispatched directly */
+    else if (parserMode != eParserModeMetaData)
+    {
+        if ((result = EAS_ParseMIDIEvents(pEASData, pSMFData->pSynth, &pSMFStream->midiStream, &pEvent->event, 1, parserMode)) != EAS_SUCCESS)
+            return result;
+    }
+
+    /* update the time of the next event */
+    pTimeline->event++;
+    pSMFData->time = pTimeline->timeBase + pTimeline->pEvents[pTimeline->event].time;
+    pSMFData->state = EAS_STATE_PLAY;
+
+    /* save the state for locate */
+    if ((pSMFData->pCheckpoints != NULL) && (parserMode != eParserModeMetaData) && (pTimeline->pEvents[pTimeline->event].event.status != 0))
+        SMF_RecordCheckpoint(pEASData->hwInstData, pSMFData);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_InitCheckpoints()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Allocates the locate checkpoints. All the memory is allocated here so
+ * that recording does not allocate during playback.
+ *
+ * Inputs:
+ * hwInstData       - host instance data
+ * pSMFData         - pointer to parser instance data
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_InitCheckpoints (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData)
+{
+    S_SMF_CHECKPOINTS *pCheckpoints;
+    EAS_I32 recordSize;
+
+    pCheckpoints = EAS_HWMalloc(hwInstData, sizeof(S_SMF_CHECKPOINTS));
+    if (pCheckpoints == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWMemSet(pCheckpoints, 0, sizeof(S_SMF_CHECKPOINTS));
+
+    recordSize = (EAS_I32) (sizeof(S_SMF_CHECKPOINT) + pSMFData->numStreams * sizeof(S_SMF_STREAM_STATE));
+    pCheckpoints->pRecords = EAS_HWMalloc(hwInstData, SMF_MAX_CHECKPOINTS * recordSize);
+    if (pCheckpoints->pRecords == NULL)
+    {
+        EAS_HWFree(hwInstData, pCheckpoints);
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+    pCheckpoints->recordSize = recordSize;
+    pCheckpoints->interval = pSMFData->checkpointInterval << 8;
+    pCheckpoints->nextTime = pCheckpoints->interval;
+
+    /* the first play starts at the first event instead of at time zero,
+     * checkpoints are only recorded when the two agree */
+    pCheckpoints->recording = (pSMFData->time == 0);
+    pSMFData->pCheckpoints = pCheckpoints;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_FreeCheckpoints()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees the locate checkpoints
+ *
+ * Inputs:
+ * hwInstData       - host instance data
+ * pCheckpoints     - pointer to checkpoints
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void SMF_FreeCheckpoints (EAS_HW_DATA_HANDLE hwInstData, S_SMF_CHECKPOINTS *pCheckpoints)
+{
+    if (pCheckpoints->pRecords != NULL)
+        EAS_HWFree(hwInstData, pCheckpoints->pRecords);
+    EAS_HWFree(hwInstData, pCheckpoints);
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_RecordCheckpoint()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Called after each event with the parser positioned at the next event.
+ * Saves the parser and synth state once the checkpoint interval has passed.
+ * When the table is full every other checkpoint is dropped and the
+ * interval is doubled.
+ *
+ * Inputs:
+ * hwInstData       - host instance data
+ * pSMFData         - pointer to parser instance data
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void SMF_RecordCheckpoint (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData)
+{
+    S_SMF_CHECKPOINTS *pCheckpoints;
+    S_SMF_CHECKPOINT *pCheckpoint;
+    S_SMF_STREAM_STATE *pStreamState;
+    EAS_I32 i;
+
+    pCheckpoints = pSMFData->pCheckpoints;
+    if (!pCheckpoints->recording || (pSMFData->flags & (SMF_FLAGS_CHASE_MODE | SMF_FLAGS_JET_STREAM)))
+        return;
+    if (pSMFData->time > pCheckpoints->horizon)
+        pCheckpoints->horizon = pSMFData->time;
+    if (pSMFData->time < pCheckpoints->nextTime)
+        return;
+
+    /* make room */
+    if (pCheckpoints->numCheckpoints == SMF_MAX_CHECKPOINTS)
+    {
+        for (i = 1; i < SMF_MAX_CHECKPOINTS; i += 2)
+            EAS_HWMemCpy(pCheckpoints->pRecords + (i >> 1) * pCheckpoints->recordSize,
+                pCheckpoints->pRecords + i * pCheckpoints->recordSize, pCheckpoints->recordSize);
+        pCheckpoints->numCheckpoints = SMF_MAX_CHECKPOINTS / 2;
+        if (pCheckpoints->interval < (SMF_MAX_CHECKPOINT_INTERVAL << 8))
+            pCheckpoints->interval <<= 1;
+    }
+
+    /* a deferred reset or SP-MIDI cannot be saved, try again on the next event */
+    pCheckpoint = (S_SMF_CHECKPOINT*) (pCheckpoints->pRecords + pCheckpoints->numCheckpoints * pCheckpoints->recordSize);
+    if (VMGetSynthState(pSMFData->pSynth, &pCheckpoint->synth) != EAS_SUCCESS)
+        return;
+
+    pCheckpoint->time = pSMFData->time;
+    pCheckpoint->tickConv = pSMFData->tickConv;
+    pCheckpoint->flags = pSMFData->flags;
+    if (pSMFData->pTimeline != NULL)
+    {
+        pCheckpoint->event = pSMFData->pTimeline->event;
+        pCheckpoint->sysExPos = pSMFData->pTimeline->sysExPos;
+    }
+    else
+        pCheckpoint->nextStream = (EAS_U16) (pSMFData->nextStream - pSMFData->streams);
+    pStreamState = (S_SMF_STREAM_STATE*) (pCheckpoint + 1);
+    for (i = 0; i < pSMFData->numStreams; i++, pStreamState++)
+    {
+        if (pSMFData->pTimeline == NULL)
+        {
+            if (EAS_HWFilePos(hwInstData, pSMFData->streams[i].fileHandle, &pStreamState->filePos) != EAS_SUCCESS)
+                return;
+            pStreamState->ticks = pSMFData->streams[i].ticks;
+        }
+        EAS_HWMemCpy(&pStreamState->midiStream, &pSMFData->streams[i].midiStream, sizeof(S_MIDI_STREAM));
+    }
+
+    pCheckpoints->numCheckpoints++;
+    pCheckpoints->nextTime = pSMFData->time + pCheckpoints->interval;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_SaveState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the parser state, see EAS_SaveState. The file is saved as the
+ * position of each track, or the position in the timeline if there is one.
+ *
+ * Inputs:
+ * hwInstData       - host instance data
+ * pSMFData         - pointer to parser instance data
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_SaveState (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData, S_EAS_STATE_BUFFER *pState)
+{
+    S_SMF_STREAM *pSMFStream;
+    EAS_RESULT result;
+    EAS_I32 filePos;
+    EAS_I32 i;
+    EAS_BOOL8 timeline;
+    EAS_BOOL8 recording;
+
+    /* JET keeps its own track and segment state */
+    if (pSMFData->flags & SMF_FLAGS_JET_STREAM)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+
+    timeline = (pSMFData->pTimeline != NULL);
+    recording = (pSMFData->pCheckpoints != NULL) && pSMFData->pCheckpoints->recording;
+    EAS_StateWrite(pState, &timeline, (EAS_I32) sizeof(timeline));
+    EAS_StateWrite(pState, &pSMFData->time, (EAS_I32) sizeof(pSMFData->time));
+    EAS_StateWrite(pState, &pSMFData->tickConv, (EAS_I32) sizeof(pSMFData->tickConv));
+    EAS_StateWrite(pState, &pSMFData->state, (EAS_I32) sizeof(pSMFData->state));
+    EAS_StateWrite(pState, &pSMFData->flags, (EAS_I32) sizeof(pSMFData->flags));
+    EAS_StateWrite(pState, &recording, (EAS_I32) sizeof(recording));
+
+    if (timeline)
+    {
+        EAS_StateWrite(pState, &pSMFData->pTimeline->event, (EAS_I32) sizeof(pSMFData->pTimeline->event));
+        EAS_StateWrite(pState, &pSMFData->pTimeline->sysExPos, (EAS_I32) sizeof(pSMFData->pTimeline->sysExPos));
+        EAS_StateWrite(pState, &pSMFData->pTimeline->timeBase, (EAS_I32) sizeof(pSMFData->pTimeline->timeBase));
+    }
+    else
+    {
+        i = (pSMFData->nextStream != NULL) ? (EAS_I32) (pSMFData->nextStream - pSMFData->streams) : -1;
+        EAS_StateWrite(pState, &i, (EAS_I32) sizeof(i));
+    }
+
+    for (i = 0; i < pSMFData->numStreams; i++)
+    {
+        pSMFStream = &pSMFData->streams[i];
+        if (!timeline)
+        {
+            if ((result = EAS_HWFilePos(hwInstData, pSMFStream->fileHandle, &filePos)) != EAS_SUCCESS)
+                return result;
+            EAS_StateWrite(pState, &filePos, (EAS_I32) sizeof(filePos));
+            EAS_StateWrite(pState, &pSMFStream->ticks, (EAS_I32) sizeof(pSMFStream->ticks));
+        }
+        EAS_SaveMIDIStream(&pSMFStream->midiStream, pState);
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * SMF_RestoreState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the parser state saved by SMF_SaveState. The parser must have
+ * the same file open and prepared the same way.
+ *
+ * Inputs:
+ * hwInstData       - host instance data
+ * pSMFData         - pointer to parser instance data
+ * pState           - state buffer
+ *
+ * Outputs:
+ * EAS_ERROR_DATA_INCONSISTENCY if the state, a position or the file mode
+ * does not fit the parser
+ *
+ * Side Effects:
+ * Every value is checked before any is stored, so the parser is left
+ * as it was when the state is rejected. The files are only moved when
+ * the state is committed, see EAS_StateGet.
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT SMF_RestoreState (EAS_HW_DATA_HANDLE hwInstData, S_SMF_DATA *pSMFData, S_EAS_STATE_BUFFER *pState)
+{
+    S_SMF_STREAM *pSMFStream;
+    EAS_RESULT result;
+    EAS_I32 time;
+    EAS_I32 event;
+    EAS_I32 sysExPos;
+    EAS_I32 timeBase;
+    EAS_I32 filePos;
+    EAS_I32 fileSize;
+    EAS_I32 i;
+    EAS_I32 next;
+    EAS_U32 ticks;
+    EAS_U16 tickConv;
+    EAS_BOOL8 timeline;
+    EAS_BOOL8 recording;
+    EAS_U8 state;
+    EAS_U8 flags;
+
+    if (pSMFData->flags & SMF_FLAGS_JET_STREAM)
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+
+    /* a timeline and track positions cannot be converted */
+    EAS_StateGet(pState, &timeline, (EAS_I32) sizeof(timeline));
+    if (timeline != (pSMFData->pTimeline != NULL))
+        return EAS_ERROR_DATA_INCONSISTENCY;
+
+    EAS_StateGet(pState, &time, (EAS_I32) sizeof(time));
+    EAS_StateGet(pState, &tickConv, (EAS_I32) sizeof(tickConv));
+    EAS_StateGet(pState, &state, (EAS_I32) sizeof(state));
+    EAS_StateGet(pState, &flags, (EAS_I32) sizeof(flags));
+    EAS_StateGet(pState, &recording, (EAS_I32) sizeof(recording));
+    if (state > EAS_STATE_EMPTY)
+        return EAS_ERROR_DATA_INCONSISTENCY;
+
+    event = sysExPos = timeBase = next = 0;
+    if (timeline)
+    {
+        EAS_StateGet(pState, &event, (EAS_I32) sizeof(event));
+        EAS_StateGet(pState, &sysExPos, (EAS_I32) sizeof(sysExPos));
+        EAS_StateGet(pState, &timeBase, (EAS_I32) sizeof(timeBase));
+        if ((event < 0) || (event >= pSMFData->pTimeline->numEvents) ||
+            (sysExPos < 0) || (sysExPos > pSMFData->pTimeline->sysExSize))
+            return EAS_ERROR_DATA_INCONSISTENCY;
+    }
+    else
+    {
+        EAS_StateGet(pState, &next, (EAS_I32) sizeof(next));
+        if ((next < -1) || (next >= pSMFData->numStreams))
+            return EAS_ERROR_DATA_INCONSISTENCY;
+    }
+
+    if (!pState->check)
+    {
+        pSMFData->time = time;
+        pSMFData->tickConv = tickConv;
+        pSMFData->state = state;
+        pSMFData->flags = (EAS_U8) ((pSMFData->flags & ~(SMF_FLAGS_CHASE_MODE | SMF_FLAGS_SETUP_BAR)) |
+            (flags & (SMF_FLAGS_CHASE_MODE | SMF_FLAGS_SETUP_BAR)));
+        if (pSMFData->pCheckpoints != NULL)
+            pSMFData->pCheckpoints->recording = recording;
+        if (timeline)
+        {
+            pSMFData->pTimeline->event = event;
+            pSMFData->pTimeline->sysExPos = sysExPos;
+            pSMFData->pTimeline->timeBase = timeBase;
+        }
+        else
+            pSMFData->nextStream = (next >= 0) ? &pSMFData->streams[next] : NULL;
+    }
+
+    for (i = 0; i < pSMFData->numStreams; i++)
+    {
+        pSMFStream = &pSMFData->streams[i];
+        if (!timeline)
+        {
+            EAS_StateGet(pState, &filePos, (EAS_I32) sizeof(filePos));
+            EAS_StateGet(pState, &ticks, (EAS_I32) sizeof(ticks));
+            if (pState->check)
+            {
+                if ((result = EAS_HWFileLength(hwInstData, pSMFStream->fileHandle, &fileSize)) != EAS_SUCCESS)
+                    return result;
+                if ((filePos < 0) || (filePos > fileSize))
+                    return EAS_ERROR_DATA_INCONSISTENCY;
+            }
+            else
+            {
+                if ((result = EAS_HWFileSeek(hwInstData, pSMFStream->fileHandle, filePos)) != EAS_SUCCESS)
+                    return result;
+                pSMFStream->ticks = ticks;
+            }
+        }
+        EAS_RestoreMIDIStream(&pSMFStream->midiStream, pState);
+    }
+    return EAS_SUCCESS;
+}
@@ -61,6 +61,9 @@ S_SMF_DATA eas_SMFData =
     0,                  /* current MIDI tick to msec conversion */
     0,                  /* ticks per quarter note */
     0,                  /* current state EAS_STATE_XXXX */
-    0                   /* flags */
+    0,                  /* flags */
+    0,                  /* pre-merged event timeline */
+    0,                  /* locate checkpoints */
+    0                   /* checkpoint interval */
 };
 
@@ -62,5 +62,16 @@
 /* value for pSMFStream->ticks to signify end of track */
 #define SMF_END_OF_TRACK            0xffffffff
 
+/* event timeline allocation, buffers double as needed */
+#define SMF_TIMELINE_MIN_EVENTS     256
+#define SMF_TIMELINE_MIN_SYSEX      256
+#define SMF_TIMELINE_MAX_SYSEX      0x100000
+
+/* locate checkpoints are off unless EAS_SetCheckpointInterval sets an
+ * interval, which doubles when the table is full */
+#define SMF_CHECKPOINT_INTERVAL     0
+#define SMF_MAX_CHECKPOINTS         32
+#define SMF_MAX_CHECKPOINT_INTERVAL 0x3fffffL
+
 #endif
 
@@ -341,6 +341,7 @@ typedef struct s_bank_tag
  * numDLSRegions        number of DLS regions
  * numDLSArticulations  number of DLS articulations
  * numDLSSamples        number of DLS samples
+ * checksum             hash of the converted data, identifies the collection
  *----------------------------------------------------------------------------
 */
 typedef struct s_eas_dls_tag
@@ -356,6 +357,7 @@ typedef struct s_eas_dls_tag
     EAS_U16             numDLSArticulations;
     EAS_U16             numDLSSamples;
     EAS_U8              refCount;
+    EAS_U32             checksum;
 } S_DLS;
 #endif
 
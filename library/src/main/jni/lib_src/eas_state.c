@@ -0,0 +1,76 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_state.c
+ *
+ * Contents and purpose:
+ * Buffer used by the modules to save and restore their part of the
+ * synthesizer state, see EAS_SaveState and EAS_RestoreState.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include "eas_state.h"
+#include "eas_host.h"
+
+/*----------------------------------------------------------------------------
+ * EAS_StateInit()
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateInit (S_EAS_STATE_BUFFER *pState, void *pData, EAS_I32 size)
+{
+    pState->pData = (EAS_U8*) pData;
+    pState->size = size;
+    pState->pos = 0;
+    pState->check = EAS_FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_StateWrite()
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateWrite (S_EAS_STATE_BUFFER *pState, const void *pSrc, EAS_I32 size)
+{
+    if ((pState->pData != NULL) && (pState->pos + size <= pState->size))
+        EAS_HWMemCpy(pState->pData + pState->pos, pSrc, size);
+    pState->pos += size;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_StateRead()
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateRead (S_EAS_STATE_BUFFER *pState, void *pDst, EAS_I32 size)
+{
+    if (pState->check)
+        pState->pos += size;
+    else
+        EAS_StateGet(pState, pDst, size);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_StateGet()
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateGet (S_EAS_STATE_BUFFER *pState, void *pDst, EAS_I32 size)
+{
+    if (pState->pos + size <= pState->size)
+        EAS_HWMemCpy(pDst, pState->pData + pState->pos, size);
+    else
+        EAS_HWMemSet(pDst, 0, size);
+    pState->pos += size;
+}
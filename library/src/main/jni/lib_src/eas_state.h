@@ -0,0 +1,124 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_state.h
+ *
+ * Contents and purpose:
+ * Buffer used by the modules to save and restore their part of the
+ * synthesizer state, see EAS_SaveState and EAS_RestoreState.
+ *
+ * Each module writes its state with EAS_StateWrite and reads it back
+ * in the same order with EAS_StateRead. With a NULL data pointer the
+ * writes only count the bytes, so the same code measures the state.
+ *
+ * A restore reads the state twice with the same code, first to check it
+ * and then to commit it. While checking, EAS_StateRead only advances the
+ * position, and the values a module checks are read with EAS_StateGet
+ * and only stored when committing.
+ *
+ * The state is in native byte order, and the voices, channels and MIDI
+ * streams are saved as their structures, so a state can only be restored
+ * by a build of the library with the same layout. The header saved by
+ * EAS_SaveState records the layout and EAS_RestoreState checks it.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_STATE_H
+#define _EAS_STATE_H
+
+#include "eas_types.h"
+
+/*----------------------------------------------------------------------------
+ * S_EAS_STATE_BUFFER
+ *
+ * Position in a saved state. The position keeps counting past the end of
+ * the data, so a short buffer shows up as pos > size after the last write.
+ *
+ *----------------------------------------------------------------------------
+*/
+typedef struct s_eas_state_buffer_tag
+{
+    EAS_U8              *pData;             /* state data, NULL to measure */
+    EAS_I32             size;               /* size of the data in bytes */
+    EAS_I32             pos;                /* bytes written or read so far */
+    EAS_BOOL            check;              /* checking a restore, nothing is stored */
+} S_EAS_STATE_BUFFER;
+
+/*----------------------------------------------------------------------------
+ * EAS_StateInit()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Starts a state buffer at the beginning of the data
+ *
+ * Inputs:
+ * pState       - state buffer
+ * pData        - state data, NULL to measure the size of the state
+ * size         - size of the data in bytes
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateInit (S_EAS_STATE_BUFFER *pState, void *pData, EAS_I32 size);
+
+/*----------------------------------------------------------------------------
+ * EAS_StateWrite()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Appends data to the state, or only counts it when measuring
+ *
+ * Inputs:
+ * pState       - state buffer
+ * pSrc         - data to save
+ * size         - size of the data in bytes
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateWrite (S_EAS_STATE_BUFFER *pState, const void *pSrc, EAS_I32 size);
+
+/*----------------------------------------------------------------------------
+ * EAS_StateRead()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the next data from the state into the module, or only skips it
+ * when checking. Reads past the end return zeros.
+ *
+ * Inputs:
+ * pState       - state buffer
+ * pDst         - data to restore
+ * size         - size of the data in bytes
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateRead (S_EAS_STATE_BUFFER *pState, void *pDst, EAS_I32 size);
+
+/*----------------------------------------------------------------------------
+ * EAS_StateGet()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the next data from the state into a local to check, also when
+ * checking. Reads past the end return zeros.
+ *
+ * Inputs:
+ * pState       - state buffer
+ * pDst         - local for the data
+ * size         - size of the data in bytes
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_StateGet (S_EAS_STATE_BUFFER *pState, void *pDst, EAS_I32 size);
+
+#endif /* #ifndef _EAS_STATE_H */
@@ -93,6 +93,27 @@
 
 #define DEFAULT_SYNTH_VOICES    MAX_SYNTH_VOICES
 
+/* sets of voices are tracked in bitmasks, one bit per voice, EAS_U32 is
+ * 64 bits on LP64 hosts so the words are sized explicitly */
+typedef uint32_t EAS_VOICE_MASK;
+#define VOICE_MASK_BITS             32
+#define NUM_VOICE_MASK_WORDS        ((MAX_SYNTH_VOICES + VOICE_MASK_BITS - 1) / VOICE_MASK_BITS)
+
+/* voice index dimensions, channels include the virtual synth number */
+#define NUM_INDEX_CHANNELS          (MAX_VIRTUAL_SYNTHESIZERS * NUM_SYNTH_CHANNELS)
+#define NUM_INDEX_NOTES             128
+#define UNINDEXED_VOICE             0xff
+
+/* program lookup hash, entries are a source tag and a table index */
+#define PROGRAM_HASH_BITS           9
+#define PROGRAM_HASH_SIZE           (1 << PROGRAM_HASH_BITS)
+#define PROGRAM_HASH_EMPTY          0
+#define PROGRAM_HASH_TAG_SHIFT      14
+#define PROGRAM_HASH_INDEX_MASK     0x3fff
+#define PROGRAM_HASH_EAS_BANK       1
+#define PROGRAM_HASH_EAS_PROGRAM    2
+#define PROGRAM_HASH_DLS_PROGRAM    3
+
 /* use the following values to specify unassigned channels or voices */
 #define UNASSIGNED_SYNTH_CHANNEL    NUM_SYNTH_CHANNELS
 #define UNASSIGNED_SYNTH_VOICE      MAX_SYNTH_VOICES
@@ -109,6 +130,11 @@
 #define NOTE_MATCH_PENALTY              128
 #define SYNTH_PRIORITY_WEIGHT           8
 
+/* weights used by the alternate stealing policies */
+#define OLDEST_NOTE_STEAL_OFFSET        256
+#define SAME_NOTE_STEAL_WEIGHT          16
+#define CHANNEL_ORDER_STEAL_WEIGHT      16
+
 /* default synth master volume */
 #define DEFAULT_SYNTH_MASTER_VOLUME     0x7fff
 
@@ -238,6 +264,22 @@ typedef struct s_synth_channel_tag
 #endif
 } S_SYNTH_CHANNEL;
 
+/*------------------------------------
+ * S_NOTE_REGION_MAP data structure
+ *
+ * Regions of the channel's program that
+ * contain each key, built on first use
+ *------------------------------------
+*/
+#define NUM_NOTE_MAP_KEYS   128
+
+typedef struct s_note_region_map_tag
+{
+    EAS_U16     programRegion;                  /* first region of the mapped program */
+    EAS_U16     firstRegion[NUM_NOTE_MAP_KEYS]; /* first region containing the key */
+    EAS_U16     lastRegion[NUM_NOTE_MAP_KEYS];  /* last region containing the key */
+} S_NOTE_REGION_MAP;
+
 /*------------------------------------
  * S_SYNTH_VOICE data structure
  *------------------------------------
@@ -318,6 +360,16 @@ typedef struct s_synth_tag
 #endif
 
     S_SYNTH_CHANNEL         channels[NUM_SYNTH_CHANNELS];
+
+    /* channels with CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS set, one bit each */
+    EAS_U16                 dirtyChannels;
+
+    /* bank and program locales of the attached libraries */
+    EAS_U16                 programHash[PROGRAM_HASH_SIZE];
+    EAS_BOOL8               programHashValid;
+
+    S_NOTE_REGION_MAP       noteMaps[NUM_SYNTH_CHANNELS];
+
     EAS_I32                 totalNoteCount;
     EAS_U16                 maxPolyphony;
     EAS_U16                 numActiveVoices;
@@ -332,6 +384,23 @@ typedef struct s_synth_tag
     EAS_U8                  priority;
 } S_SYNTH;
 
+/*------------------------------------
+ * S_SYNTH_STATE data structure
+ *
+ * MIDI controlled channel state of a
+ * virtual synth, restored without
+ * replaying the MIDI data
+ *------------------------------------
+*/
+typedef struct s_synth_state_tag
+{
+    const S_EAS             *pEAS;
+#ifdef DLS_SYNTHESIZER
+    S_DLS                   *pDLS;
+#endif
+    S_SYNTH_CHANNEL         channels[NUM_SYNTH_CHANNELS];
+} S_SYNTH_STATE;
+
 /*------------------------------------
  * S_VOICE_MGR data structure
  *
@@ -361,6 +430,15 @@ typedef struct s_voice_mgr_tag
 #endif
     S_SYNTH_VOICE           voices[MAX_SYNTH_VOICES];
 
+    /* bit set for each voice in eVoiceStateFree */
+    EAS_VOICE_MASK          freeVoiceMask[NUM_VOICE_MASK_WORDS];
+
+    /* active voices by channel and by note, stolen voices use the new note */
+    EAS_VOICE_MASK          channelVoiceMask[NUM_INDEX_CHANNELS][NUM_VOICE_MASK_WORDS];
+    EAS_VOICE_MASK          noteVoiceMask[NUM_INDEX_NOTES][NUM_VOICE_MASK_WORDS];
+    EAS_U8                  indexChannel[MAX_SYNTH_VOICES];
+    EAS_U8                  indexNote[MAX_SYNTH_VOICES];
+
     EAS_SNDLIB_HANDLE       pGlobalEAS;
 
 #ifdef DLS_SYNTHESIZER
@@ -383,6 +461,7 @@ typedef struct s_voice_mgr_tag
     EAS_U16                 maxPolyphony;
 
     EAS_U16                 age;
+    EAS_U8                  stealPolicy;
 
 /* limits the number of voice starts in a frame for split architecture */
 #ifdef MAX_VOICE_STARTS
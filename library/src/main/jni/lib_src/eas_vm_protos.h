@@ -33,6 +33,7 @@
 // includes
 #include "eas_data.h"
 #include "eas_sndlib.h"
+#include "eas_state.h"
 
 /*----------------------------------------------------------------------------
  * VMInitialize()
@@ -90,6 +91,83 @@ void VMInitializeAllChannels (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth);
 */
 void VMResetControllers (S_SYNTH *pSynth);
 
+/*----------------------------------------------------------------------------
+ * VMGetSynthState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the MIDI controlled channel state of the synth
+ *
+ * Inputs:
+ * pSynth           - pointer to virtual synth
+ * pState           - pointer to state to fill in
+ *
+ * Outputs:
+ * returns EAS_ERROR_NOT_VALID_IN_THIS_STATE if a reset is pending or
+ * SP-MIDI is active
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMGetSynthState (S_SYNTH *pSynth, S_SYNTH_STATE *pState);
+
+/*----------------------------------------------------------------------------
+ * VMSetSynthState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores channel state saved by VMGetSynthState. The synth must have
+ * no active voices.
+ *
+ * Inputs:
+ * pSynth           - pointer to virtual synth
+ * pState           - pointer to saved state
+ *
+ * Outputs:
+ * returns EAS_ERROR_NOT_VALID_IN_THIS_STATE if the synth is not idle,
+ * SP-MIDI is active or the sound library has changed
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetSynthState (S_SYNTH *pSynth, const S_SYNTH_STATE *pState);
+
+/*----------------------------------------------------------------------------
+ * VMSaveState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the channels of each virtual synth and all the voices, with the
+ * sample pointers of the voices relative to their sample bank
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to voice manager
+ * pState           - state buffer, measures the state if its data is NULL
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSaveState (S_VOICE_MGR *pVoiceMgr, S_EAS_STATE_BUFFER *pState);
+
+/*----------------------------------------------------------------------------
+ * VMRestoreState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the state saved by VMSaveState. The same virtual synths must
+ * exist with the same libraries attached, otherwise nothing is restored.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to voice manager
+ * pState           - state buffer
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMRestoreState (S_VOICE_MGR *pVoiceMgr, S_EAS_STATE_BUFFER *pState);
+
 /*----------------------------------------------------------------------------
  * VMInitMIPTable()
  *----------------------------------------------------------------------------
@@ -321,7 +399,7 @@ EAS_RESULT VMStealVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_INT *pVoic
  *
  *----------------------------------------------------------------------------
 */
-EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSamplesToAdd);
+EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 numSamplesToAdd);
 
 /*----------------------------------------------------------------------------
  * VMProgramChange()
@@ -795,6 +873,25 @@ EAS_RESULT VMSetPriority (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 prior
 */
 EAS_RESULT VMGetPriority (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 *pPriority);
 
+/*----------------------------------------------------------------------------
+ * VMSetStealPolicy()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Select the algorithm used to pick a voice when none are free
+ *
+ * Inputs:
+ * pVoiceMgr        pointer to synthesizer data
+ * policy           one of the EAS_STEAL_POLICY values
+ *
+ * Outputs:
+ * Returns error code
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetStealPolicy (S_VOICE_MGR *pVoiceMgr, EAS_I32 policy);
+
 /*----------------------------------------------------------------------------
  * VMSetVolume()
  *----------------------------------------------------------------------------
@@ -923,7 +1020,7 @@ EAS_I32 VMGetNoteCount (S_SYNTH *pSynth);
  *
  *----------------------------------------------------------------------------
 */
-EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBuffer, EAS_I32 *pVoicesRendered);
+EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 *pVoicesRendered);
 
 /*----------------------------------------------------------------------------
  * VMInitWorkload()
@@ -168,6 +168,131 @@ EAS_INLINE EAS_U8 VSynthToChannel (S_SYNTH *pSynth, EAS_U8 channel)
     return channel | (pSynth->vSynthNum << 4);
 }
 
+/*----------------------------------------------------------------------------
+ * SetVoiceFree()
+ *----------------------------------------------------------------------------
+ * Marks a voice as free or in use in the free voice bitmask
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE void SetVoiceFree (S_VOICE_MGR *pVoiceMgr, EAS_INT voiceNum, EAS_BOOL isFree)
+{
+    EAS_VOICE_MASK bit;
+
+    bit = (EAS_VOICE_MASK) 1 << (voiceNum % VOICE_MASK_BITS);
+    if (isFree)
+        pVoiceMgr->freeVoiceMask[voiceNum / VOICE_MASK_BITS] |= bit;
+    else
+        pVoiceMgr->freeVoiceMask[voiceNum / VOICE_MASK_BITS] &= ~bit;
+}
+
+/*----------------------------------------------------------------------------
+ * FindFirstSet()
+ *----------------------------------------------------------------------------
+ * Returns the index of the lowest set bit, bits must be non-zero
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE EAS_INT FindFirstSet (EAS_VOICE_MASK bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    EAS_INT n;
+
+    for (n = 0; (bits & 1) == 0; n++)
+        bits >>= 1;
+    return n;
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * SetChannelDirty()
+ *----------------------------------------------------------------------------
+ * Requests a parameter update for all the voices on a channel and marks the
+ * channel in the dirty mask so only changed channels are visited per frame
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE void SetChannelDirty (S_SYNTH *pSynth, EAS_INT channel)
+{
+    pSynth->channels[channel].channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    pSynth->dirtyChannels |= (EAS_U16) (1 << channel);
+}
+
+/*----------------------------------------------------------------------------
+ * IndexVoice()
+ *----------------------------------------------------------------------------
+ * Moves a voice to the channel and note masks matching its current state.
+ * Stolen voices are indexed by the note they will play next, free voices
+ * are removed. Must be called whenever the voice state, channel or note
+ * change.
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE void IndexVoice (S_VOICE_MGR *pVoiceMgr, EAS_INT voiceNum)
+{
+    S_SYNTH_VOICE *pVoice = &pVoiceMgr->voices[voiceNum];
+    EAS_INT word;
+    EAS_VOICE_MASK bit;
+    EAS_U8 channel;
+    EAS_U8 note;
+
+    word = voiceNum / VOICE_MASK_BITS;
+    bit = (EAS_VOICE_MASK) 1 << (voiceNum % VOICE_MASK_BITS);
+
+    /* remove the previous entry */
+    if (pVoiceMgr->indexChannel[voiceNum] != UNINDEXED_VOICE)
+    {
+        pVoiceMgr->channelVoiceMask[pVoiceMgr->indexChannel[voiceNum]][word] &= ~bit;
+        pVoiceMgr->noteVoiceMask[pVoiceMgr->indexNote[voiceNum]][word] &= ~bit;
+        pVoiceMgr->indexChannel[voiceNum] = UNINDEXED_VOICE;
+    }
+
+    if (pVoice->voiceState == eVoiceStateFree)
+        return;
+
+    if (pVoice->voiceState == eVoiceStateStolen)
+    {
+        channel = pVoice->nextChannel;
+        note = pVoice->nextNote;
+    }
+    else
+    {
+        channel = pVoice->channel;
+        note = pVoice->note;
+    }
+    note &= NUM_INDEX_NOTES - 1;
+
+    pVoiceMgr->channelVoiceMask[channel][word] |= bit;
+    pVoiceMgr->noteVoiceMask[note][word] |= bit;
+    pVoiceMgr->indexChannel[voiceNum] = channel;
+    pVoiceMgr->indexNote[voiceNum] = note;
+}
+
+/*----------------------------------------------------------------------------
+ * GetStealScore()
+ *----------------------------------------------------------------------------
+ * Returns the default steal score of a voice from its age, gain and start
+ * velocity, higher means better for stealing
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE EAS_I32 GetStealScore (const S_SYNTH_VOICE *pVoice)
+{
+    EAS_I32 score;
+
+    /* if voice is stolen or just started, reduce the likelihood it will be stolen */
+    if ((pVoice->voiceState == eVoiceStateStolen) || (pVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
+        score = 128 - pVoice->nextVelocity;
+    else
+    {
+        /* use note age */
+        score = (EAS_I32) pVoice->age << NOTE_AGE_STEAL_WEIGHT;
+
+        /* include note gain -higher gain is lower steal value */
+        /*lint -e{704} use shift for performance */
+        score += ((32768 >> (12 - NOTE_GAIN_STEAL_WEIGHT)) + 256) -
+            ((EAS_I32) pVoice->gain >> (12 - NOTE_GAIN_STEAL_WEIGHT));
+    }
+    return score;
+}
+
 /*----------------------------------------------------------------------------
  * InitVoice()
  *----------------------------------------------------------------------------
@@ -295,7 +420,11 @@ EAS_RESULT VMInitialize (S_EAS_DATA *pEASData)
 
     /* initialize the voice manager parameters */
     for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
         InitVoice(&pVoiceMgr->voices[i]);
+        SetVoiceFree(pVoiceMgr, i, EAS_TRUE);
+        pVoiceMgr->indexChannel[i] = UNINDEXED_VOICE;
+    }
 
     /* initialize the synth */
     /*lint -e{522} return unused at this time */
@@ -378,7 +507,8 @@ EAS_RESULT VMInitMIDI (S_EAS_DATA *pEASData, S_SYNTH **ppSynth)
 #ifdef DLS_SYNTHESIZER
     if (pEASData->pVoiceMgr->pGlobalDLS)
     {
-        pSynth->pDLS = pEASData->pVoiceMgr->pGlobalDLS;
+        /*lint -e{522} return unused at this time */
+        VMSetDLSLib(pSynth, pEASData->pVoiceMgr->pGlobalDLS);
         DLSAddRef(pSynth->pDLS);
     }
 #endif
@@ -556,8 +686,346 @@ void VMResetControllers (S_SYNTH *pSynth)
         pChannel->coarsePitch = DEFAULT_COARSE_PITCH;
 
         /* update all voices on this channel */
-        pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+        SetChannelDirty(pSynth, i);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * VMGetSynthState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the MIDI controlled channel state of the synth
+ *
+ * Inputs:
+ * pSynth           - pointer to virtual synth
+ * pState           - pointer to state to fill in
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMGetSynthState (S_SYNTH *pSynth, S_SYNTH_STATE *pState)
+{
+
+    /* the channels are not settled during a deferred reset, and the
+     * SP-MIDI voice pools are not part of the saved state */
+    if (pSynth->synthFlags & (SYNTH_FLAG_RESET_IS_REQUESTED | SYNTH_FLAG_SP_MIDI_ON))
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+
+    pState->pEAS = pSynth->pEAS;
+#ifdef DLS_SYNTHESIZER
+    pState->pDLS = pSynth->pDLS;
+#endif
+    EAS_HWMemCpy(pState->channels, pSynth->channels, sizeof(pSynth->channels));
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * VMSetSynthState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores channel state saved by VMGetSynthState
+ *
+ * Inputs:
+ * pSynth           - pointer to virtual synth
+ * pState           - pointer to saved state
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetSynthState (S_SYNTH *pSynth, const S_SYNTH_STATE *pState)
+{
+    EAS_INT i;
+
+    /* region indices are only valid for the same sound library */
+    if ((pSynth->numActiveVoices != 0) ||
+        (pSynth->synthFlags & (SYNTH_FLAG_RESET_IS_REQUESTED | SYNTH_FLAG_SP_MIDI_ON)) ||
+        (pState->pEAS != pSynth->pEAS))
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+#ifdef DLS_SYNTHESIZER
+    if (pState->pDLS != pSynth->pDLS)
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+#endif
+
+    /* static parameters are recalculated on the next render */
+    EAS_HWMemCpy(pSynth->channels, pState->channels, sizeof(pSynth->channels));
+    for (i = 0; i < NUM_SYNTH_CHANNELS; i++)
+        SetChannelDirty(pSynth, i);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * S_VM_STATE_LIBRARIES
+ *
+ * Identifies the libraries of a virtual synth in a saved state. Region
+ * indices and sample offsets are only valid for the same libraries.
+ *----------------------------------------------------------------------------
+*/
+typedef struct s_vm_state_libraries_tag
+{
+    EAS_U32                 identifier;         /* sound library, zero if none */
+    EAS_U16                 numWTRegions;
+    EAS_U16                 numSamples;
+    EAS_U16                 numDLSRegions;      /* DLS collection, zero if none */
+    EAS_U16                 numDLSSamples;
+    EAS_U32                 dlsChecksum;        /* content of the DLS collection */
+} S_VM_STATE_LIBRARIES;
+
+/*----------------------------------------------------------------------------
+ * VMStateLibraries()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Fills in the library identification of a virtual synth
+ *
+ *----------------------------------------------------------------------------
+*/
+static void VMStateLibraries (const S_SYNTH *pSynth, S_VM_STATE_LIBRARIES *pLibs)
+{
+    EAS_HWMemSet(pLibs, 0, (EAS_I32) sizeof(S_VM_STATE_LIBRARIES));
+    if (pSynth->pEAS != NULL)
+    {
+        pLibs->identifier = pSynth->pEAS->identifier;
+        pLibs->numWTRegions = pSynth->pEAS->numWTRegions;
+        pLibs->numSamples = pSynth->pEAS->numSamples;
+    }
+#ifdef DLS_SYNTHESIZER
+    if (pSynth->pDLS != NULL)
+    {
+        pLibs->numDLSRegions = pSynth->pDLS->numDLSRegions;
+        pLibs->numDLSSamples = pSynth->pDLS->numDLSSamples;
+        pLibs->dlsChecksum = pSynth->pDLS->checksum;
+    }
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * VMStateRegionValid()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Checks a restored region index against the libraries of a virtual synth
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL VMStateRegionValid (const S_SYNTH *pSynth, EAS_U16 regionIndex)
+{
+#if defined(DLS_SYNTHESIZER)
+    if (regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+        return (pSynth->pDLS != NULL) && ((regionIndex & REGION_INDEX_MASK) < pSynth->pDLS->numDLSRegions);
+#endif
+    if (pSynth->pEAS == NULL)
+        return EAS_FALSE;
+#if defined(_HYBRID_SYNTH)
+    if (regionIndex & FLAG_RGN_IDX_FM_SYNTH)
+        return (regionIndex & REGION_INDEX_MASK) < pSynth->pEAS->numFMRegions;
+    else
+        return regionIndex < pSynth->pEAS->numWTRegions;
+#elif defined(_WT_SYNTH)
+    return regionIndex < pSynth->pEAS->numWTRegions;
+#elif defined(_FM_SYNTH)
+    return regionIndex < pSynth->pEAS->numFMRegions;
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * VMSaveState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the channels of each virtual synth and all the voices, see
+ * EAS_SaveState. Library pointers and the lookup tables built from them
+ * are not saved, nor are the voice indices, which are rebuilt on restore.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to voice manager
+ * pState           - state buffer
+ *
+ * Outputs:
+ * returns EAS_ERROR_FEATURE_NOT_AVAILABLE if a synth cannot save its voices
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSaveState (S_VOICE_MGR *pVoiceMgr, S_EAS_STATE_BUFFER *pState)
+{
+    S_VM_STATE_LIBRARIES libs;
+    const S_SYNTH_INTERFACE *pSynthInterface;
+    S_SYNTH_VOICE *pVoice;
+    S_SYNTH *pSynth;
+    EAS_INT i;
+
+    /* libraries first, so a restore can check them before changing anything */
+    for (i = 0; i < MAX_VIRTUAL_SYNTHESIZERS; i++)
+    {
+        if ((pSynth = pVoiceMgr->pSynth[i]) != NULL)
+        {
+            VMStateLibraries(pSynth, &libs);
+            EAS_StateWrite(pState, &libs, (EAS_I32) sizeof(libs));
+        }
+    }
+
+    for (i = 0; i < MAX_VIRTUAL_SYNTHESIZERS; i++)
+    {
+        if ((pSynth = pVoiceMgr->pSynth[i]) == NULL)
+            continue;
+        EAS_StateWrite(pState, pSynth->channels, (EAS_I32) sizeof(pSynth->channels));
+        EAS_StateWrite(pState, &pSynth->dirtyChannels, (EAS_I32) sizeof(pSynth->dirtyChannels));
+        EAS_StateWrite(pState, &pSynth->totalNoteCount, (EAS_I32) sizeof(pSynth->totalNoteCount));
+        EAS_StateWrite(pState, &pSynth->maxPolyphony, (EAS_I32) sizeof(pSynth->maxPolyphony));
+        EAS_StateWrite(pState, &pSynth->numActiveVoices, (EAS_I32) sizeof(pSynth->numActiveVoices));
+        EAS_StateWrite(pState, &pSynth->masterVolume, (EAS_I32) sizeof(pSynth->masterVolume));
+        EAS_StateWrite(pState, pSynth->channelsByPriority, (EAS_I32) sizeof(pSynth->channelsByPriority));
+        EAS_StateWrite(pState, pSynth->poolCount, (EAS_I32) sizeof(pSynth->poolCount));
+        EAS_StateWrite(pState, pSynth->poolAlloc, (EAS_I32) sizeof(pSynth->poolAlloc));
+        EAS_StateWrite(pState, &pSynth->synthFlags, (EAS_I32) sizeof(pSynth->synthFlags));
+        EAS_StateWrite(pState, &pSynth->globalTranspose, (EAS_I32) sizeof(pSynth->globalTranspose));
+        EAS_StateWrite(pState, &pSynth->priority, (EAS_I32) sizeof(pSynth->priority));
     }
+
+    EAS_StateWrite(pState, &pVoiceMgr->activeVoices, (EAS_I32) sizeof(pVoiceMgr->activeVoices));
+    EAS_StateWrite(pState, &pVoiceMgr->maxPolyphony, (EAS_I32) sizeof(pVoiceMgr->maxPolyphony));
+    EAS_StateWrite(pState, &pVoiceMgr->age, (EAS_I32) sizeof(pVoiceMgr->age));
+    EAS_StateWrite(pState, &pVoiceMgr->stealPolicy, (EAS_I32) sizeof(pVoiceMgr->stealPolicy));
+#if defined(_SECONDARY_SYNTH) || defined(EAS_SPLIT_WT_SYNTH)
+    EAS_StateWrite(pState, &pVoiceMgr->maxPolyphonyPrimary, (EAS_I32) sizeof(pVoiceMgr->maxPolyphonyPrimary));
+    EAS_StateWrite(pState, &pVoiceMgr->maxPolyphonySecondary, (EAS_I32) sizeof(pVoiceMgr->maxPolyphonySecondary));
+#endif
+
+    /* free voices have no virtual synth, the synth saves what they keep */
+    for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
+        pVoice = &pVoiceMgr->voices[i];
+        EAS_StateWrite(pState, pVoice, (EAS_I32) sizeof(S_SYNTH_VOICE));
+        pSynthInterface = GetSynthPtr(i);
+        if (pSynthInterface->pfSaveVoice == NULL)
+            return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+        pSynth = (pVoice->voiceState == eVoiceStateFree) ? NULL : pVoiceMgr->pSynth[GET_VSYNTH(pVoice->channel)];
+        pSynthInterface->pfSaveVoice(pVoiceMgr, pSynth, pVoice, i, pState);
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * VMRestoreState()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the state saved by VMSaveState. The same virtual synths must
+ * exist, with the same libraries attached.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to voice manager
+ * pState           - state buffer
+ *
+ * Outputs:
+ * returns EAS_ERROR_SOUND_LIBRARY if the libraries do not match, or
+ * EAS_ERROR_DATA_INCONSISTENCY if a voice does not fit them
+ *
+ * Side Effects:
+ * Nothing is changed while the state is checked, see EAS_StateGet
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMRestoreState (S_VOICE_MGR *pVoiceMgr, S_EAS_STATE_BUFFER *pState)
+{
+    S_VM_STATE_LIBRARIES libs;
+    S_VM_STATE_LIBRARIES savedLibs;
+    const S_SYNTH_INTERFACE *pSynthInterface;
+    S_SYNTH_VOICE voice;
+    S_SYNTH *pSynth;
+    S_SYNTH *pNextSynth;
+    EAS_RESULT result;
+    EAS_INT i;
+    EAS_INT channel;
+
+    for (i = 0; i < MAX_VIRTUAL_SYNTHESIZERS; i++)
+    {
+        if ((pSynth = pVoiceMgr->pSynth[i]) != NULL)
+        {
+            VMStateLibraries(pSynth, &libs);
+            EAS_StateGet(pState, &savedLibs, (EAS_I32) sizeof(savedLibs));
+            if ((libs.identifier != savedLibs.identifier) ||
+                (libs.numWTRegions != savedLibs.numWTRegions) ||
+                (libs.numSamples != savedLibs.numSamples) ||
+                (libs.numDLSRegions != savedLibs.numDLSRegions) ||
+                (libs.numDLSSamples != savedLibs.numDLSSamples) ||
+                (libs.dlsChecksum != savedLibs.dlsChecksum))
+                return EAS_ERROR_SOUND_LIBRARY;
+        }
+    }
+
+    for (i = 0; i < MAX_VIRTUAL_SYNTHESIZERS; i++)
+    {
+        if ((pSynth = pVoiceMgr->pSynth[i]) == NULL)
+            continue;
+        EAS_StateRead(pState, pSynth->channels, (EAS_I32) sizeof(pSynth->channels));
+        EAS_StateRead(pState, &pSynth->dirtyChannels, (EAS_I32) sizeof(pSynth->dirtyChannels));
+        EAS_StateRead(pState, &pSynth->totalNoteCount, (EAS_I32) sizeof(pSynth->totalNoteCount));
+        EAS_StateRead(pState, &pSynth->maxPolyphony, (EAS_I32) sizeof(pSynth->maxPolyphony));
+        EAS_StateRead(pState, &pSynth->numActiveVoices, (EAS_I32) sizeof(pSynth->numActiveVoices));
+        EAS_StateRead(pState, &pSynth->masterVolume, (EAS_I32) sizeof(pSynth->masterVolume));
+        EAS_StateRead(pState, pSynth->channelsByPriority, (EAS_I32) sizeof(pSynth->channelsByPriority));
+        EAS_StateRead(pState, pSynth->poolCount, (EAS_I32) sizeof(pSynth->poolCount));
+        EAS_StateRead(pState, pSynth->poolAlloc, (EAS_I32) sizeof(pSynth->poolAlloc));
+        EAS_StateRead(pState, &pSynth->synthFlags, (EAS_I32) sizeof(pSynth->synthFlags));
+        EAS_StateRead(pState, &pSynth->globalTranspose, (EAS_I32) sizeof(pSynth->globalTranspose));
+        EAS_StateRead(pState, &pSynth->priority, (EAS_I32) sizeof(pSynth->priority));
+
+        /* the note maps are rebuilt from the restored programs */
+        if (!pState->check)
+            for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
+                pSynth->noteMaps[channel].programRegion = INVALID_REGION_INDEX;
+    }
+
+    EAS_StateRead(pState, &pVoiceMgr->activeVoices, (EAS_I32) sizeof(pVoiceMgr->activeVoices));
+    EAS_StateRead(pState, &pVoiceMgr->maxPolyphony, (EAS_I32) sizeof(pVoiceMgr->maxPolyphony));
+    EAS_StateRead(pState, &pVoiceMgr->age, (EAS_I32) sizeof(pVoiceMgr->age));
+    EAS_StateRead(pState, &pVoiceMgr->stealPolicy, (EAS_I32) sizeof(pVoiceMgr->stealPolicy));
+#if defined(_SECONDARY_SYNTH) || defined(EAS_SPLIT_WT_SYNTH)
+    EAS_StateRead(pState, &pVoiceMgr->maxPolyphonyPrimary, (EAS_I32) sizeof(pVoiceMgr->maxPolyphonyPrimary));
+    EAS_StateRead(pState, &pVoiceMgr->maxPolyphonySecondary, (EAS_I32) sizeof(pVoiceMgr->maxPolyphonySecondary));
+#endif
+
+    /* restore the voices and rebuild the free mask and indices */
+    if (!pState->check)
+    {
+        EAS_HWMemSet(pVoiceMgr->channelVoiceMask, 0, (EAS_I32) sizeof(pVoiceMgr->channelVoiceMask));
+        EAS_HWMemSet(pVoiceMgr->noteVoiceMask, 0, (EAS_I32) sizeof(pVoiceMgr->noteVoiceMask));
+    }
+    for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
+        EAS_StateGet(pState, &voice, (EAS_I32) sizeof(S_SYNTH_VOICE));
+        if (voice.voiceState >= eVoiceStateInvalid)
+            return EAS_ERROR_DATA_INCONSISTENCY;
+
+        /* an active voice plays a region of its virtual synth */
+        pSynth = NULL;
+        if (voice.voiceState != eVoiceStateFree)
+        {
+            if ((GET_VSYNTH(voice.channel) >= MAX_VIRTUAL_SYNTHESIZERS) ||
+                ((pSynth = pVoiceMgr->pSynth[GET_VSYNTH(voice.channel)]) == NULL) ||
+                !VMStateRegionValid(pSynth, voice.regionIndex))
+                return EAS_ERROR_DATA_INCONSISTENCY;
+        }
+        if (voice.voiceState == eVoiceStateStolen)
+        {
+            if ((GET_VSYNTH(voice.nextChannel) >= MAX_VIRTUAL_SYNTHESIZERS) ||
+                ((pNextSynth = pVoiceMgr->pSynth[GET_VSYNTH(voice.nextChannel)]) == NULL) ||
+                !VMStateRegionValid(pNextSynth, voice.nextRegionIndex))
+                return EAS_ERROR_DATA_INCONSISTENCY;
+        }
+
+        pSynthInterface = GetSynthPtr(i);
+        if (pSynthInterface->pfRestoreVoice == NULL)
+            return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+        if ((result = pSynthInterface->pfRestoreVoice(pVoiceMgr, pSynth, &voice, i, pState)) != EAS_SUCCESS)
+            return result;
+
+        if (!pState->check)
+        {
+            pVoiceMgr->voices[i] = voice;
+            pVoiceMgr->indexChannel[i] = UNINDEXED_VOICE;
+            SetVoiceFree(pVoiceMgr, i, (voice.voiceState == eVoiceStateFree));
+            IndexVoice(pVoiceMgr, i);
+        }
+    }
+    return EAS_SUCCESS;
 }
 
 /*----------------------------------------------------------------------------
@@ -582,12 +1050,20 @@ void VMInitializeAllVoices (S_VOICE_MGR *pVoiceMgr, EAS_INT vSynthNum)
         if (pVoiceMgr->voices[i].voiceState != eVoiceStateStolen)
         {
             if (GET_VSYNTH(pVoiceMgr->voices[i].channel) == vSynthNum)
+            {
                 InitVoice(&pVoiceMgr->voices[i]);
+                SetVoiceFree(pVoiceMgr, i, EAS_TRUE);
+                IndexVoice(pVoiceMgr, i);
+            }
         }
         else
         {
             if (GET_VSYNTH(pVoiceMgr->voices[i].nextChannel) == vSynthNum)
+            {
                 InitVoice(&pVoiceMgr->voices[i]);
+                SetVoiceFree(pVoiceMgr, i, EAS_TRUE);
+                IndexVoice(pVoiceMgr, i);
+            }
         }
     }
 }
@@ -614,7 +1090,7 @@ void VMMuteVoice (S_VOICE_MGR *pVoiceMgr, EAS_I32 voiceNum)
     pSynth = pVoiceMgr->pSynth[GET_VSYNTH(pVoice->channel)];
     GetSynthPtr(voiceNum)->pfMuteVoice(pVoiceMgr, pSynth, pVoice, GetAdjustedVoiceNum(voiceNum));
     pVoice->voiceState = eVoiceStateMuting;
-
+    IndexVoice(pVoiceMgr, voiceNum);
 }
 
 /*----------------------------------------------------------------------------
@@ -759,7 +1235,10 @@ void VMMIPUpdateChannelMuting (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
         {
             /* mute stolen voices scheduled to play on this channel */
             if (pVoiceMgr->voices[i].voiceState == eVoiceStateStolen)
+            {
                 pVoiceMgr->voices[i].voiceState = eVoiceStateMuting;
+                IndexVoice(pVoiceMgr, i);
+            }
 
             /* release voices that aren't already muting */
             else if (pVoiceMgr->voices[i].voiceState != eVoiceStateMuting)
@@ -969,6 +1448,8 @@ void VMReleaseAllVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
 void VMAllNotesOff (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
 {
     EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_VOICE_MASK bits;
     S_SYNTH_VOICE *pVoice;
 
 #ifdef _DEBUG_VM
@@ -983,20 +1464,21 @@ void VMAllNotesOff (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
     /* increment workload */
     pVoiceMgr->workload += WORKLOAD_AMOUNT_SMALL_INCREMENT;
 
-    /* check each voice */
+    /* check each voice assigned to this channel */
     channel = VSynthToChannel(pSynth, channel);
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    for (word = 0; word < NUM_VOICE_MASK_WORDS; word++)
     {
-        pVoice = &pVoiceMgr->voices[voiceNum];
-        if (pVoice->voiceState != eVoiceStateFree)
+        bits = pVoiceMgr->channelVoiceMask[channel][word];
+        while (bits)
         {
-            if (((pVoice->voiceState != eVoiceStateStolen) && (channel == pVoice->channel)) ||
-                ((pVoice->voiceState == eVoiceStateStolen) && (channel == pVoice->nextChannel)))
-            {
-                /* this voice is assigned to the requested channel */
-                GetSynthPtr(voiceNum)->pfMuteVoice(pVoiceMgr, pSynth, pVoice, GetAdjustedVoiceNum(voiceNum));
-                pVoice->voiceState = eVoiceStateMuting;
-            }
+            voiceNum = word * VOICE_MASK_BITS + FindFirstSet(bits);
+            bits &= bits - 1;
+
+            /* this voice is assigned to the requested channel */
+            pVoice = &pVoiceMgr->voices[voiceNum];
+            GetSynthPtr(voiceNum)->pfMuteVoice(pVoiceMgr, pSynth, pVoice, GetAdjustedVoiceNum(voiceNum));
+            pVoice->voiceState = eVoiceStateMuting;
+            IndexVoice(pVoiceMgr, voiceNum);
         }
     }
 }
@@ -1130,6 +1612,8 @@ void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_
 {
     S_SYNTH_VOICE *pVoice;
     EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_VOICE_MASK bits;
 
 #ifdef _DEBUG_VM
     if (channel >= NUM_SYNTH_CHANNELS)
@@ -1145,12 +1629,17 @@ void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_
 
     /* find all the voices assigned to this channel */
     channel = VSynthToChannel(pSynth, channel);
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    for (word = 0; word < NUM_VOICE_MASK_WORDS; word++)
     {
-
-        pVoice = &pVoiceMgr->voices[voiceNum];
-        if (channel == pVoice->channel)
+        bits = pVoiceMgr->channelVoiceMask[channel][word];
+        while (bits)
         {
+            voiceNum = word * VOICE_MASK_BITS + FindFirstSet(bits);
+            bits &= bits - 1;
+
+            pVoice = &pVoiceMgr->voices[voiceNum];
+            if (channel != pVoice->channel)
+                continue;
 
             /* does this voice have a deferred note off? */
             if (pVoice->voiceFlags & VOICE_FLAG_SUSTAIN_PEDAL_DEFER_NOTE_OFF)
@@ -1160,9 +1649,7 @@ void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_
 
                 /* use exor to flip bit, clear the flag */
                 pVoice->voiceFlags &= ~VOICE_FLAG_SUSTAIN_PEDAL_DEFER_NOTE_OFF;
-
             }
-
         }
     }
 
@@ -1190,6 +1677,8 @@ void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_
 void VMCatchNotesForSustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
 {
     EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_VOICE_MASK bits;
 
 #ifdef _DEBUG_VM
     if (channel >= NUM_SYNTH_CHANNELS)
@@ -1204,10 +1693,14 @@ void VMCatchNotesForSustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U
     channel = VSynthToChannel(pSynth, channel);
 
     /* find all the voices assigned to this channel */
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    for (word = 0; word < NUM_VOICE_MASK_WORDS; word++)
     {
-        if (channel == pVoiceMgr->voices[voiceNum].channel)
+        bits = pVoiceMgr->channelVoiceMask[channel][word];
+        while (bits)
         {
+            voiceNum = word * VOICE_MASK_BITS + FindFirstSet(bits);
+            bits &= bits - 1;
+
             if (eVoiceStateRelease == pVoiceMgr->voices[voiceNum].voiceState)
                 GetSynthPtr(voiceNum)->pfSustainPedal(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], &pSynth->channels[channel], GetAdjustedVoiceNum(voiceNum));
         }
@@ -1288,6 +1781,7 @@ static void VMStolenVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 voic
 
     /* assign current age to this note and increment for the next note */
     pVoice->age = pVoiceMgr->age++;
+    IndexVoice(pVoiceMgr, voiceNum);
 }
 
 /*----------------------------------------------------------------------------
@@ -1327,6 +1821,8 @@ static void VMFreeVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
     pVoiceMgr->activeVoices--;
     pSynth->numActiveVoices--;
     InitVoice(pVoice);
+    SetVoiceFree(pVoiceMgr, (EAS_INT) (pVoice - pVoiceMgr->voices), EAS_TRUE);
+    IndexVoice(pVoiceMgr, (EAS_INT) (pVoice - pVoiceMgr->voices));
 
 #ifdef _DEBUG_VM
     { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMFreeVoice: free voice %d\n", pVoice - pVoiceMgr->voices); */ }
@@ -1408,6 +1904,7 @@ static EAS_BOOL VMRetargetStolenVoice (S_VOICE_MGR *pVoiceMgr, EAS_I32 voiceNum)
 
     /* setup the voice parameters */
     pVoice->voiceState = eVoiceStateStart;
+    IndexVoice(pVoiceMgr, voiceNum);
 
     /*lint -e{522} return not used at this time */
     GetSynthPtr(voiceNum)->pfStartVoice(pVoiceMgr, pNextSynth, &pVoiceMgr->voices[voiceNum], GetAdjustedVoiceNum(voiceNum), pVoice->regionIndex);
@@ -1437,62 +1934,71 @@ void VMCheckKeyGroup (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U16 keyGroup,
 {
     const S_REGION *pRegion;
     EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_VOICE_MASK bits;
 
     /* increment frame workload */
     pVoiceMgr->workload += WORKLOAD_AMOUNT_KEY_GROUP;
 
     /* need to check all voices in case this is a layered sound */
     channel = VSynthToChannel(pSynth, channel);
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    for (word = 0; word < NUM_VOICE_MASK_WORDS; word++)
     {
-        if (pVoiceMgr->voices[voiceNum].voiceState != eVoiceStateStolen)
+        bits = pVoiceMgr->channelVoiceMask[channel][word];
+        while (bits)
         {
-            /* voice must be on the same channel */
-            if (channel == pVoiceMgr->voices[voiceNum].channel)
+            voiceNum = word * VOICE_MASK_BITS + FindFirstSet(bits);
+            bits &= bits - 1;
+
+            if (pVoiceMgr->voices[voiceNum].voiceState != eVoiceStateStolen)
             {
-                /* check key group */
-                pRegion = GetRegionPtr(pSynth, pVoiceMgr->voices[voiceNum].regionIndex);
-                if (keyGroup == (pRegion->keyGroupAndFlags & 0x0f00))
+                /* voice must be on the same channel */
+                if (channel == pVoiceMgr->voices[voiceNum].channel)
                 {
+                    /* check key group */
+                    pRegion = GetRegionPtr(pSynth, pVoiceMgr->voices[voiceNum].regionIndex);
+                    if (keyGroup == (pRegion->keyGroupAndFlags & 0x0f00))
+                    {
 #ifdef _DEBUG_VM
-                    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMCheckKeyGroup: voice %d matches key group %d\n", voiceNum, keyGroup >> 8); */ }
+                        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMCheckKeyGroup: voice %d matches key group %d\n", voiceNum, keyGroup >> 8); */ }
 #endif
 
-                    /* if this voice was just started, set it to mute on the next buffer */
-                    if (pVoiceMgr->voices[voiceNum].voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET)
-                        pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MUTE;
+                        /* if this voice was just started, set it to mute on the next buffer */
+                        if (pVoiceMgr->voices[voiceNum].voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET)
+                            pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MUTE;
 
-                    /* mute immediately */
-                    else
-                        VMMuteVoice(pVoiceMgr, voiceNum);
+                        /* mute immediately */
+                        else
+                            VMMuteVoice(pVoiceMgr, voiceNum);
+                    }
                 }
             }
-        }
 
-        /* for stolen voice, check new values */
-        else
-        {
-            /* voice must be on the same channel */
-            if (channel == pVoiceMgr->voices[voiceNum].nextChannel)
+            /* for stolen voice, check new values */
+            else
             {
-                /* check key group */
-                pRegion = GetRegionPtr(pSynth, pVoiceMgr->voices[voiceNum].nextRegionIndex);
-                if (keyGroup == (pRegion->keyGroupAndFlags & 0x0f00))
+                /* voice must be on the same channel */
+                if (channel == pVoiceMgr->voices[voiceNum].nextChannel)
                 {
+                    /* check key group */
+                    pRegion = GetRegionPtr(pSynth, pVoiceMgr->voices[voiceNum].nextRegionIndex);
+                    if (keyGroup == (pRegion->keyGroupAndFlags & 0x0f00))
+                    {
 #ifdef _DEBUG_VM
-                    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMCheckKeyGroup: voice %d matches key group %d\n", voiceNum, keyGroup >> 8); */ }
+                        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMCheckKeyGroup: voice %d matches key group %d\n", voiceNum, keyGroup >> 8); */ }
 #endif
 
-                    /* if this voice was just started, set it to mute on the next buffer */
-                    if (pVoiceMgr->voices[voiceNum].voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET)
-                        pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MUTE;
+                        /* if this voice was just started, set it to mute on the next buffer */
+                        if (pVoiceMgr->voices[voiceNum].voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET)
+                            pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MUTE;
 
-                    /* mute immediately */
-                    else
-                        VMMuteVoice(pVoiceMgr, voiceNum);
+                        /* mute immediately */
+                        else
+                            VMMuteVoice(pVoiceMgr, voiceNum);
+                    }
                 }
-            }
 
+            }
         }
     }
 }
@@ -1687,6 +2193,8 @@ void VMStartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_
 
         /* setup the synthesis parameters */
         pVoiceMgr->voices[voiceNum].voiceState = eVoiceStateStart;
+        SetVoiceFree(pVoiceMgr, voiceNum, EAS_FALSE);
+        IndexVoice(pVoiceMgr, voiceNum);
 
         /* increment voice pool count */
         IncVoicePoolCount(pVoiceMgr, pVoice);
@@ -1712,6 +2220,76 @@ void VMStartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_
     return;
 }
 
+/*----------------------------------------------------------------------------
+ * VMBuildNoteMap()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Records the first and last region of a program whose keyrange contains
+ * each key, so note-on does not walk the whole region list.
+ *
+ * Inputs:
+ * pSynth           pointer to virtual synth
+ * pMap             map to fill in
+ * regionIndex      first region of the program
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static void VMBuildNoteMap (S_SYNTH *pSynth, S_NOTE_REGION_MAP *pMap, EAS_U16 regionIndex)
+{
+    const S_REGION *pRegion;
+    EAS_INT key;
+    EAS_INT high;
+
+    pMap->programRegion = regionIndex;
+    for (key = 0; key < NUM_NOTE_MAP_KEYS; key++)
+    {
+        pMap->firstRegion[key] = INVALID_REGION_INDEX;
+        pMap->lastRegion[key] = 0;
+    }
+
+    for (;;)
+    {
+        pRegion = GetRegionPtr(pSynth, regionIndex);
+        high = pRegion->rangeHigh;
+        if (high >= NUM_NOTE_MAP_KEYS)
+            high = NUM_NOTE_MAP_KEYS - 1;
+        for (key = pRegion->rangeLow; key <= high; key++)
+        {
+            if (pMap->firstRegion[key] == INVALID_REGION_INDEX)
+                pMap->firstRegion[key] = regionIndex;
+            pMap->lastRegion[key] = regionIndex;
+        }
+
+        /* last region in program? */
+        if (pRegion->keyGroupAndFlags & REGION_FLAG_LAST_REGION)
+            break;
+
+        /* advance to next region */
+        regionIndex++;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * VMInvalidateNoteMaps()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Discards the note maps when the sound library changes
+ *
+ * Inputs:
+ * pSynth           pointer to virtual synth
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static void VMInvalidateNoteMaps (S_SYNTH *pSynth)
+{
+    EAS_INT channel;
+
+    for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
+        pSynth->noteMaps[channel].programRegion = INVALID_REGION_INDEX;
+}
+
 /*----------------------------------------------------------------------------
  * VMStartNote()
  *----------------------------------------------------------------------------
@@ -1736,6 +2314,7 @@ void VMStartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_
 void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 note, EAS_U8 velocity)
 {
     S_SYNTH_CHANNEL *pChannel;
+    S_NOTE_REGION_MAP *pMap;
     EAS_U16 regionIndex;
     EAS_I16 adjustedNote;
 
@@ -1782,11 +2361,16 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
         adjustedNote = 127;
     }
 
+    /* map the program's keyranges on the first note after a program change */
+    pMap = &pSynth->noteMaps[channel];
+    if (pMap->programRegion != regionIndex)
+        VMBuildNoteMap(pSynth, pMap, regionIndex);
+
 #if defined(DLS_SYNTHESIZER)
     if (regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
     {
-        /* DLS voice */
-        for (;;)
+        /* DLS voice, only regions between the first and last key match can play */
+        for (regionIndex = pMap->firstRegion[adjustedNote]; regionIndex <= pMap->lastRegion[adjustedNote]; regionIndex++)
         {
             /*lint -e{740,826} cast OK, we know this is actually a DLS region */
             const S_DLS_REGION *pDLSRegion = (S_DLS_REGION*) GetRegionPtr(pSynth, regionIndex);
@@ -1797,13 +2381,6 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
             {
                 VMStartVoice(pVoiceMgr, pSynth, channel, note, velocity, regionIndex);
             }
-
-            /* last region in program? */
-            if (pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_LAST_REGION)
-                break;
-
-            /* advance to next region */
-            regionIndex++;
         }
     }
     /* reserve exclusive use of the DLS soundbank */
@@ -1812,25 +2389,9 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
 
     /* braces here for #if clause */
     {
-        /* EAS voice */
-        for (;;)
-        {
-            const S_REGION *pRegion = GetRegionPtr(pSynth, regionIndex);
-
-            /* check key against this region's keyrange */
-            if ((adjustedNote >= pRegion->rangeLow) && (adjustedNote <= pRegion->rangeHigh))
-            {
-                VMStartVoice(pVoiceMgr, pSynth, channel, note, velocity, regionIndex);
-                break;
-            }
-
-            /* last region in program? */
-            if (pRegion->keyGroupAndFlags & REGION_FLAG_LAST_REGION)
-                break;
-
-            /* advance to next region */
-            regionIndex++;
-        }
+        /* EAS voice, first region whose keyrange contains the key */
+        if (pMap->firstRegion[adjustedNote] != INVALID_REGION_INDEX)
+            VMStartVoice(pVoiceMgr, pSynth, channel, note, velocity, pMap->firstRegion[adjustedNote]);
     }
 }
 
@@ -1859,6 +2420,8 @@ void VMStopNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8
 {
     S_SYNTH_CHANNEL *pChannel;
     EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_VOICE_MASK bits;
 
     pChannel = &(pSynth->channels[channel]);
 
@@ -1880,54 +2443,60 @@ void VMStopNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8
 
     channel = VSynthToChannel(pSynth, channel);
 
-    for (voiceNum=0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    for (word = 0; word < NUM_VOICE_MASK_WORDS; word++)
     {
-
-        /* stolen notes are handled separately */
-        if (eVoiceStateStolen != pVoiceMgr->voices[voiceNum].voiceState)
+        bits = pVoiceMgr->channelVoiceMask[channel][word] & pVoiceMgr->noteVoiceMask[note & (NUM_INDEX_NOTES - 1)][word];
+        while (bits)
         {
+            voiceNum = word * VOICE_MASK_BITS + FindFirstSet(bits);
+            bits &= bits - 1;
 
-            /* channel and key number must match */
-            if ((channel == pVoiceMgr->voices[voiceNum].channel) && (note == pVoiceMgr->voices[voiceNum].note))
+            /* stolen notes are handled separately */
+            if (eVoiceStateStolen != pVoiceMgr->voices[voiceNum].voiceState)
             {
+
+                /* channel and key number must match */
+                if ((channel == pVoiceMgr->voices[voiceNum].channel) && (note == pVoiceMgr->voices[voiceNum].note))
+                {
 #ifdef _DEBUG_VM
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStopNote: voice %d channel %d note %d\n",
-                    voiceNum, channel, note); */ }
+                    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStopNote: voice %d channel %d note %d\n",
+                        voiceNum, channel, note); */ }
 #endif
 
-                /* if sustain pedal is down, set deferred note-off flag */
-                if (pChannel->channelFlags & CHANNEL_FLAG_SUSTAIN_PEDAL)
-                {
-                    pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_SUSTAIN_PEDAL_DEFER_NOTE_OFF;
-                    continue;
-                }
+                    /* if sustain pedal is down, set deferred note-off flag */
+                    if (pChannel->channelFlags & CHANNEL_FLAG_SUSTAIN_PEDAL)
+                    {
+                        pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_SUSTAIN_PEDAL_DEFER_NOTE_OFF;
+                        continue;
+                    }
 
-                /* if this note just started, wait before we stop it */
-                if (pVoiceMgr->voices[voiceNum].voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET)
-                {
+                    /* if this note just started, wait before we stop it */
+                    if (pVoiceMgr->voices[voiceNum].voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET)
+                    {
 #ifdef _DEBUG_VM
-                    { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "\tDeferred: Not started yet\n"); */ }
+                        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "\tDeferred: Not started yet\n"); */ }
 #endif
-                    pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MIDI_NOTE_OFF;
-                    pSynth->synthFlags |= SYNTH_FLAG_DEFERRED_MIDI_NOTE_OFF_PENDING;
-                }
+                        pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MIDI_NOTE_OFF;
+                        pSynth->synthFlags |= SYNTH_FLAG_DEFERRED_MIDI_NOTE_OFF_PENDING;
+                    }
 
-                /* release voice */
-                else
-                    VMReleaseVoice(pVoiceMgr, pSynth, voiceNum);
+                    /* release voice */
+                    else
+                        VMReleaseVoice(pVoiceMgr, pSynth, voiceNum);
 
+                }
             }
-        }
 
-        /* process stolen notes, new channel and key number must match */
-        else if ((channel == pVoiceMgr->voices[voiceNum].nextChannel) && (note == pVoiceMgr->voices[voiceNum].nextNote))
-        {
+            /* process stolen notes, new channel and key number must match */
+            else if ((channel == pVoiceMgr->voices[voiceNum].nextChannel) && (note == pVoiceMgr->voices[voiceNum].nextNote))
+            {
 
 #ifdef _DEBUG_VM
-            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStopNote: voice %d channel %d note %d\n\tDeferred: Stolen voice\n",
-                voiceNum, channel, note); */ }
+                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStopNote: voice %d channel %d note %d\n\tDeferred: Stolen voice\n",
+                    voiceNum, channel, note); */ }
 #endif
-            pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MIDI_NOTE_OFF;
+                pVoiceMgr->voices[voiceNum].voiceFlags |= VOICE_FLAG_DEFER_MIDI_NOTE_OFF;
+            }
         }
     }
 }
@@ -1949,15 +2518,28 @@ void VMStopNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8
 */
 EAS_RESULT VMFindAvailableVoice (S_VOICE_MGR *pVoiceMgr, EAS_INT *pVoiceNumber, EAS_I32 lowVoice, EAS_I32 highVoice)
 {
-    EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_INT lowWord;
+    EAS_INT highWord;
+    EAS_VOICE_MASK bits;
 
-    /* Check each voice to see if it has been assigned to a synth channel */
-    for (voiceNum = lowVoice; voiceNum <= highVoice; voiceNum++)
+    lowWord = lowVoice / VOICE_MASK_BITS;
+    highWord = highVoice / VOICE_MASK_BITS;
+
+    /* lowest free voice in the pool, same choice as a linear scan */
+    for (word = lowWord; word <= highWord; word++)
     {
-        /* check if this voice has been assigned to a synth channel */
-        if ( pVoiceMgr->voices[voiceNum].voiceState == eVoiceStateFree)
+        bits = pVoiceMgr->freeVoiceMask[word];
+
+        /* mask off voices outside the pool */
+        if (word == lowWord)
+            bits &= ~(((EAS_VOICE_MASK) 1 << (lowVoice % VOICE_MASK_BITS)) - 1);
+        if ((word == highWord) && ((highVoice % VOICE_MASK_BITS) != VOICE_MASK_BITS - 1))
+            bits &= ((EAS_VOICE_MASK) 1 << ((highVoice % VOICE_MASK_BITS) + 1)) - 1;
+
+        if (bits != 0)
         {
-            *pVoiceNumber = voiceNum;       /* this voice is available */
+            *pVoiceNumber = word * VOICE_MASK_BITS + FindFirstSet(bits);
             return EAS_SUCCESS;
         }
     }
@@ -1989,6 +2571,10 @@ EAS_RESULT VMFindAvailableVoice (S_VOICE_MGR *pVoiceMgr, EAS_INT *pVoiceNumber,
  * Key velocity (for voices that haven't been started yet)
  * If any matching notes are found
  *
+ * The age, gain and velocity terms come from GetStealScore(). Stealing is
+ * rare, so they are computed here rather than kept current every frame.
+ * pVoiceMgr->stealPolicy replaces them with an alternate ordering.
+ *
  * Inputs:
  * pnVoiceNumber - really an output, see below
  * nChannel - the channel that this voice wants to be started on
@@ -2044,21 +2630,43 @@ EAS_RESULT VMStealVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_INT *pVoic
 //      { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStealVoice: New priority = %d exceeds old priority = %d\n", pSynth->priority, pCurrSynth->priority); */ }
 #endif
 
-        /* if voice is stolen or just started, reduce the likelihood it will be stolen */
-        if (( pCurrVoice->voiceState == eVoiceStateStolen) || (pCurrVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
-        {
-            currentPriority = 128 - pCurrVoice->nextVelocity;
-        }
-        else
+        /* compute the priority of this voice, higher means better for stealing */
+        switch (pVoiceMgr->stealPolicy)
         {
-            /* compute the priority of this voice, higher means better for stealing */
-            /* use not age */
-            currentPriority = (EAS_I32) pCurrVoice->age << NOTE_AGE_STEAL_WEIGHT;
+            case EAS_STEAL_POLICY_OLDEST:
+                /* voices that have not sounded yet go after all playing voices */
+                if ((pCurrVoice->voiceState == eVoiceStateStolen) || (pCurrVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
+                    currentPriority = GetStealScore(pCurrVoice);
+                else
+                    currentPriority = OLDEST_NOTE_STEAL_OFFSET + (EAS_U16) (pVoiceMgr->age - pCurrVoice->age);
+                break;
+
+            case EAS_STEAL_POLICY_QUIETEST:
+                if ((pCurrVoice->voiceState == eVoiceStateStolen) || (pCurrVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
+                    currentPriority = 0;
+                else
+                    currentPriority = 32768 - pCurrVoice->gain;
+                break;
+
+            case EAS_STEAL_POLICY_SAME_NOTE:
+                currentPriority = GetStealScore(pCurrVoice);
+                if ((note == currNote) && (channel == currChannel))
+                    currentPriority += 1L << SAME_NOTE_STEAL_WEIGHT;
+                break;
 
-            /* include note gain -higher gain is lower steal value */
-            /*lint -e{704} use shift for performance */
-            currentPriority += ((32768 >> (12 - NOTE_GAIN_STEAL_WEIGHT)) + 256) -
-                ((EAS_I32) pCurrVoice->gain >> (12 - NOTE_GAIN_STEAL_WEIGHT));
+            case EAS_STEAL_POLICY_CHANNEL_PRIORITY:
+                /* SP-MIDI pools if present, otherwise higher channels are lower priority */
+                currentPriority = GetStealScore(pCurrVoice);
+                if (pSynth->synthFlags & SYNTH_FLAG_SP_MIDI_ON)
+                    currentPriority += (EAS_I32) pCurrSynth->channels[GET_CHANNEL(currChannel)].pool << CHANNEL_ORDER_STEAL_WEIGHT;
+                else
+                    currentPriority += (EAS_I32) GET_CHANNEL(currChannel) << CHANNEL_ORDER_STEAL_WEIGHT;
+                break;
+
+            default:
+                /* age, gain and start velocity */
+                currentPriority = GetStealScore(pCurrVoice);
+                break;
         }
 
         /* in SP-MIDI mode, include over poly allocation and channel priority */
@@ -2137,7 +2745,7 @@ void VMChannelPressure (S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 value)
     set a channel flag to request parameter updates
     for all the voices associated with this channel
     */
-    pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    SetChannelDirty(pSynth, channel);
 }
 
 /*----------------------------------------------------------------------------
@@ -2179,7 +2787,7 @@ void VMPitchBend (S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 nPitchLSB, EAS_U8 nPit
     set a channel flag to request parameter updates
     for all the voices associated with this channel
     */
-    pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    SetChannelDirty(pSynth, channel);
 }
 
 /*----------------------------------------------------------------------------
@@ -2210,7 +2818,7 @@ void VMControlChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
     set a channel flag to request parameter updates
     for all the voices associated with this channel
     */
-    pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    SetChannelDirty(pSynth, channel);
 
     switch ( controller )
     {
@@ -2503,6 +3111,7 @@ EAS_RESULT VMUpdateRPNStateMachine (S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 cont
 void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
 {
     EAS_INT channel;
+    EAS_U32 dirty;
 
     if (pSynth->synthFlags & SYNTH_FLAG_UPDATE_ALL_CHANNEL_PARAMETERS)
     {
@@ -2533,8 +3142,11 @@ void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
     {
 
         /* only update channel params if signalled by a channel flag */
-        for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
+        dirty = pSynth->dirtyChannels;
+        while (dirty)
         {
+            channel = FindFirstSet(dirty);
+            dirty &= dirty - 1;
             if ( 0 != (pSynth->channels[channel].channelFlags & CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS))
             {
 #ifdef _HYBRID_SYNTH
@@ -2553,6 +3165,144 @@ void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
     return;
 }
 
+/*----------------------------------------------------------------------------
+ * ProgramHashSlot()
+ *----------------------------------------------------------------------------
+ * Returns the first hash slot to probe for a bank or program locale
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE EAS_INT ProgramHashSlot (EAS_U32 locale, EAS_U16 tag)
+{
+    EAS_U32 h;
+
+    /* multiplicative hash on the low 32 bits, tag keeps the sources apart */
+    h = ((locale ^ ((EAS_U32) tag << 28)) * 0x9e3779b1UL) & 0xffffffffUL;
+    return (EAS_INT) (h >> (32 - PROGRAM_HASH_BITS));
+}
+
+/*----------------------------------------------------------------------------
+ * ProgramHashLocale()
+ *----------------------------------------------------------------------------
+ * Returns the locale of the bank or program referenced by a hash entry
+ *----------------------------------------------------------------------------
+*/
+static EAS_U32 ProgramHashLocale (const S_SYNTH *pSynth, EAS_U16 entry)
+{
+    EAS_U16 index = entry & PROGRAM_HASH_INDEX_MASK;
+
+    switch (entry >> PROGRAM_HASH_TAG_SHIFT)
+    {
+        case PROGRAM_HASH_EAS_BANK:
+            return (EAS_U32) pSynth->pEAS->pBanks[index].locale;
+        case PROGRAM_HASH_EAS_PROGRAM:
+            return pSynth->pEAS->pPrograms[index].locale;
+#ifdef DLS_SYNTHESIZER
+        case PROGRAM_HASH_DLS_PROGRAM:
+            return pSynth->pDLS->pDLSPrograms[index].locale;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * ProgramHashFind()
+ *----------------------------------------------------------------------------
+ * Returns the table index for a locale, or -1 if it is not in the library
+ *----------------------------------------------------------------------------
+*/
+static EAS_INT ProgramHashFind (const S_SYNTH *pSynth, EAS_U32 locale, EAS_U16 tag)
+{
+    EAS_INT slot;
+    EAS_U16 entry;
+
+    for (slot = ProgramHashSlot(locale, tag); ; slot = (slot + 1) & (PROGRAM_HASH_SIZE - 1))
+    {
+        entry = pSynth->programHash[slot];
+        if (entry == PROGRAM_HASH_EMPTY)
+            return -1;
+        if (((entry >> PROGRAM_HASH_TAG_SHIFT) == tag) && (ProgramHashLocale(pSynth, entry) == locale))
+            return entry & PROGRAM_HASH_INDEX_MASK;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * ProgramHashInsert()
+ *----------------------------------------------------------------------------
+ * Adds a bank or program to the hash. Duplicate locales keep the first
+ * entry, matching the linear search.
+ *----------------------------------------------------------------------------
+*/
+static void ProgramHashInsert (S_SYNTH *pSynth, EAS_U32 locale, EAS_U16 tag, EAS_U16 index)
+{
+    EAS_INT slot;
+    EAS_U16 entry;
+
+    for (slot = ProgramHashSlot(locale, tag); ; slot = (slot + 1) & (PROGRAM_HASH_SIZE - 1))
+    {
+        entry = pSynth->programHash[slot];
+        if (entry == PROGRAM_HASH_EMPTY)
+        {
+            pSynth->programHash[slot] = (EAS_U16) ((tag << PROGRAM_HASH_TAG_SHIFT) | index);
+            return;
+        }
+        if (((entry >> PROGRAM_HASH_TAG_SHIFT) == tag) && (ProgramHashLocale(pSynth, entry) == locale))
+            return;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * VMBuildProgramHash()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Indexes the banks and programs of the attached sound libraries so that
+ * program changes do not search the tables. Libraries too large for the
+ * hash are left to the linear search.
+ *
+ * Inputs:
+ * pSynth           pointer to virtual synth
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static void VMBuildProgramHash (S_SYNTH *pSynth)
+{
+    EAS_I32 count;
+    EAS_U16 i;
+
+    EAS_HWMemSet(pSynth->programHash, 0, sizeof(pSynth->programHash));
+    pSynth->programHashValid = EAS_FALSE;
+
+    /* keep the load factor at or below three quarters */
+    count = 0;
+    if (pSynth->pEAS != NULL)
+        count += pSynth->pEAS->numBanks + pSynth->pEAS->numPrograms;
+#ifdef DLS_SYNTHESIZER
+    if (pSynth->pDLS != NULL)
+        count += pSynth->pDLS->numDLSPrograms;
+#endif
+    if (count > ((PROGRAM_HASH_SIZE * 3) / 4))
+        return;
+
+    if (pSynth->pEAS != NULL)
+    {
+        for (i = 0; i < pSynth->pEAS->numBanks; i++)
+            ProgramHashInsert(pSynth, (EAS_U32) pSynth->pEAS->pBanks[i].locale, PROGRAM_HASH_EAS_BANK, i);
+        for (i = 0; i < pSynth->pEAS->numPrograms; i++)
+            ProgramHashInsert(pSynth, pSynth->pEAS->pPrograms[i].locale, PROGRAM_HASH_EAS_PROGRAM, i);
+    }
+
+#ifdef DLS_SYNTHESIZER
+    if (pSynth->pDLS != NULL)
+    {
+        for (i = 0; i < pSynth->pDLS->numDLSPrograms; i++)
+            ProgramHashInsert(pSynth, pSynth->pDLS->pDLSPrograms[i].locale, PROGRAM_HASH_DLS_PROGRAM, i);
+    }
+#endif
+
+    pSynth->programHashValid = EAS_TRUE;
+}
+
 /*----------------------------------------------------------------------------
  * VMFindProgram()
  *----------------------------------------------------------------------------
@@ -2566,17 +3316,43 @@ void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
  * Outputs:
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 programNum, EAS_U16 *pRegionIndex)
+static EAS_RESULT VMFindProgram (const S_SYNTH *pSynth, EAS_U32 bank, EAS_U8 programNum, EAS_U16 *pRegionIndex)
 {
+    const S_EAS *pEAS = pSynth->pEAS;
     EAS_U32 locale;
     const S_PROGRAM *p;
     EAS_U16 i;
+    EAS_INT index;
     EAS_U16 regionIndex;
 
     /* make sure we have a valid sound library */
     if (pEAS == NULL)
         return EAS_FAILURE;
 
+    /* establish locale */
+    locale = ( bank << 8) | programNum;
+
+    /* use the hash if the library fit */
+    if (pSynth->programHashValid)
+    {
+        index = ProgramHashFind(pSynth, bank, PROGRAM_HASH_EAS_BANK);
+        if (index >= 0)
+        {
+            regionIndex = pEAS->pBanks[index].regionIndex[programNum];
+            if (regionIndex != INVALID_REGION_INDEX)
+            {
+                *pRegionIndex = regionIndex;
+                return EAS_SUCCESS;
+            }
+        }
+
+        index = ProgramHashFind(pSynth, locale, PROGRAM_HASH_EAS_PROGRAM);
+        if (index < 0)
+            return EAS_FAILURE;
+        *pRegionIndex = pEAS->pPrograms[index].regionIndex;
+        return EAS_SUCCESS;
+    }
+
     /* search the banks */
     for (i = 0; i <  pEAS->numBanks; i++)
     {
@@ -2592,9 +3368,6 @@ static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 program
         }
     }
 
-    /* establish locale */
-    locale = ( bank << 8) | programNum;
-
     /* search for program */
     for (i = 0, p = pEAS->pPrograms; i < pEAS->numPrograms; i++, p++)
     {
@@ -2609,6 +3382,45 @@ static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 program
 }
 
 #ifdef DLS_SYNTHESIZER
+/*----------------------------------------------------------------------------
+ * VMFindDLSLocale()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Look up a single bank and program locale in the DLS collection
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT VMFindDLSLocale (const S_SYNTH *pSynth, EAS_U32 locale, EAS_U16 *pRegionIndex)
+{
+    const S_DLS *pDLS = pSynth->pDLS;
+    const S_PROGRAM *p;
+    EAS_U16 i;
+    EAS_INT index;
+
+    /* use the hash if the collection fit */
+    if (pSynth->programHashValid)
+    {
+        index = ProgramHashFind(pSynth, locale, PROGRAM_HASH_DLS_PROGRAM);
+        if (index < 0)
+            return EAS_FAILURE;
+        *pRegionIndex = pDLS->pDLSPrograms[index].regionIndex;
+        return EAS_SUCCESS;
+    }
+
+    for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
+    {
+        if (p->locale == locale)
+        {
+            *pRegionIndex = p->regionIndex;
+            return EAS_SUCCESS;
+        }
+    }
+    return EAS_FAILURE;
+}
+
 /*----------------------------------------------------------------------------
  * VMFindDLSProgram()
  *----------------------------------------------------------------------------
@@ -2622,28 +3434,20 @@ static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 program
  * Outputs:
  *----------------------------------------------------------------------------
 */
-static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 programNum, EAS_U16 *pRegionIndex)
+static EAS_RESULT VMFindDLSProgram (const S_SYNTH *pSynth, EAS_U32 bank, EAS_U8 programNum, EAS_U16 *pRegionIndex)
 {
     EAS_U32 locale;
-    const S_PROGRAM *p;
-    EAS_U16 i;
 
     /* make sure we have a valid sound library */
-    if (pDLS == NULL)
+    if (pSynth->pDLS == NULL)
         return EAS_FAILURE;
 
     /* establish locale */
     locale = (bank << 8) | programNum;
 
     /* search for program */
-    for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-    {
-        if (p->locale == locale)
-        {
-            *pRegionIndex = p->regionIndex;
-            return EAS_SUCCESS;
-        }
-    }
+    if (VMFindDLSLocale(pSynth, locale, pRegionIndex) == EAS_SUCCESS)
+        return EAS_SUCCESS;
 
     /* also search bank 0 when default bank (MSB) is used */
     if (((bank & 0xFF00) == DEFAULT_MELODY_BANK_NUMBER) || ((bank & 0xFF00) == DEFAULT_RHYTHM_BANK_NUMBER))
@@ -2652,14 +3456,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = ((bank & 0x100FF) << 8) | programNum;
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pSynth, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
     }
 
     /* fall back to default bank */
@@ -2676,14 +3474,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         }
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pSynth, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
 
         /* also search bank 0 */
 
@@ -2691,14 +3483,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = ((bank & 0x10000) << 8) | programNum;
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pSynth, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
     }
 
     /* switch to program 0 in the default bank, when searching for drum instrument */
@@ -2708,14 +3494,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = ((0x10000 | DEFAULT_RHYTHM_BANK_NUMBER) << 8);
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pSynth, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
 
         /* also search bank 0 */
 
@@ -2723,14 +3503,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
         locale = (0x10000 << 8);
 
         /* search for program */
-        for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
-        {
-            if (p->locale == locale)
-            {
-                *pRegionIndex = p->regionIndex;
-                return EAS_SUCCESS;
-            }
-        }
+        if (VMFindDLSLocale(pSynth, locale, pRegionIndex) == EAS_SUCCESS)
+            return EAS_SUCCESS;
     }
 
     return EAS_FAILURE;
@@ -2807,14 +3581,14 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
 
 #ifdef DLS_SYNTHESIZER
     /* first check for DLS program that may overlay the internal instrument */
-    if (VMFindDLSProgram(pSynth->pDLS, bank | ((pChannel->channelFlags & CHANNEL_FLAG_RHYTHM_CHANNEL) ? 0x10000 : 0), program, &regionIndex) != EAS_SUCCESS)
+    if (VMFindDLSProgram(pSynth, bank | ((pChannel->channelFlags & CHANNEL_FLAG_RHYTHM_CHANNEL) ? 0x10000 : 0), program, &regionIndex) != EAS_SUCCESS)
 #endif
 
     /* braces to support 'if' clause above */
     {
 
         /* look in the internal banks */
-        if (VMFindProgram(pSynth->pEAS, bank, program, &regionIndex) != EAS_SUCCESS)
+        if (VMFindProgram(pSynth, bank, program, &regionIndex) != EAS_SUCCESS)
 
         /* fall back to default bank */
         {
@@ -2823,11 +3597,11 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
             else
                 bank = DEFAULT_MELODY_BANK_NUMBER;
 
-            if (VMFindProgram(pSynth->pEAS, bank, program, &regionIndex) != EAS_SUCCESS)
+            if (VMFindProgram(pSynth, bank, program, &regionIndex) != EAS_SUCCESS)
 
             /* switch to program 0 in the default bank */
             {
-                if (VMFindProgram(pSynth->pEAS, bank, 0, &regionIndex) != EAS_SUCCESS)
+                if (VMFindProgram(pSynth, bank, 0, &regionIndex) != EAS_SUCCESS)
                     { /* dpp: EAS_ReportEx(_EAS_SEVERITY_WARNING, "VMProgramChange: No program @ %03d:%03d:%03d\n",
                         (bank >> 8) & 0x7f, bank & 0x7f, program); */ }
             }
@@ -2842,7 +3616,7 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
     set a channel flag to request parameter updates
     for all the voices associated with this channel
     */
-    pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    SetChannelDirty(pSynth, channel);
 
     return;
 }
@@ -2865,7 +3639,7 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
  *
  *----------------------------------------------------------------------------
 */
-EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSamples)
+EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 numSamples)
 {
     S_SYNTH *pSynth;
     EAS_INT voicesRendered;
@@ -2941,11 +3715,12 @@ EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSa
  *
  *----------------------------------------------------------------------------
 */
-EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBuffer, EAS_I32 *pVoicesRendered)
+EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 *pVoicesRendered)
 {
     S_SYNTH *pSynth;
     EAS_INT i;
     EAS_INT channel;
+    EAS_U32 dirty;
 
 #ifdef _CHECKED_BUILD
     SanityCheck(pVoiceMgr);
@@ -2998,9 +3773,15 @@ EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBu
             pSynth->synthFlags &= ~SYNTH_FLAG_RESET_IS_REQUESTED;
         }
 
-        /* clear channel update flags */
-        for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
+        /* clear channel update flags, only dirty channels can have them set */
+        dirty = pSynth->dirtyChannels;
+        while (dirty)
+        {
+            channel = FindFirstSet(dirty);
+            dirty &= dirty - 1;
             pSynth->channels[channel].channelFlags &= ~CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+        }
+        pSynth->dirtyChannels = 0;
 
         }
 
@@ -3247,6 +4028,31 @@ EAS_RESULT VMSetPriority (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 prior
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * VMSetStealPolicy()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Select the algorithm used to pick a voice when none are free
+ *
+ * Inputs:
+ * pVoiceMgr        pointer to synthesizer data
+ * policy           one of the EAS_STEAL_POLICY values
+ *
+ * Outputs:
+ * Returns error code
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetStealPolicy (S_VOICE_MGR *pVoiceMgr, EAS_I32 policy)
+{
+    if ((policy < 0) || (policy >= NUM_STEAL_POLICIES))
+        return EAS_ERROR_PARAMETER_RANGE;
+    pVoiceMgr->stealPolicy = (EAS_U8) policy;
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * VMSetVolume()
  *----------------------------------------------------------------------------
@@ -3357,6 +4163,8 @@ EAS_RESULT VMSetEASLib (S_SYNTH *pSynth, EAS_SNDLIB_HANDLE pEAS)
         return result;
 
     pSynth->pEAS = pEAS;
+    VMBuildProgramHash(pSynth);
+    VMInvalidateNoteMaps(pSynth);
     return EAS_SUCCESS;
 }
 
@@ -3406,6 +4214,8 @@ EAS_RESULT VMSetGlobalDLSLib (EAS_DATA_HANDLE pEASData, EAS_DLSLIB_HANDLE pDLS)
 EAS_RESULT VMSetDLSLib (S_SYNTH *pSynth, EAS_DLSLIB_HANDLE pDLS)
 {
     pSynth->pDLS = pDLS;
+    VMBuildProgramHash(pSynth);
+    VMInvalidateNoteMaps(pSynth);
     return EAS_SUCCESS;
 }
 #endif
@@ -3690,6 +4500,32 @@ EAS_RESULT VMSanityCheck (EAS_DATA_HANDLE pEASData)
         /* count free voices */
         else
             freeVoices++;
+
+        /* free voice bitmask must agree with the voice state */
+        if (((pEASData->pVoiceMgr->freeVoiceMask[i / VOICE_MASK_BITS] >> (i % VOICE_MASK_BITS)) & 1) !=
+            (pVoice->voiceState == eVoiceStateFree))
+        {
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "VMSanityCheck: Voice %d free mask mismatch\n", i); */ }
+            result = EAS_FAILURE;
+        }
+
+        /* active voices must be indexed under their current channel and note */
+        if (pVoice->voiceState != eVoiceStateFree)
+        {
+            EAS_U8 channel = (pVoice->voiceState == eVoiceStateStolen) ? pVoice->nextChannel : pVoice->channel;
+            EAS_U8 note = (pVoice->voiceState == eVoiceStateStolen) ? pVoice->nextNote : pVoice->note;
+            if ((pEASData->pVoiceMgr->indexChannel[i] != channel) ||
+                (pEASData->pVoiceMgr->indexNote[i] != (note & (NUM_INDEX_NOTES - 1))))
+            {
+                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "VMSanityCheck: Voice %d index mismatch\n", i); */ }
+                result = EAS_FAILURE;
+            }
+        }
+        else if (pEASData->pVoiceMgr->indexChannel[i] != UNINDEXED_VOICE)
+        {
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "VMSanityCheck: Free voice %d still indexed\n", i); */ }
+            result = EAS_FAILURE;
+        }
     }
 
     /* dump state info */
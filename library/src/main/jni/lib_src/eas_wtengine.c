@@ -80,7 +80,7 @@ extern void WT_VoiceFilter (S_FILTER_CONTROL*pFilter, S_WT_INT_FRAME *pWTIntFram
 /*lint -esym(715, pWTVoice) reserved for future use */
 void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 {
-    EAS_I32 *pMixBuffer;
+    EAS_MIX_SAMPLE *pMixBuffer;
     EAS_PCM *pInputBuffer;
     EAS_I32 gain;
     EAS_I32 gainIncrement;
@@ -96,12 +96,10 @@ void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
     /* initialize some local variables */
     numSamples = pWTIntFrame->numSamples;
     if (numSamples <= 0) {
-        ALOGE("b/26366256");
-        android_errorWriteLog(0x534e4554, "26366256");
+        ALOGE_RT("b/26366256", 0, 0);
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-        android_errorWriteLog(0x534e4554, "317780080");
+        ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
     pMixBuffer = pWTIntFrame->pMixBuffer;
@@ -197,12 +195,10 @@ void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
     /* initialize some local variables */
     numSamples = pWTIntFrame->numSamples;
     if (numSamples <= 0) {
-        ALOGE("b/26366256");
-        android_errorWriteLog(0x534e4554, "26366256");
+        ALOGE_RT("b/26366256", 0, 0);
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-        android_errorWriteLog(0x534e4554, "317780080");
+        ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
     pOutputBuffer = pWTIntFrame->pAudioBuffer;
@@ -302,12 +298,10 @@ void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
     /* initialize some local variables */
     numSamples = pWTIntFrame->numSamples;
     if (numSamples <= 0) {
-        ALOGE("b/26366256");
-        android_errorWriteLog(0x534e4554, "26366256");
+        ALOGE_RT("b/26366256", 0, 0);
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-        android_errorWriteLog(0x534e4554, "317780080");
+        ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
     pOutputBuffer = pWTIntFrame->pAudioBuffer;
@@ -406,12 +400,10 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
     /* initialize some local variables */
     numSamples = pWTIntFrame->numSamples;
     if (numSamples <= 0) {
-        ALOGE("b/26366256");
-        android_errorWriteLog(0x534e4554, "26366256");
+        ALOGE_RT("b/26366256", 0, 0);
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-        android_errorWriteLog(0x534e4554, "317780080");
+        ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
     pAudioBuffer = pWTIntFrame->pAudioBuffer;
@@ -478,12 +470,10 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
     /* initialize some local variables */
     numSamples = pWTIntFrame->numSamples;
     if (numSamples <= 0) {
-        ALOGE("b/26366256");
-        android_errorWriteLog(0x534e4554, "26366256");
+        ALOGE_RT("b/26366256", 0, 0);
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-        android_errorWriteLog(0x534e4554, "317780080");
+        ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
     pOutputBuffer = pWTIntFrame->pAudioBuffer;
@@ -615,7 +605,7 @@ void WT_ProcessVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 */
 void WT_InterpolateMono (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 {
-    EAS_I32 *pMixBuffer;
+    EAS_MIX_SAMPLE *pMixBuffer;
     const EAS_I8 *pLoopEnd;
     const EAS_I8 *pCurrentPhaseInt;
     EAS_I32 numSamples;
@@ -630,12 +620,10 @@ void WT_InterpolateMono (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 
     numSamples = pWTIntFrame->numSamples;
     if (numSamples <= 0) {
-        ALOGE("b/26366256");
-        android_errorWriteLog(0x534e4554, "26366256");
+        ALOGE_RT("b/26366256", 0, 0);
         return;
     } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-        android_errorWriteLog(0x534e4554, "317780080");
+        ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
     pMixBuffer = pWTIntFrame->pMixBuffer;
@@ -63,7 +63,7 @@ typedef struct s_wt_int_frame_tag
 {
     S_WT_FRAME      frame;
     EAS_PCM         *pAudioBuffer;
-    EAS_I32         *pMixBuffer;
+    EAS_MIX_SAMPLE  *pMixBuffer;
     EAS_I32         numSamples;
     EAS_I32         prevGain;
 } S_WT_INT_FRAME;
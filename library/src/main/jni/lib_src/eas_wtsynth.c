@@ -54,8 +54,10 @@ static void WT_ReleaseVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VO
 static void WT_MuteVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum);
 static void WT_SustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, S_SYNTH_CHANNEL *pChannel, EAS_I32 voiceNum);
 static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_U16 regionIndex);
-static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_I32 *pMixBuffer, EAS_I32 numSamples);
+static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32 numSamples);
 static void WT_UpdateChannel (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel);
+static void WT_SaveVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, S_EAS_STATE_BUFFER *pState);
+static EAS_RESULT WT_RestoreVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, S_EAS_STATE_BUFFER *pState);
 static EAS_I32 WT_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents);
 static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain);
 static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv);
@@ -63,7 +65,7 @@ static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv);
 
 #ifdef EAS_SPLIT_WT_SYNTH
 extern EAS_BOOL WTE_StartFrame (EAS_FRAME_BUFFER_HANDLE pFrameBuffer);
-extern EAS_BOOL WTE_EndFrame (EAS_FRAME_BUFFER_HANDLE pFrameBuffer, EAS_I32 *pMixBuffer, EAS_I16 masterGain);
+extern EAS_BOOL WTE_EndFrame (EAS_FRAME_BUFFER_HANDLE pFrameBuffer, EAS_MIX_SAMPLE *pMixBuffer, EAS_I16 masterGain);
 #endif
 
 #ifdef _FILTER_ENABLED
@@ -91,7 +93,9 @@ const S_SYNTH_INTERFACE wtSynth =
     WT_ReleaseVoice,
     WT_MuteVoice,
     WT_SustainPedal,
-    WT_UpdateChannel
+    WT_UpdateChannel,
+    WT_SaveVoice,
+    WT_RestoreVoice
 };
 
 #ifdef EAS_SPLIT_WT_SYNTH
@@ -488,19 +492,17 @@ EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, E
             pWTIntFrame->numSamples =
                 (numSamples + pWTIntFrame->frame.phaseIncrement - 1) / pWTIntFrame->frame.phaseIncrement;
             if (oldMethod != pWTIntFrame->numSamples) {
-                ALOGE("b/317780080 old %ld new %ld", oldMethod, pWTIntFrame->numSamples);
+                ALOGE_RT("b/317780080 old %ld new %ld", oldMethod, pWTIntFrame->numSamples);
             }
         } else {
             pWTIntFrame->numSamples = numSamples;
         }
         if (pWTIntFrame->numSamples < 0) {
-            ALOGE("b/26366256");
-            android_errorWriteLog(0x534e4554, "26366256");
+            ALOGE_RT("b/26366256", 0, 0);
             pWTIntFrame->numSamples = 0;
         } else if (pWTIntFrame->numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
-            ALOGE("b/317780080 clip numSamples %ld -> %d",
+            ALOGE_RT("b/317780080 clip numSamples %ld -> %ld",
                   pWTIntFrame->numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
-            android_errorWriteLog(0x534e4554, "317780080");
             pWTIntFrame->numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
         }
 
@@ -536,7 +538,7 @@ EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, E
  *
  *----------------------------------------------------------------------------
 */
-static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_I32 *pMixBuffer, EAS_I32  numSamples)
+static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_MIX_SAMPLE *pMixBuffer, EAS_I32  numSamples)
 {
     S_WT_VOICE *pWTVoice;
     S_WT_INT_FRAME intFrame;
@@ -595,7 +597,7 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     if (temp != 0) {
         temp = temp << NUM_PHASE_FRAC_BITS;
         if (intFrame.frame.phaseIncrement > temp) {
-            ALOGW("%p phaseIncrement=%d", pWTVoice, (int)intFrame.frame.phaseIncrement);
+            ALOGW_RT("%lx phaseIncrement=%ld", pWTVoice, intFrame.frame.phaseIncrement);
             intFrame.frame.phaseIncrement %= temp;
         }
     }
@@ -758,6 +760,180 @@ static void WT_UpdateChannel (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 ch
     return;
 }
 
+/*----------------------------------------------------------------------------
+ * WT_SampleBase()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the address of the sample bank the voice plays from, the sample
+ * pointers of a voice are saved relative to it
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, voiceNum) used for split architecture only */
+static EAS_U32 WT_SampleBase (S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum)
+{
+#ifdef DLS_SYNTHESIZER
+    if (pVoice->regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+        return (EAS_U32) pSynth->pDLS->pDLSSamples;
+#endif
+
+#ifdef EAS_SPLIT_WT_SYNTH
+    /* off-chip voices already hold offsets */
+    if (voiceNum >= NUM_PRIMARY_VOICES)
+        return 0;
+#endif
+
+    return (EAS_U32) pSynth->pEAS->pSamples;
+}
+
+/*----------------------------------------------------------------------------
+ * WT_CheckSavedVoice()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Checks that a restored voice plays an articulation and samples of the
+ * bank it is restored into, with the sample pointers still relative
+ *
+ * Inputs:
+ * pVoice - the restored voice, not free
+ * pWTVoice - the restored wavetable voice
+ *
+ * Outputs:
+ * EAS_ERROR_DATA_INCONSISTENCY if the voice does not fit the bank
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT WT_CheckSavedVoice (S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, const S_WT_VOICE *pWTVoice)
+{
+    const EAS_U32 *pOffsets;
+    const EAS_U32 *pLen;
+    EAS_U32 size;
+    EAS_INT numSamples;
+    EAS_INT numArticulations;
+    EAS_INT i;
+
+#ifdef DLS_SYNTHESIZER
+    if (pVoice->regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+    {
+        pOffsets = pSynth->pDLS->pDLSSampleOffsets;
+        pLen = pSynth->pDLS->pDLSSampleLen;
+        numSamples = pSynth->pDLS->numDLSSamples;
+        numArticulations = pSynth->pDLS->numDLSArticulations;
+    }
+    else
+#endif
+    {
+        pOffsets = pSynth->pEAS->pSampleOffsets;
+        pLen = pSynth->pEAS->pSampleLen;
+        numSamples = pSynth->pEAS->numSamples;
+        numArticulations = pSynth->pEAS->numArticulations;
+    }
+    if (pWTVoice->artIndex >= numArticulations)
+        return EAS_ERROR_DATA_INCONSISTENCY;
+
+    /* the noise generator does not use sample pointers */
+    if (pWTVoice->loopStart == WT_NOISE_GENERATOR)
+        return EAS_SUCCESS;
+
+    size = 0;
+    for (i = 0; i < numSamples; i++)
+        if (pOffsets[i] + pLen[i] > size)
+            size = pOffsets[i] + pLen[i];
+    if ((pWTVoice->loopStart > pWTVoice->loopEnd) ||
+        (pWTVoice->loopEnd >= size) ||
+        (pWTVoice->phaseAccum > size))
+        return EAS_ERROR_DATA_INCONSISTENCY;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * WT_SaveVoice()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the oscillator, envelope, LFO and filter state of an active
+ * voice, or the phase a free voice keeps for its next note
+ *
+ * Inputs:
+ * pSynth - the virtual synth of the voice, NULL if the voice is free
+ * pVoice - the voice
+ * pState - state buffer
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void WT_SaveVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, S_EAS_STATE_BUFFER *pState)
+{
+    S_WT_VOICE wtVoice;
+    EAS_U32 base;
+
+    wtVoice = pVoiceMgr->wtVoices[voiceNum];
+    if (pVoice->voiceState == eVoiceStateFree)
+    {
+        EAS_StateWrite(pState, &wtVoice.phaseFrac, (EAS_I32) sizeof(wtVoice.phaseFrac));
+        return;
+    }
+
+    /* the noise generator does not use sample pointers */
+    if (wtVoice.loopStart != WT_NOISE_GENERATOR)
+    {
+        base = WT_SampleBase(pSynth, pVoice, voiceNum);
+        wtVoice.loopEnd -= base;
+        wtVoice.loopStart -= base;
+        wtVoice.phaseAccum -= base;
+    }
+    EAS_StateWrite(pState, &wtVoice, (EAS_I32) sizeof(wtVoice));
+}
+
+/*----------------------------------------------------------------------------
+ * WT_RestoreVoice()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the voice state saved by WT_SaveVoice. pVoice is the restored
+ * voice, which is only stored in the voice manager after this returns.
+ *
+ * Inputs:
+ * pSynth - the virtual synth of the voice, NULL if the voice is free
+ * pVoice - the restored voice
+ * pState - state buffer
+ *
+ * Outputs:
+ * EAS_ERROR_DATA_INCONSISTENCY if the voice does not fit the bank
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT WT_RestoreVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, S_EAS_STATE_BUFFER *pState)
+{
+    S_WT_VOICE wtVoice;
+    EAS_U32 base;
+    EAS_RESULT result;
+
+    if (pVoice->voiceState == eVoiceStateFree)
+    {
+        EAS_StateRead(pState, &pVoiceMgr->wtVoices[voiceNum].phaseFrac, (EAS_I32) sizeof(wtVoice.phaseFrac));
+        return EAS_SUCCESS;
+    }
+
+    EAS_StateGet(pState, &wtVoice, (EAS_I32) sizeof(wtVoice));
+    if ((result = WT_CheckSavedVoice(pSynth, pVoice, &wtVoice)) != EAS_SUCCESS)
+        return result;
+    if (pState->check)
+        return EAS_SUCCESS;
+
+    if (wtVoice.loopStart != WT_NOISE_GENERATOR)
+    {
+        base = WT_SampleBase(pSynth, pVoice, voiceNum);
+        wtVoice.loopEnd += base;
+        wtVoice.loopStart += base;
+        wtVoice.phaseAccum += base;
+    }
+    pVoiceMgr->wtVoices[voiceNum] = wtVoice;
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * WT_UpdateGain()
  *----------------------------------------------------------------------------
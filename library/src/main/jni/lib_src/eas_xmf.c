@@ -64,6 +64,7 @@ static EAS_RESULT XMF_Close (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT XMF_Reset (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT XMF_Pause (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT XMF_Resume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData);
+static EAS_RESULT XMF_Locate (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 time, EAS_BOOL *pParserLocate);
 static EAS_RESULT XMF_SetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
 static EAS_RESULT XMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
 static EAS_RESULT XMF_FindFileContents (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData);
@@ -94,7 +95,7 @@ const S_FILE_PARSER_INTERFACE EAS_XMF_Parser =
     NULL,
     NULL,
 #endif
-    NULL,
+    XMF_Locate,
     XMF_SetData,
     XMF_GetData,
     NULL
@@ -432,6 +433,30 @@ static EAS_RESULT XMF_Resume (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
 }
 #endif
 
+/*----------------------------------------------------------------------------
+ * XMF_Locate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Locates in the underlying SMF file using its checkpoints
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * handle           - pointer to file handle
+ * time             - requested time in milliseconds
+ * pParserLocate    - set to EAS_TRUE if the generic locate must be used
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT XMF_Locate (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS_I32 time, EAS_BOOL *pParserLocate)
+{
+    return SMF_Locate(pEASData, ((S_XMF_DATA*) pInstData)->pSMFData, time, pParserLocate);
+}
+
 /*----------------------------------------------------------------------------
  * XMF_SetData()
  *----------------------------------------------------------------------------
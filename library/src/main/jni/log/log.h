@@ -38,6 +38,8 @@
 
 #include <android/log.h>
 
+#include "eas_rtcheck.h"
+
 /* for C++ linkage */
 #ifdef __cplusplus
 extern "C"
@@ -45,8 +47,15 @@ extern "C"
 #endif
 
 // ALOGE("b/68953854 SMF_ParseMetaEvent, negative len = %ld\n", (EAS_I32) len);
-#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, "MidiDriver", __VA_ARGS__)
-#define ALOGW(...) __android_log_print(ANDROID_LOG_WARN, "MidiDriver", __VA_ARGS__)
+#define ALOGE(...) (EAS_RT_CHECK("ALOGE"), __android_log_print(ANDROID_LOG_ERROR, "MidiDriver", __VA_ARGS__))
+#define ALOGW(...) (EAS_RT_CHECK("ALOGW"), __android_log_print(ANDROID_LOG_WARN, "MidiDriver", __VA_ARGS__))
+
+// render thread versions, queued and formatted by the log thread in
+// eas_report.c, the arguments are passed as long
+// ALOGE_RT("b/317780080 clip numSamples %ld -> %ld", numSamples, max);
+void EAS_LogAsync(int prio, const char *fmt, long arg1, long arg2);
+#define ALOGE_RT(fmt, a, b) EAS_LogAsync(ANDROID_LOG_ERROR, fmt, (long) (a), (long) (b))
+#define ALOGW_RT(fmt, a, b) EAS_LogAsync(ANDROID_LOG_WARN, fmt, (long) (a), (long) (b))
 
 // android_errorWriteLog(0x534e4554, "34031018");
 #define android_errorWriteLog(a, b) ALOGE(b)
@@ -24,6 +24,7 @@
 #include <assert.h>
 
 #include <atomic>
+#include <cstdint>
 
 #include <android/log.h>
 
@@ -38,6 +39,9 @@
 // for EAS_HWMemCpy
 #include "eas_host.h"
 
+// for EAS_LogAsync, safe on the render thread, and EAS_LogWake
+#include "eas_report.h"
+
 #include "org_billthefarmer_mididriver_MidiDriver.h"
 #include "midi.h"
 
@@ -60,7 +64,7 @@ typedef struct
 // mutex
 static std::atomic_flag mutex = ATOMIC_FLAG_INIT;
 
-#define LOCK() while (mutex.test_and_set(std::memory_order_acquire));
+#define LOCK() EAS_RT_CHECK("LOCK"); while (mutex.test_and_set(std::memory_order_acquire));
 #define UNLOCK() mutex.clear(std::memory_order_release);
 
 // oboe stream
@@ -73,9 +77,115 @@ static EAS_I32 bufferSize;
 static EAS_HANDLE midiHandle;
 static int isDLSLoaded;
 
+// typed event queue, written by any thread and applied by the
+// render thread before each EAS buffer, size must be a power of two
+#define EVENT_QUEUE_SIZE 1024
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+static S_EAS_MIDI_EVENT eventQueue[EVENT_QUEUE_SIZE];
+static std::atomic<uint32_t> eventHead(0);
+static std::atomic<uint32_t> eventTail(0);
+
+// serialises writers to the event queue, never taken by the render thread
+static std::atomic_flag queueMutex = ATOMIC_FLAG_INIT;
+
+#define QUEUE_LOCK() EAS_RT_CHECK("QUEUE_LOCK"); while (queueMutex.test_and_set(std::memory_order_acquire));
+#define QUEUE_UNLOCK() queueMutex.clear(std::memory_order_release);
+
+// idle timeout, in frames, 0 to disable
+static std::atomic<int> idleTimeout(0);
+static std::atomic<bool> isIdleStopped(false);
+static int idleFrames;
+
+// ask oboe for a float stream, used when the stream is next opened
+static std::atomic<bool> floatOutput(false);
+
 // Functions
 oboe::Result initOboe();
 oboe::Result closeOboe();
+void restartIfIdle();
+
+// apply queued typed events, called with the EAS lock held by the
+// render thread, and by the byte writers so events stay in order
+static void applyEvents()
+{
+    EAS_RESULT result;
+    uint32_t head = eventHead.load(std::memory_order_relaxed);
+    uint32_t tail = eventTail.load(std::memory_order_acquire);
+
+    while (head != tail)
+    {
+        // apply contiguous runs up to the end of the queue
+        uint32_t index = head & EVENT_QUEUE_MASK;
+        uint32_t count = tail - head;
+
+        if (count > EVENT_QUEUE_SIZE - index)
+            count = EVENT_QUEUE_SIZE - index;
+
+        // events after a failed one in the run are dropped
+        result = EAS_WriteMIDIEvents(pEASData, midiHandle, &eventQueue[index],
+                                     (EAS_I32) count);
+        if (result != EAS_SUCCESS)
+            EAS_LogAsync(ANDROID_LOG_ERROR, "Write EAS events failed: %ld",
+                         result, 0);
+        head += count;
+    }
+
+    eventHead.store(head, std::memory_order_release);
+}
+
+// reserve space for count events, returns false if the queue is
+// full, otherwise the queue lock is held until commitEvents
+static bool reserveEvents(jint count, uint32_t *tail)
+{
+    uint32_t head;
+
+    if (count <= 0 || count > EVENT_QUEUE_SIZE)
+        return false;
+
+    QUEUE_LOCK();
+
+    head = eventHead.load(std::memory_order_acquire);
+    *tail = eventTail.load(std::memory_order_relaxed);
+
+    if (EVENT_QUEUE_SIZE - (*tail - head) < (uint32_t) count)
+    {
+        QUEUE_UNLOCK();
+        return false;
+    }
+
+    return true;
+}
+
+// publish reserved events to the render thread
+static void commitEvents(jint count, uint32_t tail)
+{
+    eventTail.store(tail + count, std::memory_order_release);
+
+    QUEUE_UNLOCK();
+
+    // output anything the render thread has logged without waiting for
+    // the log thread's period, the render thread must not wake it
+    EAS_LogWake();
+
+    restartIfIdle();
+}
+
+// set a reserved event
+static inline void setEvent(uint32_t index, int status, int data1, int data2)
+{
+    S_EAS_MIDI_EVENT *event = &eventQueue[index & EVENT_QUEUE_MASK];
+
+    event->status = (EAS_U8) status;
+    event->data1 = (EAS_U8) data1;
+    event->data2 = (EAS_U8) data2;
+}
+
+// check channel and data ranges
+static inline bool isValid(jint channel, jint data1, jint data2)
+{
+    return ((channel | data1 | data2) & ~0x7f) == 0 && channel < 16;
+}
 
 // oboe callback
 class OboeCallback: public oboe::AudioStreamDataCallback
@@ -87,9 +197,37 @@ public:
         EAS_RESULT result;
         EAS_I32 numGenerated;
         EAS_I32 count = 0;
+        EAS_BOOL idle;
+
+        // Float is only requested by midi_setFloatOutput, and older
+        // devices may open the stream as I16, so render whichever we got.
+        if (audioStream->getFormat() == oboe::AudioFormat::Float)
+        {
+            auto *outputData = static_cast<float *>(audioData);
+
+            while (count < bufferSize)
+            {
+                // lock
+                LOCK();
+
+                applyEvents();
+                result = EAS_RenderFloat(pEASData, outputData + count,
+                                         pLibConfig->mixBufferSize,
+                                         &numGenerated);
+                EAS_GetIdle(pEASData, &idle);
+
+                // unlock
+                UNLOCK();
+
+                assert(result == EAS_SUCCESS);
+
+                count += numGenerated * pLibConfig->numChannels;
+                idleFrames = idle? idleFrames + numGenerated: 0;
+            }
+
+            return checkIdle();
+        }
 
-        // We requested AudioFormat::I16. So if the stream opens
-        // we know we got the I16 format.
         auto *outputData = static_cast<int16_t *>(audioData);
 
         while (count < bufferSize)
@@ -97,14 +235,34 @@ public:
             // lock
             LOCK();
 
+            applyEvents();
             result = EAS_Render(pEASData, outputData + count,
                                 pLibConfig->mixBufferSize, &numGenerated);
+            EAS_GetIdle(pEASData, &idle);
+
             // unlock
             UNLOCK();
 
             assert(result == EAS_SUCCESS);
 
             count += numGenerated * pLibConfig->numChannels;
+            idleFrames = idle? idleFrames + numGenerated: 0;
+        }
+
+        return checkIdle();
+    }
+
+    // Stop the stream if it has been silent for longer than the
+    // idle timeout, midi_write will restart it
+    oboe::DataCallbackResult checkIdle()
+    {
+        int timeout = idleTimeout.load();
+
+        if (timeout > 0 && idleFrames >= timeout)
+        {
+            idleFrames = 0;
+            isIdleStopped.store(true);
+            return oboe::DataCallbackResult::Stop;
         }
 
         return oboe::DataCallbackResult::Continue;
@@ -130,7 +288,8 @@ oboe::Result buildOboe()
     builder.setSampleRateConversionQuality(
         oboe::SampleRateConversionQuality::Medium);
     builder.setSharingMode(oboe::SharingMode::Exclusive);
-    builder.setFormat(oboe::AudioFormat::I16);
+    builder.setFormat(floatOutput.load()? oboe::AudioFormat::Float:
+                      oboe::AudioFormat::I16);
     builder.setFramesPerCallback(bufferSize / pLibConfig->numChannels);
     builder.setChannelCount(pLibConfig->numChannels);
     builder.setSampleRate(pLibConfig->sampleRate);
@@ -143,6 +302,9 @@ oboe::Result initOboe()
 {
     oboe::Result oboeResult;
 
+    isIdleStopped.store(false);
+    idleFrames = 0;
+
     if ((oboeResult = buildOboe()) != oboe::Result::OK)
     {
         LOG_E(LOG_TAG, "Failed to create oboe stream. Error: %s",
@@ -203,6 +365,9 @@ EAS_RESULT initEAS()
     if ((result = EAS_OpenMIDIStream(pEASData, &midiHandle, NULL)) != EAS_SUCCESS)
         return result;
 
+    // discard any events queued before init
+    eventHead.store(eventTail.load());
+
     isDLSLoaded = 0;
 
     return EAS_SUCCESS;
@@ -296,17 +461,35 @@ jboolean midi_write(EAS_U8 *bytes, jint length)
     // lock
     LOCK();
 
+    // typed events queued before this write go first
+    applyEvents();
     result = EAS_WriteMIDIStream(pEASData, midiHandle, bytes, length);
 
     // unlock
     UNLOCK();
 
+    // output anything the render thread has logged
+    EAS_LogWake();
+
+    restartIfIdle();
+
     if (result != EAS_SUCCESS)
         return JNI_FALSE;
 
     return JNI_TRUE;
 }
 
+// restart the stream if it was stopped while idle, called after each
+// write
+void restartIfIdle()
+{
+    if (isIdleStopped.exchange(false) && oboeStream != NULL)
+    {
+        oboeStream->stop();
+        oboeStream->requestStart();
+    }
+}
+
 jboolean
 Java_org_billthefarmer_mididriver_MidiDriver_write(JNIEnv *env,
                                                    jobject obj,
@@ -318,6 +501,9 @@ Java_org_billthefarmer_mididriver_MidiDriver_write(JNIEnv *env,
     EAS_U8 *bytes;
 
     bytes = (EAS_U8 *) env->GetByteArrayElements(byteArray, &isCopy);
+    if (bytes == NULL)
+        return JNI_FALSE;
+
     length = env->GetArrayLength(byteArray);
 
     result = midi_write(bytes, length);
@@ -327,6 +513,294 @@ Java_org_billthefarmer_mididriver_MidiDriver_write(JNIEnv *env,
     return result;
 }
 
+// write universal midi packets
+jboolean midi_writeUMP(const EAS_UMP_WORD *words, jint count)
+{
+    EAS_RESULT result;
+
+    if (pEASData == NULL || midiHandle == NULL)
+        return JNI_FALSE;
+
+    // lock
+    LOCK();
+
+    // typed events queued before this write go first
+    applyEvents();
+    result = EAS_WriteUMPStream(pEASData, midiHandle, words, count);
+
+    // unlock
+    UNLOCK();
+
+    // output anything the render thread has logged
+    EAS_LogWake();
+
+    restartIfIdle();
+
+    if (result != EAS_SUCCESS)
+        return JNI_FALSE;
+
+    return JNI_TRUE;
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_writeUMP(JNIEnv *env,
+                                                      jobject obj,
+                                                      jintArray wordArray)
+{
+    jboolean result;
+    jint length;
+    jint *words;
+
+    words = env->GetIntArrayElements(wordArray, NULL);
+    if (words == NULL)
+        return JNI_FALSE;
+
+    length = env->GetArrayLength(wordArray);
+
+    result = midi_writeUMP((const EAS_UMP_WORD *) words, length);
+
+    env->ReleaseIntArrayElements(wordArray, words, JNI_ABORT);
+
+    return result;
+}
+
+// queue a single channel message
+static jboolean queueEvent(int status, jint channel, jint data1, jint data2)
+{
+    uint32_t tail;
+
+    if (pEASData == NULL || midiHandle == NULL ||
+        !isValid(channel, data1, data2))
+        return JNI_FALSE;
+
+    if (!reserveEvents(1, &tail))
+        return JNI_FALSE;
+
+    setEvent(tail, status | channel, data1, data2);
+    commitEvents(1, tail);
+
+    return JNI_TRUE;
+}
+
+// note on
+jboolean midi_noteOn(jint channel, jint note, jint velocity)
+{
+    return queueEvent(0x90, channel, note, velocity);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_noteOn(JNIEnv *env,
+                                                    jobject obj,
+                                                    jint channel,
+                                                    jint note,
+                                                    jint velocity)
+{
+    return midi_noteOn(channel, note, velocity);
+}
+
+// note off
+jboolean midi_noteOff(jint channel, jint note, jint velocity)
+{
+    return queueEvent(0x80, channel, note, velocity);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_noteOff(JNIEnv *env,
+                                                     jobject obj,
+                                                     jint channel,
+                                                     jint note,
+                                                     jint velocity)
+{
+    return midi_noteOff(channel, note, velocity);
+}
+
+// control change
+jboolean midi_controlChange(jint channel, jint controller, jint value)
+{
+    return queueEvent(0xb0, channel, controller, value);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_controlChange(JNIEnv *env,
+                                                           jobject obj,
+                                                           jint channel,
+                                                           jint controller,
+                                                           jint value)
+{
+    return midi_controlChange(channel, controller, value);
+}
+
+// pitch bend, value between 0 and 16383, 8192 is centre
+jboolean midi_pitchBend(jint channel, jint value)
+{
+    if (value < 0 || value > 0x3fff)
+        return JNI_FALSE;
+
+    return queueEvent(0xe0, channel, value & 0x7f, value >> 7);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_pitchBend(JNIEnv *env,
+                                                       jobject obj,
+                                                       jint channel,
+                                                       jint value)
+{
+    return midi_pitchBend(channel, value);
+}
+
+// program change
+jboolean midi_programChange(jint channel, jint program)
+{
+    return queueEvent(0xc0, channel, program, 0);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_programChange(JNIEnv *env,
+                                                           jobject obj,
+                                                           jint channel,
+                                                           jint program)
+{
+    return midi_programChange(channel, program);
+}
+
+// queue an array of channel messages with the same status
+static jboolean queueEvents(int status, jint channel, const jint *data1,
+                            const jint *data2, jint data, jint count)
+{
+    uint32_t tail;
+    jint i;
+
+    if (pEASData == NULL || midiHandle == NULL)
+        return JNI_FALSE;
+
+    // check everything first, the batch is queued whole or not at all
+    for (i = 0; i < count; i++)
+        if (!isValid(channel, data1[i], data2? data2[i]: data))
+            return JNI_FALSE;
+
+    if (!reserveEvents(count, &tail))
+        return JNI_FALSE;
+
+    for (i = 0; i < count; i++)
+        setEvent(tail + i, status | channel, data1[i],
+                 data2? data2[i]: data);
+
+    commitEvents(count, tail);
+
+    return JNI_TRUE;
+}
+
+// note on batch
+jboolean midi_noteOnBatch(jint channel, const jint *notes,
+                          const jint *velocities, jint count)
+{
+    return queueEvents(0x90, channel, notes, velocities, 0, count);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_noteOnBatch(JNIEnv *env,
+                                                         jobject obj,
+                                                         jint channel,
+                                                         jintArray noteArray,
+                                                         jintArray velocityArray)
+{
+    jboolean result;
+    jint length;
+    jint *notes;
+    jint *velocities;
+
+    length = env->GetArrayLength(noteArray);
+    if (env->GetArrayLength(velocityArray) != length)
+        return JNI_FALSE;
+
+    notes = env->GetIntArrayElements(noteArray, NULL);
+    if (notes == NULL)
+        return JNI_FALSE;
+
+    velocities = env->GetIntArrayElements(velocityArray, NULL);
+    if (velocities == NULL)
+    {
+        env->ReleaseIntArrayElements(noteArray, notes, JNI_ABORT);
+        return JNI_FALSE;
+    }
+
+    result = midi_noteOnBatch(channel, notes, velocities, length);
+
+    env->ReleaseIntArrayElements(velocityArray, velocities, JNI_ABORT);
+    env->ReleaseIntArrayElements(noteArray, notes, JNI_ABORT);
+
+    return result;
+}
+
+// note off batch
+jboolean midi_noteOffBatch(jint channel, const jint *notes, jint count)
+{
+    return queueEvents(0x80, channel, notes, NULL, 0, count);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_noteOffBatch(JNIEnv *env,
+                                                          jobject obj,
+                                                          jint channel,
+                                                          jintArray noteArray)
+{
+    jboolean result;
+    jint *notes;
+
+    notes = env->GetIntArrayElements(noteArray, NULL);
+    if (notes == NULL)
+        return JNI_FALSE;
+
+    result = midi_noteOffBatch(channel, notes,
+                               env->GetArrayLength(noteArray));
+
+    env->ReleaseIntArrayElements(noteArray, notes, JNI_ABORT);
+
+    return result;
+}
+
+// control change batch
+jboolean midi_controlChangeBatch(jint channel, const jint *controllers,
+                                 const jint *values, jint count)
+{
+    return queueEvents(0xb0, channel, controllers, values, 0, count);
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_controlChangeBatch(JNIEnv *env,
+                                                                jobject obj,
+                                                                jint channel,
+                                                                jintArray controllerArray,
+                                                                jintArray valueArray)
+{
+    jboolean result;
+    jint length;
+    jint *controllers;
+    jint *values;
+
+    length = env->GetArrayLength(controllerArray);
+    if (env->GetArrayLength(valueArray) != length)
+        return JNI_FALSE;
+
+    controllers = env->GetIntArrayElements(controllerArray, NULL);
+    if (controllers == NULL)
+        return JNI_FALSE;
+
+    values = env->GetIntArrayElements(valueArray, NULL);
+    if (values == NULL)
+    {
+        env->ReleaseIntArrayElements(controllerArray, controllers, JNI_ABORT);
+        return JNI_FALSE;
+    }
+
+    result = midi_controlChangeBatch(channel, controllers, values, length);
+
+    env->ReleaseIntArrayElements(valueArray, values, JNI_ABORT);
+    env->ReleaseIntArrayElements(controllerArray, controllers, JNI_ABORT);
+
+    return result;
+}
+
 // set EAS master volume
 jboolean midi_setVolume(jint volume)
 {
@@ -397,6 +871,72 @@ Java_org_billthefarmer_mididriver_MidiDriver_setReverb(JNIEnv *env,
     return midi_setReverb(preset);
 }
 
+// set idle timeout
+jboolean midi_setIdleTimeout(jint seconds)
+{
+    if (pLibConfig == NULL || seconds < 0)
+        return JNI_FALSE;
+
+    idleTimeout.store(seconds * pLibConfig->sampleRate);
+
+    return JNI_TRUE;
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_setIdleTimeout(JNIEnv *env,
+                                                            jobject obj,
+                                                            jint seconds)
+{
+    return midi_setIdleTimeout(seconds);
+}
+
+// enable or disable controller coalescing
+jboolean midi_setCoalescing(jboolean enable)
+{
+    EAS_RESULT result;
+
+    if (pEASData == NULL || midiHandle == NULL)
+        return JNI_FALSE;
+
+    // lock
+    LOCK();
+
+    result = EAS_SetMIDIStreamCoalescing(pEASData, midiHandle,
+                                         enable? EAS_TRUE: EAS_FALSE);
+
+    // unlock
+    UNLOCK();
+
+    if (result != EAS_SUCCESS)
+        return JNI_FALSE;
+
+    return JNI_TRUE;
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_setCoalescing(JNIEnv *env,
+                                                           jobject obj,
+                                                           jboolean enable)
+{
+    return midi_setCoalescing(enable);
+}
+
+// request float output, takes effect when the stream is next opened
+jboolean midi_setFloatOutput(jboolean enable)
+{
+    floatOutput.store(enable);
+
+    return JNI_TRUE;
+}
+
+jboolean
+Java_org_billthefarmer_mididriver_MidiDriver_setFloatOutput(JNIEnv *env,
+                                                            jobject obj,
+                                                            jboolean enable)
+{
+    return midi_setFloatOutput(enable);
+}
+
 // shutdown EAS midi
 jboolean midi_shutdown()
 {
@@ -38,12 +38,38 @@ jboolean midi_init();
 // midi write
 jboolean midi_write(EAS_U8 *bytes, jint length);
 
+// write universal midi packets, count is in 32-bit words
+jboolean midi_writeUMP(const EAS_UMP_WORD *words, jint count);
+
+// typed events, queued and applied before the next audio buffer
+jboolean midi_noteOn(jint channel, jint note, jint velocity);
+jboolean midi_noteOff(jint channel, jint note, jint velocity);
+jboolean midi_controlChange(jint channel, jint controller, jint value);
+jboolean midi_pitchBend(jint channel, jint value);
+jboolean midi_programChange(jint channel, jint program);
+
+// batched typed events, queued whole or not at all
+jboolean midi_noteOnBatch(jint channel, const jint *notes,
+                          const jint *velocities, jint count);
+jboolean midi_noteOffBatch(jint channel, const jint *notes, jint count);
+jboolean midi_controlChangeBatch(jint channel, const jint *controllers,
+                                 const jint *values, jint count);
+
 // set EAS master volume
 jboolean midi_setVolume(jint volume);
 
 // set EAS reverb preset
 jboolean midi_setReverb(jint preset);
 
+// set idle timeout in seconds, 0 to disable
+jboolean midi_setIdleTimeout(jint seconds);
+
+// enable or disable controller coalescing
+jboolean midi_setCoalescing(jboolean enable);
+
+// request float output, takes effect when the stream is next opened
+jboolean midi_setFloatOutput(jboolean enable);
+
 // shutdown EAS midi
 jboolean midi_shutdown();
 
@@ -32,6 +32,78 @@ JNIEXPORT jintArray JNICALL Java_org_billthefarmer_mididriver_MidiDriver_config
 JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_write
         (JNIEnv *, jobject, jbyteArray);
 
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    writeUMP
+ * Signature: ([I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_writeUMP
+        (JNIEnv *, jobject, jintArray);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    noteOn
+ * Signature: (III)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_noteOn
+        (JNIEnv *, jobject, jint, jint, jint);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    noteOff
+ * Signature: (III)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_noteOff
+        (JNIEnv *, jobject, jint, jint, jint);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    controlChange
+ * Signature: (III)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_controlChange
+        (JNIEnv *, jobject, jint, jint, jint);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    pitchBend
+ * Signature: (II)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_pitchBend
+        (JNIEnv *, jobject, jint, jint);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    programChange
+ * Signature: (II)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_programChange
+        (JNIEnv *, jobject, jint, jint);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    noteOnBatch
+ * Signature: (I[I[I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_noteOnBatch
+        (JNIEnv *, jobject, jint, jintArray, jintArray);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    noteOffBatch
+ * Signature: (I[I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_noteOffBatch
+        (JNIEnv *, jobject, jint, jintArray);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    controlChangeBatch
+ * Signature: (I[I[I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_controlChangeBatch
+        (JNIEnv *, jobject, jint, jintArray, jintArray);
+
 /*
  * Class:     org_billthefarmer_mididriver_MidiDriver
  * Method:    setVolume
@@ -48,6 +120,30 @@ JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_setVolum
 JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_setReverb
         (JNIEnv *, jobject, jint);
 
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    setIdleTimeout
+ * Signature: (I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_setIdleTimeout
+        (JNIEnv *, jobject, jint);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    setCoalescing
+ * Signature: (Z)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_setCoalescing
+        (JNIEnv *, jobject, jboolean);
+
+/*
+ * Class:     org_billthefarmer_mididriver_MidiDriver
+ * Method:    setFloatOutput
+ * Signature: (Z)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_billthefarmer_mididriver_MidiDriver_setFloatOutput
+        (JNIEnv *, jobject, jboolean);
+
 
 /*
  * Class:     org_billthefarmer_mididriver_MidiDriver
@@ -0,0 +1,66 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * android_log.c
+ *
+ * Contents and purpose:
+ * Host versions of the NDK log functions used by the library. Errors
+ * and warnings go to stderr, the rest is dropped.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include "android/log.h"
+
+/*----------------------------------------------------------------------------
+ * __android_log_vprint()
+ *----------------------------------------------------------------------------
+*/
+int __android_log_vprint (int prio, const char *tag, const char *fmt, va_list ap)
+{
+    if (prio < ANDROID_LOG_WARN)
+        return 0;
+    fprintf(stderr, "%s: ", tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * __android_log_print()
+ *----------------------------------------------------------------------------
+*/
+int __android_log_print (int prio, const char *tag, const char *fmt, ...)
+{
+    va_list ap;
+    int result;
+
+    va_start(ap, fmt);
+    result = __android_log_vprint(prio, tag, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * __android_log_write()
+ *----------------------------------------------------------------------------
+*/
+int __android_log_write (int prio, const char *tag, const char *text)
+{
+    return __android_log_print(prio, tag, "%s", text);
+}
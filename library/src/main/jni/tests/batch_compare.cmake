@@ -0,0 +1,38 @@
+# Renders copies of a MIDI file with eas_batch on one thread and on two
+# and checks that every WAV file is the same. Run by ctest as
+#
+#   cmake -DBATCH=eas_batch -DMIDI=file.mid -DDIR=workdir -P batch_compare.cmake
+
+set(copies 4)
+
+file(REMOVE_RECURSE ${DIR})
+file(MAKE_DIRECTORY ${DIR}/j1 ${DIR}/j2)
+set(inputs)
+foreach(i RANGE 1 ${copies})
+  configure_file(${MIDI} ${DIR}/song${i}.mid COPYONLY)
+  list(APPEND inputs ${DIR}/song${i}.mid)
+endforeach()
+
+foreach(threads 1 2)
+  execute_process(COMMAND ${BATCH} -j ${threads} -o ${DIR}/j${threads} ${inputs}
+    RESULT_VARIABLE result OUTPUT_VARIABLE output)
+  message("${output}")
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "eas_batch -j ${threads} failed")
+  endif()
+  if(NOT output MATCHES " ${threads} threads")
+    message(FATAL_ERROR "eas_batch -j ${threads} did not run ${threads} threads")
+  endif()
+endforeach()
+
+foreach(i RANGE 1 ${copies})
+  file(SIZE ${DIR}/j1/song${i}.wav size)
+  if(size LESS 1024)
+    message(FATAL_ERROR "song${i}.wav is ${size} bytes")
+  endif()
+  execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+    ${DIR}/j1/song${i}.wav ${DIR}/j2/song${i}.wav RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "song${i}.wav differs between -j 1 and -j 2")
+  endif()
+endforeach()
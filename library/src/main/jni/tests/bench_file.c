@@ -0,0 +1,247 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * bench_file.c
+ *
+ * Contents and purpose:
+ * Benchmark of file reads through the read-ahead block of each file
+ * handle in eas_hostmm.c. Loads a generated DLS collection and opens,
+ * prepares and parses the metadata of MIDI files, reading from memory
+ * and with pread from a file, as the locators of the JNI library do.
+ * Prints the time and the number of locator reads of each operation.
+ *
+ * bench_file [MIDI file] [seconds per test]
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "eas_test.h"
+
+#define BENCH_SMF_SIZE          (256 * 1024)
+
+/* file read through the locator, from memory or with pread */
+typedef struct
+{
+    S_EAS_TEST_FILE     file;
+    int                 fd;
+    EAS_I32             numReads;
+} S_BENCH_FILE;
+
+
+/*----------------------------------------------------------------------------
+ * Locator callbacks
+ *----------------------------------------------------------------------------
+*/
+static int MemoryReadAt (void *handle, void *buf, int offset, int size)
+{
+    S_BENCH_FILE *pFile = handle;
+
+    pFile->numReads++;
+    if ((offset < 0) || (offset >= pFile->file.size))
+        return 0;
+    if (size > pFile->file.size - offset)
+        size = pFile->file.size - offset;
+    memcpy(buf, pFile->file.pData + offset, (size_t) size);
+    return size;
+}
+
+static int PreadReadAt (void *handle, void *buf, int offset, int size)
+{
+    S_BENCH_FILE *pFile = handle;
+    ssize_t count;
+
+    pFile->numReads++;
+    count = pread(pFile->fd, buf, (size_t) size, offset);
+    return (count < 0) ? 0 : (int) count;
+}
+
+static int BenchSize (void *handle)
+{
+    return ((S_BENCH_FILE*) handle)->file.size;
+}
+
+/*----------------------------------------------------------------------------
+ * BenchOpenFile()
+ *----------------------------------------------------------------------------
+ * Sets up a locator for data in memory, or written to a temporary file
+ * and read with pread if usePread is set
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL BenchOpenFile (S_BENCH_FILE *pFile, EAS_U8 *pData, EAS_I32 size, EAS_BOOL usePread)
+{
+    char path[] = "/tmp/bench_fileXXXXXX";
+
+    EAS_TestMemoryFile(&pFile->file, pData, size);
+    pFile->file.locator.handle = pFile;
+    pFile->file.locator.readAt = MemoryReadAt;
+    pFile->file.locator.size = BenchSize;
+    pFile->fd = -1;
+    pFile->numReads = 0;
+    if (!usePread)
+        return EAS_TRUE;
+
+    if ((pFile->fd = mkstemp(path)) < 0)
+        return EAS_FALSE;
+    unlink(path);
+    if (write(pFile->fd, pData, (size_t) size) != size)
+    {
+        close(pFile->fd);
+        return EAS_FALSE;
+    }
+    pFile->file.locator.readAt = PreadReadAt;
+    return EAS_TRUE;
+}
+
+static void BenchCloseFile (S_BENCH_FILE *pFile)
+{
+    if (pFile->fd >= 0)
+        close(pFile->fd);
+}
+
+/*----------------------------------------------------------------------------
+ * LoadDLS()
+ *----------------------------------------------------------------------------
+ * Loads the collection as the global DLS collection
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT LoadDLS (EAS_DATA_HANDLE pEASData, S_BENCH_FILE *pFile)
+{
+    return EAS_LoadDLSCollection(pEASData, NULL, &pFile->file.locator);
+}
+
+/*----------------------------------------------------------------------------
+ * OpenSMF()
+ *----------------------------------------------------------------------------
+ * Opens, prepares and parses the metadata of a MIDI file, then closes it
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT OpenSMF (EAS_DATA_HANDLE pEASData, S_BENCH_FILE *pFile)
+{
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_I32 length;
+
+    if ((result = EAS_OpenFile(pEASData, &pFile->file.locator, &stream)) != EAS_SUCCESS)
+        return result;
+    if ((result = EAS_Prepare(pEASData, stream)) == EAS_SUCCESS)
+        result = EAS_ParseMetaData(pEASData, stream, &length);
+    EAS_CloseFile(pEASData, stream);
+    return result;
+}
+
+/*----------------------------------------------------------------------------
+ * Bench()
+ *----------------------------------------------------------------------------
+ * Prints the best time and the locator reads of one operation on one
+ * file, read from memory and with pread
+ *----------------------------------------------------------------------------
+*/
+static void Bench (EAS_DATA_HANDLE pEASData, const char *pName, EAS_U8 *pData, EAS_I32 size,
+    EAS_RESULT (*pOperation)(EAS_DATA_HANDLE pEASData, S_BENCH_FILE *pFile), double seconds)
+{
+    S_BENCH_FILE file;
+    EAS_RESULT result;
+    EAS_INT usePread;
+    EAS_I32 passes;
+    double start;
+    double elapsed;
+    double best;
+    double total;
+
+    for (usePread = 0; usePread < 2; usePread++)
+    {
+        if (!BenchOpenFile(&file, pData, size, (EAS_BOOL) usePread))
+        {
+            fprintf(stderr, "Cannot write a temporary file\n");
+            return;
+        }
+        best = 0;
+        total = 0;
+        passes = 0;
+        do
+        {
+            start = EAS_TestSeconds();
+            result = pOperation(pEASData, &file);
+            elapsed = EAS_TestSeconds() - start;
+            if (result != EAS_SUCCESS)
+            {
+                fprintf(stderr, "%s failed %ld\n", pName, (long) result);
+                BenchCloseFile(&file);
+                return;
+            }
+            if ((best == 0) || (elapsed < best))
+                best = elapsed;
+            total += elapsed;
+            passes++;
+        } while (total < seconds);
+
+        printf("%-10s %8d bytes %-6s %8.3f ms %8ld reads\n", pName, (int) size,
+            usePread ? "pread" : "memcpy", best * 1e3, (long) (file.numReads / passes));
+        BenchCloseFile(&file);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    static EAS_U8 dls[EAS_TEST_DLS_SIZE];
+    static EAS_U8 smf[BENCH_SMF_SIZE];
+    S_EAS_TEST_FILE midi;
+    EAS_DATA_HANDLE pEASData;
+    EAS_I32 dlsSize;
+    EAS_I32 smfSize;
+    double seconds;
+
+    seconds = (argc > 2) ? atof(argv[2]) : 0.5;
+    if ((dlsSize = EAS_TestMakeDLS(dls, EAS_TEST_DLS_SIZE, 0)) == 0)
+    {
+        fprintf(stderr, "DLS collection too large\n");
+        return 1;
+    }
+    if ((smfSize = EAS_TestMakeSMF(smf, BENCH_SMF_SIZE, 1, 15, 1000)) == 0)
+    {
+        fprintf(stderr, "MIDI file too large\n");
+        return 1;
+    }
+    if ((pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) == NULL)
+        return 1;
+
+    printf("best pass, locator reads per pass\n");
+    Bench(pEASData, "dls", dls, dlsSize, LoadDLS, seconds);
+    Bench(pEASData, "smf", smf, smfSize, OpenSMF, seconds);
+    if (argc > 1)
+    {
+        if (!EAS_TestLoadFile(argv[1], &midi))
+        {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            EAS_Shutdown(pEASData);
+            return 1;
+        }
+        Bench(pEASData, "file", midi.pData, midi.size, OpenSMF, seconds);
+        free(midi.pData);
+    }
+    EAS_Shutdown(pEASData);
+    return 0;
+}
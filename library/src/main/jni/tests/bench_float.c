@@ -0,0 +1,170 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * bench_float.c
+ *
+ * Contents and purpose:
+ * Benchmark of the float output. Renders a MIDI file with EAS_Render,
+ * with EAS_Render followed by a conversion to float, as an audio
+ * callback feeding a float stream from the 16-bit output would, and
+ * with EAS_RenderFloat. Prints the time per buffer of the best pass.
+ * Plays a generated file unless one is given.
+ *
+ * bench_float [MIDI file] [seconds per test]
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+
+#define BENCH_SMF_SIZE          (256 * 1024)
+
+/* output of the render under test */
+typedef enum
+{
+    eBenchPCM,
+    eBenchConvert,
+    eBenchFloat
+} E_BENCH_OUTPUT;
+
+static const char * const outputNames[] = { "16-bit", "convert", "float" };
+
+/*----------------------------------------------------------------------------
+ * Render()
+ *----------------------------------------------------------------------------
+ * Plays the file to the end and returns the render time, not counting
+ * opening the file. pNumBuffers receives the number of buffers.
+ *----------------------------------------------------------------------------
+*/
+static double Render (EAS_DATA_HANDLE pEASData, S_EAS_TEST_FILE *pFile, E_BENCH_OUTPUT output, EAS_I32 *pNumBuffers)
+{
+    static EAS_PCM pcm[1024];
+    static EAS_FLOAT buffer[1024];
+    const S_EAS_LIB_CONFIG *pConfig;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_STATE state;
+    EAS_I32 numGenerated;
+    EAS_I32 i;
+    double start;
+
+    pConfig = EAS_Config();
+    *pNumBuffers = 0;
+    if (EAS_TestOpen(pEASData, pFile, EAS_FALSE, &stream) != EAS_SUCCESS)
+        return 0;
+
+    start = EAS_TestSeconds();
+    do
+    {
+        if (output == eBenchFloat)
+            result = EAS_RenderFloat(pEASData, buffer, pConfig->mixBufferSize, &numGenerated);
+        else
+            result = EAS_Render(pEASData, pcm, pConfig->mixBufferSize, &numGenerated);
+        if (result != EAS_SUCCESS)
+            break;
+        if (output == eBenchConvert)
+        {
+            for (i = 0; i < numGenerated * pConfig->numChannels; i++)
+                buffer[i] = (EAS_FLOAT) pcm[i] * (1.0f / 32768.0f);
+        }
+        (*pNumBuffers)++;
+    } while ((EAS_State(pEASData, stream, &state) == EAS_SUCCESS) && (state != EAS_STATE_STOPPED));
+    start = EAS_TestSeconds() - start;
+
+    EAS_CloseFile(pEASData, stream);
+    return start;
+}
+
+/*----------------------------------------------------------------------------
+ * Bench()
+ *----------------------------------------------------------------------------
+ * Prints the time per buffer of the best pass of one output
+ *----------------------------------------------------------------------------
+*/
+static void Bench (S_EAS_TEST_FILE *pFile, E_BENCH_OUTPUT output, double seconds)
+{
+    EAS_DATA_HANDLE pEASData;
+    EAS_I32 numBuffers;
+    double total;
+    double best;
+    double elapsed;
+
+    if ((pEASData = EAS_TestInit(EAS_PARAM_REVERB_CHAMBER)) == NULL)
+        return;
+    best = 0;
+    total = 0;
+    do
+    {
+        elapsed = Render(pEASData, pFile, output, &numBuffers);
+        if (numBuffers == 0)
+        {
+            fprintf(stderr, "Cannot play the file\n");
+            break;
+        }
+        if ((best == 0) || (elapsed < best))
+            best = elapsed;
+        total += elapsed;
+    } while (total < seconds);
+
+    if (numBuffers > 0)
+        printf("%-8s %6ld buffers %8.3f us per buffer\n", outputNames[output],
+            (long) numBuffers, best * 1e6 / numBuffers);
+    EAS_Shutdown(pEASData);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    static EAS_U8 smf[BENCH_SMF_SIZE];
+    S_EAS_TEST_FILE file;
+    EAS_I32 smfSize;
+    double seconds;
+
+    seconds = (argc > 2) ? atof(argv[2]) : 0.5;
+    if (argc > 1)
+    {
+        if (!EAS_TestLoadFile(argv[1], &file))
+        {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        if ((smfSize = EAS_TestMakeSMF(smf, BENCH_SMF_SIZE, 1, 15, 1000)) == 0)
+        {
+            fprintf(stderr, "MIDI file too large\n");
+            return 1;
+        }
+        EAS_TestMemoryFile(&file, smf, smfSize);
+    }
+
+    printf("best pass\n");
+    Bench(&file, eBenchPCM, seconds);
+    Bench(&file, eBenchConvert, seconds);
+    Bench(&file, eBenchFloat, seconds);
+    if (argc > 1)
+        free(file.pData);
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * bench_parser.c
+ *
+ * Contents and purpose:
+ * Benchmark of the MIDI byte parsers. Parses an SMF-like stream, with
+ * running status notes, and a live-like stream, with full status bytes,
+ * controllers, clock and active sensing, in 256 byte writes. Prints the
+ * throughput in MB/s of the byte at a time parser, EAS_ParseMIDIStream,
+ * and the bulk parser, EAS_ParseMIDIBuffer, parsing only and dispatching
+ * to the synth.
+ *
+ * bench_parser [seconds per test]
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_data.h"
+#include "eas_synth.h"
+#include "eas_parser.h"
+#include "eas_midi.h"
+
+/* gets the synth of a stream, from eas_public.c */
+extern EAS_RESULT EAS_GetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_I32 *pValue);
+
+#define BENCH_STREAM_SIZE       65536
+#define BENCH_WRITE_SIZE        256
+
+/* buffers rendered after each pass when dispatching, to retire notes */
+#define BENCH_RENDER_BUFFERS    4
+
+/*----------------------------------------------------------------------------
+ * MakeSMFLike()
+ *----------------------------------------------------------------------------
+ * Note on and off pairs on one channel with running status, note off
+ * as note on with zero velocity, as a MIDI file track is usually written
+ *----------------------------------------------------------------------------
+*/
+static void MakeSMFLike (EAS_U8 *pBuffer, EAS_I32 size, EAS_U32 seed)
+{
+    EAS_I32 i;
+    EAS_U8 note;
+
+    pBuffer[0] = 0x90;
+    note = 60;
+    for (i = 1; i + 6 <= size; i += 6)
+    {
+        note = (EAS_U8) (36 + EAS_TestRandom(&seed) % 48);
+        pBuffer[i] = note;
+        pBuffer[i + 1] = (EAS_U8) (1 + EAS_TestRandom(&seed) % 127);
+        pBuffer[i + 2] = note;
+        pBuffer[i + 3] = 0;
+        pBuffer[i + 4] = note;
+        pBuffer[i + 5] = 0;
+    }
+    for (; i < size; i++)
+        pBuffer[i] = note;
+}
+
+/*----------------------------------------------------------------------------
+ * MakeLiveLike()
+ *----------------------------------------------------------------------------
+ * Full status notes, note offs, controllers and pitch bend on a few
+ * channels, with timing clock and active sensing bytes as a keyboard
+ * sends them
+ *----------------------------------------------------------------------------
+*/
+static void MakeLiveLike (EAS_U8 *pBuffer, EAS_I32 size, EAS_U32 seed)
+{
+    EAS_I32 i;
+    EAS_U32 r;
+    EAS_U8 channel;
+
+    i = 0;
+    while (i + 3 <= size)
+    {
+        r = EAS_TestRandom(&seed);
+        channel = (EAS_U8) (r & 3);
+        switch ((r >> 4) % 8)
+        {
+            case 0:
+            case 1:
+                pBuffer[i++] = (EAS_U8) (0x90 | channel);
+                pBuffer[i++] = (EAS_U8) (36 + (r >> 8) % 48);
+                pBuffer[i++] = (EAS_U8) (1 + (r >> 16) % 127);
+                break;
+            case 2:
+            case 3:
+                pBuffer[i++] = (EAS_U8) (0x80 | channel);
+                pBuffer[i++] = (EAS_U8) (36 + (r >> 8) % 48);
+                pBuffer[i++] = 64;
+                break;
+            case 4:
+                pBuffer[i++] = (EAS_U8) (0xb0 | channel);
+                pBuffer[i++] = 1;
+                pBuffer[i++] = (EAS_U8) ((r >> 8) & 0x7f);
+                break;
+            case 5:
+                pBuffer[i++] = (EAS_U8) (0xe0 | channel);
+                pBuffer[i++] = (EAS_U8) ((r >> 8) & 0x7f);
+                pBuffer[i++] = (EAS_U8) ((r >> 16) & 0x7f);
+                break;
+            case 6:
+                pBuffer[i++] = 0xf8;
+                break;
+            default:
+                pBuffer[i++] = 0xfe;
+                break;
+        }
+    }
+    while (i < size)
+        pBuffer[i++] = 0xf8;
+}
+
+/*----------------------------------------------------------------------------
+ * Parse()
+ *----------------------------------------------------------------------------
+ * Parses the whole stream in BENCH_WRITE_SIZE writes and returns the
+ * time taken
+ *----------------------------------------------------------------------------
+*/
+static double Parse (S_EAS_DATA *pEASData, S_SYNTH *pSynth, S_MIDI_STREAM *pStream, const EAS_U8 *pBuffer, EAS_BOOL bulk, EAS_INT parserMode)
+{
+    EAS_I32 offset;
+    EAS_I32 i;
+    double start;
+
+    start = EAS_TestSeconds();
+    for (offset = 0; offset < BENCH_STREAM_SIZE; offset += BENCH_WRITE_SIZE)
+    {
+        if (bulk)
+            EAS_ParseMIDIBuffer(pEASData, pSynth, pStream, pBuffer + offset, BENCH_WRITE_SIZE, parserMode);
+        else
+        {
+            for (i = 0; i < BENCH_WRITE_SIZE; i++)
+                EAS_ParseMIDIStream(pEASData, pSynth, pStream, pBuffer[offset + i], parserMode);
+        }
+    }
+    return EAS_TestSeconds() - start;
+}
+
+/*----------------------------------------------------------------------------
+ * Bench()
+ *----------------------------------------------------------------------------
+ * Prints the throughput of one parser on one stream, keeping the best
+ * pass. Each test has its own instance, and the synth is rendered
+ * between passes when dispatching, which is not timed.
+ *----------------------------------------------------------------------------
+*/
+static void Bench (const char *pName, const EAS_U8 *pBuffer, EAS_BOOL bulk, EAS_INT parserMode, double seconds)
+{
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE handle;
+    S_MIDI_STREAM stream;
+    EAS_I32 value;
+    double total;
+    double best;
+    double elapsed;
+
+    if ((pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) == NULL)
+        return;
+    if ((EAS_OpenMIDIStream(pEASData, &handle, NULL) != EAS_SUCCESS) ||
+        (EAS_GetStreamParameter(pEASData, handle, PARSER_DATA_SYNTH_HANDLE, &value) != EAS_SUCCESS))
+    {
+        fprintf(stderr, "Cannot open a MIDI stream\n");
+        EAS_Shutdown(pEASData);
+        return;
+    }
+
+    memset(&stream, 0, sizeof(stream));
+    EAS_InitMIDIStream(&stream);
+    best = 0;
+    total = 0;
+    do
+    {
+        elapsed = Parse(pEASData, (S_SYNTH*) value, &stream, pBuffer, bulk, parserMode);
+        if ((best == 0) || (elapsed < best))
+            best = elapsed;
+        total += elapsed;
+        if (parserMode == eParserModePlay)
+            EAS_TestRender(pEASData, BENCH_RENDER_BUFFERS, NULL, NULL);
+    } while (total < seconds);
+
+    printf("%-10s %-6s %-9s %8.1f MB/s\n", pName, bulk ? "bulk" : "byte",
+        (parserMode == eParserModePlay) ? "dispatch" : "parse", BENCH_STREAM_SIZE / best / 1e6);
+
+    EAS_CloseMIDIStream(pEASData, handle);
+    EAS_Shutdown(pEASData);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    static EAS_U8 smfLike[BENCH_STREAM_SIZE];
+    static EAS_U8 liveLike[BENCH_STREAM_SIZE];
+    double seconds;
+    EAS_INT mode;
+    EAS_INT bulk;
+
+    seconds = (argc > 1) ? atof(argv[1]) : 0.5;
+    MakeSMFLike(smfLike, BENCH_STREAM_SIZE, 1);
+    MakeLiveLike(liveLike, BENCH_STREAM_SIZE, 2);
+
+    printf("%d byte stream, %d byte writes, best pass\n", BENCH_STREAM_SIZE, BENCH_WRITE_SIZE);
+    for (mode = 0; mode < 2; mode++)
+    {
+        for (bulk = 0; bulk < 2; bulk++)
+        {
+            Bench("smf-like", smfLike, (EAS_BOOL) bulk,
+                mode ? eParserModePlay : eParserModeMetaData, seconds);
+            Bench("live-like", liveLike, (EAS_BOOL) bulk,
+                mode ? eParserModePlay : eParserModeMetaData, seconds);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * bench_wtengine.c
+ *
+ * Contents and purpose:
+ * Benchmark of the wavetable engine kernels. Times each kernel on
+ * full buffers of a looped voice and prints the time per output
+ * sample, and on x86 the time stamp counter ticks per sample.
+ *
+ * bench_wtengine [seconds per kernel]
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define BENCH_TICKS()   __rdtsc()
+#endif
+
+#include "eas_test.h"
+#include "eas_synthcfg.h"
+#include "eas_math.h"
+#include "eas_audioconst.h"
+#include "eas_sndlib.h"
+#include "eas_wtengine.h"
+
+/* kernels, declared in eas_wtengine.c */
+extern void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame);
+
+#define BENCH_WAVE_SAMPLES      8192
+#define BENCH_LOOP_SAMPLES      2048
+#define BENCH_BATCH             1000
+
+typedef enum
+{
+    eBenchInterpolate = 0,
+    eBenchInterpolateNoLoop,
+    eBenchVoiceGain,
+    eBenchVoiceFilter,
+    eBenchNumKernels
+} E_BENCH_KERNEL;
+
+static const char * const kernelNames[eBenchNumKernels] =
+{
+    "WT_Interpolate",
+    "WT_InterpolateNoLoop",
+    "WT_VoiceGain",
+    "WT_VoiceFilter"
+};
+
+static EAS_SAMPLE wave[BENCH_WAVE_SAMPLES];
+static EAS_PCM audio[BUFFER_SIZE_IN_MONO_SAMPLES];
+static EAS_MIX_SAMPLE mix[BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS];
+
+/*----------------------------------------------------------------------------
+ * RunKernel()
+ *----------------------------------------------------------------------------
+ * Runs a batch of buffers, restarting the no loop voice before it ends
+ *----------------------------------------------------------------------------
+*/
+static void RunKernel (E_BENCH_KERNEL kernel, S_WT_VOICE *pVoice, S_WT_INT_FRAME *pFrame)
+{
+    EAS_I32 i;
+
+    for (i = 0; i < BENCH_BATCH; i++)
+    {
+        pFrame->numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
+        switch (kernel)
+        {
+            case eBenchInterpolate:
+                WT_Interpolate(pVoice, pFrame);
+                break;
+            case eBenchInterpolateNoLoop:
+                if (pVoice->phaseAccum > (EAS_U32) &wave[BENCH_WAVE_SAMPLES - BUFFER_SIZE_IN_MONO_SAMPLES * 4])
+                    pVoice->phaseAccum = (EAS_U32) wave;
+                WT_InterpolateNoLoop(pVoice, pFrame);
+                break;
+            case eBenchVoiceGain:
+                WT_VoiceGain(pVoice, pFrame);
+                break;
+            case eBenchVoiceFilter:
+#ifdef _FILTER_ENABLED
+                WT_VoiceFilter(&pVoice->filter, pFrame);
+#endif
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    S_WT_INT_FRAME frame;
+    S_WT_VOICE voice;
+    E_BENCH_KERNEL kernel;
+    double seconds;
+    double start;
+    double elapsed;
+    double samples;
+    EAS_U32 seed;
+    EAS_I32 i;
+#ifdef BENCH_TICKS
+    unsigned long long ticks;
+#endif
+
+    seconds = (argc > 1) ? atof(argv[1]) : 0.5;
+    seed = 1;
+    for (i = 0; i < BENCH_WAVE_SAMPLES; i++)
+        wave[i] = (EAS_SAMPLE) EAS_TestRandom(&seed);
+    for (i = 0; i < BUFFER_SIZE_IN_MONO_SAMPLES; i++)
+        audio[i] = (EAS_PCM) (EAS_TestRandom(&seed) & 0x3fff) - 0x2000;
+
+    printf("%d samples per buffer\n", BUFFER_SIZE_IN_MONO_SAMPLES);
+    for (kernel = eBenchInterpolate; kernel < eBenchNumKernels; kernel++)
+    {
+        /* a voice a fifth above the root key, half gain, panned centre */
+        memset(&voice, 0, sizeof(voice));
+        memset(&frame, 0, sizeof(frame));
+        voice.loopStart = (EAS_U32) wave;
+        voice.loopEnd = (EAS_U32) &wave[(kernel == eBenchInterpolate) ? BENCH_LOOP_SAMPLES : BENCH_WAVE_SAMPLES - 1];
+        voice.phaseAccum = (EAS_U32) wave;
+#if (NUM_OUTPUT_CHANNELS == 2)
+        voice.gainLeft = 0x4000;
+        voice.gainRight = 0x4000;
+#endif
+        frame.frame.phaseIncrement = (3 << NUM_PHASE_FRAC_BITS) / 2;
+        frame.frame.gainTarget = 0x2000;
+        frame.prevGain = 0x1000;
+#ifdef _FILTER_ENABLED
+        frame.frame.k = 0x2000;
+        frame.frame.b1 = -0x3000;
+        frame.frame.b2 = 0x1000;
+#endif
+        frame.pAudioBuffer = audio;
+        frame.pMixBuffer = mix;
+
+        /* warm up, then time whole batches */
+        RunKernel(kernel, &voice, &frame);
+        samples = 0;
+#ifdef BENCH_TICKS
+        ticks = BENCH_TICKS();
+#endif
+        start = EAS_TestSeconds();
+        do
+        {
+            RunKernel(kernel, &voice, &frame);
+            samples += BENCH_BATCH * BUFFER_SIZE_IN_MONO_SAMPLES;
+            elapsed = EAS_TestSeconds() - start;
+        } while (elapsed < seconds);
+
+#ifdef BENCH_TICKS
+        printf("%-22s %7.3f ns/sample %7.2f ticks/sample\n", kernelNames[kernel], elapsed * 1e9 / samples,
+            (double) (BENCH_TICKS() - ticks) / samples);
+#else
+        printf("%-22s %7.3f ns/sample\n", kernelNames[kernel], elapsed * 1e9 / samples);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,734 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_test.c
+ *
+ * Contents and purpose:
+ * Helpers shared by the host tests and benchmarks, see eas_test.h.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+
+/* generated MIDI files */
+#define TEST_SMF_DIVISION       480
+#define TEST_SMF_MAX_EVENTS     8192
+
+/* generated DLS collections */
+#define TEST_DLS_WAVES          64
+#define TEST_DLS_INSTRUMENTS    128
+#define TEST_DLS_REGIONS        8
+
+/* DLS connection destinations */
+#define TEST_CONN_DST_PAN           0x0004
+#define TEST_CONN_DST_EG1_ATTACK    0x0206
+#define TEST_CONN_DST_EG1_SUSTAIN   0x020a
+#define TEST_CONN_DST_EG1_RELEASE   0x0209
+
+typedef struct
+{
+    EAS_I32             time;
+    EAS_U8              data[3];
+    EAS_U8              length;
+} S_TEST_EVENT;
+
+/* writes a RIFF file, sizes of open chunks are filled in when they end */
+typedef struct
+{
+    EAS_U8              *pData;
+    EAS_I32             size;
+    EAS_I32             pos;
+} S_TEST_RIFF;
+
+static int numFailures;
+
+/*----------------------------------------------------------------------------
+ * EAS_TestFail()
+ *----------------------------------------------------------------------------
+*/
+void EAS_TestFail (const char *pFile, int line, const char *pFmt, ...)
+{
+    va_list ap;
+
+    fprintf(stderr, "%s:%d: ", pFile, line);
+    va_start(ap, pFmt);
+    vfprintf(stderr, pFmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    numFailures++;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestResult()
+ *----------------------------------------------------------------------------
+*/
+int EAS_TestResult (const char *pName)
+{
+    if (numFailures == 0)
+    {
+        printf("%s: passed\n", pName);
+        return 0;
+    }
+    printf("%s: %d failures\n", pName, numFailures);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * TestReadAt()
+ *----------------------------------------------------------------------------
+*/
+static int TestReadAt (void *handle, void *buf, int offset, int size)
+{
+    S_EAS_TEST_FILE *pFile = (S_EAS_TEST_FILE*) handle;
+
+    if ((offset < 0) || (offset >= pFile->size))
+        return 0;
+    if (size > pFile->size - offset)
+        size = pFile->size - offset;
+    memcpy(buf, pFile->pData + offset, (size_t) size);
+    return size;
+}
+
+/*----------------------------------------------------------------------------
+ * TestSize()
+ *----------------------------------------------------------------------------
+*/
+static int TestSize (void *handle)
+{
+    return ((S_EAS_TEST_FILE*) handle)->size;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestMemoryFile()
+ *----------------------------------------------------------------------------
+*/
+void EAS_TestMemoryFile (S_EAS_TEST_FILE *pFile, EAS_U8 *pData, EAS_I32 size)
+{
+    pFile->pData = pData;
+    pFile->size = size;
+    pFile->locator.handle = pFile;
+    pFile->locator.readAt = TestReadAt;
+    pFile->locator.size = TestSize;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestLoadFile()
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL EAS_TestLoadFile (const char *pPath, S_EAS_TEST_FILE *pFile)
+{
+    FILE *file;
+    EAS_U8 *pData;
+    long size;
+
+    if ((file = fopen(pPath, "rb")) == NULL)
+        return EAS_FALSE;
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    rewind(file);
+    pData = (size > 0) ? malloc((size_t) size) : NULL;
+    if ((pData == NULL) || (fread(pData, 1, (size_t) size, file) != (size_t) size))
+    {
+        free(pData);
+        fclose(file);
+        return EAS_FALSE;
+    }
+    fclose(file);
+    EAS_TestMemoryFile(pFile, pData, (EAS_I32) size);
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestRandom()
+ *----------------------------------------------------------------------------
+*/
+EAS_U32 EAS_TestRandom (EAS_U32 *pSeed)
+{
+    *pSeed = *pSeed * 1664525u + 1013904223u;
+    return (*pSeed >> 8) & 0xffffff;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestSeconds()
+ *----------------------------------------------------------------------------
+*/
+double EAS_TestSeconds (void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/*----------------------------------------------------------------------------
+ * TestAddEvent()
+ *----------------------------------------------------------------------------
+*/
+static void TestAddEvent (S_TEST_EVENT *pEvents, EAS_I32 *pNumEvents, EAS_I32 time, EAS_U8 d0, EAS_U8 d1, EAS_U8 d2)
+{
+    S_TEST_EVENT *pEvent;
+
+    if (*pNumEvents >= TEST_SMF_MAX_EVENTS)
+        return;
+    pEvent = &pEvents[(*pNumEvents)++];
+    pEvent->time = time;
+    pEvent->data[0] = d0;
+    pEvent->data[1] = d1;
+    pEvent->data[2] = d2;
+    pEvent->length = ((d0 & 0xe0) == 0xc0) ? 2 : 3;
+}
+
+/*----------------------------------------------------------------------------
+ * TestCompareEvents()
+ *----------------------------------------------------------------------------
+ * Orders by time, with note offs before other events at the same time
+ *----------------------------------------------------------------------------
+*/
+static int TestCompareEvents (const void *p1, const void *p2)
+{
+    const S_TEST_EVENT *pEvent1 = (const S_TEST_EVENT*) p1;
+    const S_TEST_EVENT *pEvent2 = (const S_TEST_EVENT*) p2;
+    int off1;
+    int off2;
+
+    if (pEvent1->time != pEvent2->time)
+        return (pEvent1->time < pEvent2->time) ? -1 : 1;
+    off1 = (pEvent1->data[0] & 0xf0) == 0x80;
+    off2 = (pEvent2->data[0] & 0xf0) == 0x80;
+    if (off1 != off2)
+        return off1 ? -1 : 1;
+    return (pEvent1 < pEvent2) ? -1 : (pEvent1 > pEvent2);
+}
+
+/*----------------------------------------------------------------------------
+ * TestPutVarLen()
+ *----------------------------------------------------------------------------
+*/
+static EAS_U8 *TestPutVarLen (EAS_U8 *p, EAS_U32 value)
+{
+    EAS_U8 bytes[5];
+    int count;
+
+    count = 0;
+    do
+    {
+        bytes[count++] = (EAS_U8) (value & 0x7f);
+        value >>= 7;
+    } while (value);
+    while (count > 1)
+        *p++ = bytes[--count] | 0x80;
+    *p++ = bytes[0];
+    return p;
+}
+
+/*----------------------------------------------------------------------------
+ * TestPut32()
+ *----------------------------------------------------------------------------
+*/
+static EAS_U8 *TestPut32 (EAS_U8 *p, EAS_U32 value)
+{
+    *p++ = (EAS_U8) (value >> 24);
+    *p++ = (EAS_U8) (value >> 16);
+    *p++ = (EAS_U8) (value >> 8);
+    *p++ = (EAS_U8) value;
+    return p;
+}
+
+/*----------------------------------------------------------------------------
+ * TestWriteTrack()
+ *----------------------------------------------------------------------------
+ * Writes an MTrk chunk, returns NULL if it does not fit
+ *----------------------------------------------------------------------------
+*/
+static EAS_U8 *TestWriteTrack (EAS_U8 *p, EAS_U8 *pEnd, const S_TEST_EVENT *pEvents, EAS_I32 numEvents, const EAS_U8 *pMeta, EAS_I32 metaSize)
+{
+    EAS_U8 *pLength;
+    EAS_I32 time;
+    EAS_I32 i;
+
+    /* worst case is a four byte delta time for every event */
+    if (pEnd - p < 16 + metaSize + numEvents * 7)
+        return NULL;
+    memcpy(p, "MTrk", 4);
+    pLength = p + 4;
+    p += 8;
+    if (metaSize > 0)
+        memcpy(p, pMeta, (size_t) metaSize);
+    p += metaSize;
+    time = 0;
+    for (i = 0; i < numEvents; i++)
+    {
+        p = TestPutVarLen(p, (EAS_U32) (pEvents[i].time - time));
+        time = pEvents[i].time;
+        memcpy(p, pEvents[i].data, pEvents[i].length);
+        p += pEvents[i].length;
+    }
+
+    /* end of track */
+    *p++ = 0;
+    *p++ = 0xff;
+    *p++ = 0x2f;
+    *p++ = 0;
+    TestPut32(pLength, (EAS_U32) (p - pLength - 4));
+    return p;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestMakeSMF()
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 EAS_TestMakeSMF (EAS_U8 *pBuffer, EAS_I32 bufferSize, EAS_U32 seed, EAS_I32 numTracks, EAS_I32 numNotes)
+{
+    static const EAS_U8 controllers[] = { 1, 7, 10, 11, 91 };
+    /* 120 bpm, then 90 bpm and 150 bpm later on */
+    static const EAS_U8 tempoTrack[] =
+    {
+        0x00, 0xff, 0x51, 0x03, 0x07, 0xa1, 0x20,
+        0x00, 0xff, 0x58, 0x04, 0x04, 0x02, 0x18, 0x08,
+        0x8f, 0x00, 0xff, 0x51, 0x03, 0x0a, 0x2c, 0x2b,
+        0x8f, 0x00, 0xff, 0x51, 0x03, 0x06, 0x1a, 0x80
+    };
+    S_TEST_EVENT *pEvents;
+    EAS_U8 *pEnd;
+    EAS_U8 *p;
+    EAS_I32 numEvents;
+    EAS_I32 track;
+    EAS_I32 time;
+    EAS_I32 i;
+    EAS_U8 channel;
+    EAS_U8 note;
+
+    if (bufferSize < 14)
+        return 0;
+    if ((pEvents = malloc(sizeof(S_TEST_EVENT) * TEST_SMF_MAX_EVENTS)) == NULL)
+        return 0;
+
+    p = pBuffer;
+    pEnd = pBuffer + bufferSize;
+    memcpy(p, "MThd", 4);
+    p = TestPut32(p + 4, 6);
+    *p++ = 0;
+    *p++ = 1;
+    *p++ = 0;
+    *p++ = (EAS_U8) (numTracks + 1);
+    *p++ = TEST_SMF_DIVISION >> 8;
+    *p++ = TEST_SMF_DIVISION & 0xff;
+
+    /* tempo map, the events are all meta events */
+    p = TestWriteTrack(p, pEnd, NULL, 0, tempoTrack, sizeof(tempoTrack));
+
+    for (track = 0; (track < numTracks) && (p != NULL); track++)
+    {
+        channel = (track == numTracks - 1) ? 9 : (EAS_U8) (track % 9);
+        numEvents = 0;
+        TestAddEvent(pEvents, &numEvents, 0, 0xc0 | channel, (EAS_U8) (EAS_TestRandom(&seed) & 0x7f), 0);
+        TestAddEvent(pEvents, &numEvents, 0, 0xb0 | channel, 7, (EAS_U8) (80 + EAS_TestRandom(&seed) % 40));
+
+        time = 0;
+        for (i = 0; i < numNotes; i++)
+        {
+            time += (EAS_I32) (EAS_TestRandom(&seed) % (TEST_SMF_DIVISION / 2));
+            if (channel == 9)
+                note = (EAS_U8) (35 + EAS_TestRandom(&seed) % 47);
+            else
+                note = (EAS_U8) (36 + EAS_TestRandom(&seed) % 48);
+            TestAddEvent(pEvents, &numEvents, time, 0x90 | channel, note, (EAS_U8) (1 + EAS_TestRandom(&seed) % 127));
+            TestAddEvent(pEvents, &numEvents, time + 1 + (EAS_I32) (EAS_TestRandom(&seed) % (TEST_SMF_DIVISION * 2)),
+                0x80 | channel, note, 64);
+
+            switch (EAS_TestRandom(&seed) % 12)
+            {
+                case 0:
+                    TestAddEvent(pEvents, &numEvents, time, 0xb0 | channel,
+                        controllers[EAS_TestRandom(&seed) % sizeof(controllers)], (EAS_U8) (EAS_TestRandom(&seed) & 0x7f));
+                    break;
+                case 1:
+                    TestAddEvent(pEvents, &numEvents, time, 0xe0 | channel, (EAS_U8) (EAS_TestRandom(&seed) & 0x7f),
+                        (EAS_U8) (EAS_TestRandom(&seed) & 0x7f));
+                    break;
+                case 2:
+                    TestAddEvent(pEvents, &numEvents, time, 0xb0 | channel, 64, (EAS_U8) ((EAS_TestRandom(&seed) & 1) ? 127 : 0));
+                    break;
+                case 3:
+                    TestAddEvent(pEvents, &numEvents, time, 0xc0 | channel, (EAS_U8) (EAS_TestRandom(&seed) & 0x7f), 0);
+                    break;
+                default:
+                    break;
+            }
+        }
+        TestAddEvent(pEvents, &numEvents, time + TEST_SMF_DIVISION * 2, 0xb0 | channel, 64, 0);
+
+        qsort(pEvents, (size_t) numEvents, sizeof(S_TEST_EVENT), TestCompareEvents);
+        p = TestWriteTrack(p, pEnd, pEvents, numEvents, NULL, 0);
+    }
+
+    free(pEvents);
+    return (p != NULL) ? (EAS_I32) (p - pBuffer) : 0;
+}
+
+/*----------------------------------------------------------------------------
+ * RIFF writer for EAS_TestMakeDLS
+ *----------------------------------------------------------------------------
+*/
+static void RiffPut8 (S_TEST_RIFF *pRiff, EAS_U8 value)
+{
+    if (pRiff->pos < pRiff->size)
+        pRiff->pData[pRiff->pos] = value;
+    pRiff->pos++;
+}
+
+static void RiffPut16 (S_TEST_RIFF *pRiff, EAS_U32 value)
+{
+    RiffPut8(pRiff, (EAS_U8) value);
+    RiffPut8(pRiff, (EAS_U8) (value >> 8));
+}
+
+static void RiffPut32 (S_TEST_RIFF *pRiff, EAS_U32 value)
+{
+    RiffPut16(pRiff, value & 0xffff);
+    RiffPut16(pRiff, (value >> 16) & 0xffff);
+}
+
+static void RiffPutTag (S_TEST_RIFF *pRiff, const char *pTag)
+{
+    EAS_INT i;
+
+    for (i = 0; i < 4; i++)
+        RiffPut8(pRiff, (EAS_U8) pTag[i]);
+}
+
+/* starts a chunk, or a list if pType is not NULL, returns its start */
+static EAS_I32 RiffBeginChunk (S_TEST_RIFF *pRiff, const char *pTag, const char *pType)
+{
+    EAS_I32 start;
+
+    RiffPutTag(pRiff, pTag);
+    start = pRiff->pos;
+    RiffPut32(pRiff, 0);
+    if (pType != NULL)
+        RiffPutTag(pRiff, pType);
+    return start;
+}
+
+/* fills in the size of a chunk and pads it to an even size */
+static void RiffEndChunk (S_TEST_RIFF *pRiff, EAS_I32 start)
+{
+    EAS_I32 size;
+    EAS_I32 pos;
+
+    size = pRiff->pos - start - 4;
+    if (size & 1)
+        RiffPut8(pRiff, 0);
+    pos = pRiff->pos;
+    pRiff->pos = start;
+    RiffPut32(pRiff, (EAS_U32) size);
+    pRiff->pos = pos;
+}
+
+/* an articulation list with one connection block per destination */
+static void RiffPutArticulation (S_TEST_RIFF *pRiff, const EAS_U32 *pDest, const EAS_I32 *pScale, EAS_INT count)
+{
+    EAS_I32 list;
+    EAS_I32 chunk;
+    EAS_INT i;
+
+    list = RiffBeginChunk(pRiff, "LIST", "lart");
+    chunk = RiffBeginChunk(pRiff, "art1", NULL);
+    RiffPut32(pRiff, 8);
+    RiffPut32(pRiff, (EAS_U32) count);
+    for (i = 0; i < count; i++)
+    {
+        RiffPut16(pRiff, 0);
+        RiffPut16(pRiff, 0);
+        RiffPut16(pRiff, pDest[i]);
+        RiffPut16(pRiff, 0);
+        RiffPut32(pRiff, (EAS_U32) pScale[i]);
+    }
+    RiffEndChunk(pRiff, chunk);
+    RiffEndChunk(pRiff, list);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestMakeDLS()
+ *----------------------------------------------------------------------------
+ * Writes a DLS level 1 collection of looped sine waves, and instruments
+ * with a region per 16 keys, each with its own articulation, as a sound
+ * set has many small chunks. The seed shifts the phase of the waves.
+ * Returns the size, or zero if the buffer is too small.
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 EAS_TestMakeDLS (EAS_U8 *pBuffer, EAS_I32 bufferSize, EAS_U32 seed)
+{
+    static const EAS_U32 regionDest[3] = { TEST_CONN_DST_EG1_ATTACK, TEST_CONN_DST_EG1_RELEASE, TEST_CONN_DST_PAN };
+    static const EAS_U32 instDest[1] = { TEST_CONN_DST_EG1_SUSTAIN };
+    EAS_I32 offsets[TEST_DLS_WAVES];
+    EAS_I32 scale[3];
+    S_TEST_RIFF riff;
+    EAS_I32 riffStart;
+    EAS_I32 chunk;
+    EAS_I32 list;
+    EAS_I32 region;
+    EAS_I32 inst;
+    EAS_I32 wvpl;
+    EAS_I32 ptbl;
+    EAS_I32 len;
+    EAS_I32 i;
+    EAS_I32 r;
+    EAS_I32 s;
+
+    riff.pData = pBuffer;
+    riff.size = bufferSize;
+    riff.pos = 0;
+    riffStart = RiffBeginChunk(&riff, "RIFF", "DLS ");
+
+    chunk = RiffBeginChunk(&riff, "colh", NULL);
+    RiffPut32(&riff, TEST_DLS_INSTRUMENTS);
+    RiffEndChunk(&riff, chunk);
+    chunk = RiffBeginChunk(&riff, "vers", NULL);
+    RiffPut32(&riff, 0);
+    RiffPut32(&riff, 0);
+    RiffEndChunk(&riff, chunk);
+
+    /* instruments */
+    list = RiffBeginChunk(&riff, "LIST", "lins");
+    for (i = 0; i < TEST_DLS_INSTRUMENTS; i++)
+    {
+        inst = RiffBeginChunk(&riff, "LIST", "ins ");
+        chunk = RiffBeginChunk(&riff, "insh", NULL);
+        RiffPut32(&riff, TEST_DLS_REGIONS);
+        RiffPut32(&riff, 0);
+        RiffPut32(&riff, (EAS_U32) i);
+        RiffEndChunk(&riff, chunk);
+        scale[0] = (i * 5) << 16;
+        RiffPutArticulation(&riff, instDest, scale, 1);
+
+        chunk = RiffBeginChunk(&riff, "LIST", "lrgn");
+        for (r = 0; r < TEST_DLS_REGIONS; r++)
+        {
+            region = RiffBeginChunk(&riff, "LIST", "rgn ");
+            s = RiffBeginChunk(&riff, "rgnh", NULL);
+            RiffPut16(&riff, (EAS_U32) (r * 16));
+            RiffPut16(&riff, (EAS_U32) (r * 16 + 15));
+            RiffPut16(&riff, 0);
+            RiffPut16(&riff, 127);
+            RiffPut16(&riff, 0);
+            RiffPut16(&riff, 0);
+            RiffEndChunk(&riff, s);
+            s = RiffBeginChunk(&riff, "wsmp", NULL);
+            RiffPut32(&riff, 20);
+            RiffPut16(&riff, (EAS_U32) (r * 16 + 8));
+            RiffPut16(&riff, 0);
+            RiffPut32(&riff, 0);
+            RiffPut32(&riff, 0);
+            RiffPut32(&riff, 0);
+            RiffEndChunk(&riff, s);
+            s = RiffBeginChunk(&riff, "wlnk", NULL);
+            RiffPut16(&riff, 0);
+            RiffPut16(&riff, 0);
+            RiffPut32(&riff, 1);
+            RiffPut32(&riff, (EAS_U32) ((i * TEST_DLS_REGIONS + r) % TEST_DLS_WAVES));
+            RiffEndChunk(&riff, s);
+            scale[0] = (r * 100) << 16;
+            scale[1] = (i * 10) << 16;
+            scale[2] = 0;
+            RiffPutArticulation(&riff, regionDest, scale, 3);
+            RiffEndChunk(&riff, region);
+        }
+        RiffEndChunk(&riff, chunk);
+        RiffEndChunk(&riff, inst);
+    }
+    RiffEndChunk(&riff, list);
+
+    /* pool table, the offsets are filled in with the waves */
+    ptbl = RiffBeginChunk(&riff, "ptbl", NULL);
+    RiffPut32(&riff, 8);
+    RiffPut32(&riff, TEST_DLS_WAVES);
+    for (i = 0; i < TEST_DLS_WAVES; i++)
+        RiffPut32(&riff, 0);
+    RiffEndChunk(&riff, ptbl);
+
+    /* waves */
+    wvpl = RiffBeginChunk(&riff, "LIST", "wvpl");
+    for (i = 0; i < TEST_DLS_WAVES; i++)
+    {
+        offsets[i] = riff.pos - wvpl - 8;
+        len = 2000 + i * 10;
+        list = RiffBeginChunk(&riff, "LIST", "wave");
+        chunk = RiffBeginChunk(&riff, "fmt ", NULL);
+        RiffPut16(&riff, 1);
+        RiffPut16(&riff, 1);
+        RiffPut32(&riff, 22050);
+        RiffPut32(&riff, 44100);
+        RiffPut16(&riff, 2);
+        RiffPut16(&riff, 16);
+        RiffEndChunk(&riff, chunk);
+        chunk = RiffBeginChunk(&riff, "wsmp", NULL);
+        RiffPut32(&riff, 20);
+        RiffPut16(&riff, 60);
+        RiffPut16(&riff, 0);
+        RiffPut32(&riff, 0);
+        RiffPut32(&riff, 0);
+        RiffPut32(&riff, 1);
+        RiffPut32(&riff, 16);
+        RiffPut32(&riff, 0);
+        RiffPut32(&riff, 100);
+        RiffPut32(&riff, (EAS_U32) (len - 200));
+        RiffEndChunk(&riff, chunk);
+        chunk = RiffBeginChunk(&riff, "data", NULL);
+        for (s = 0; s < len; s++)
+            RiffPut16(&riff, (EAS_U16) (EAS_I16) (8000.0 * sin(s * 0.05 * (i + 1) + seed)));
+        RiffEndChunk(&riff, chunk);
+        RiffEndChunk(&riff, list);
+    }
+    RiffEndChunk(&riff, wvpl);
+
+    list = RiffBeginChunk(&riff, "LIST", "INFO");
+    chunk = RiffBeginChunk(&riff, "INAM", NULL);
+    RiffPutTag(&riff, "dls");
+    RiffPut8(&riff, 0);
+    RiffEndChunk(&riff, chunk);
+    RiffEndChunk(&riff, list);
+    RiffEndChunk(&riff, riffStart);
+    if (riff.pos > riff.size)
+        return 0;
+
+    len = riff.pos;
+    riff.pos = ptbl + 12;
+    for (i = 0; i < TEST_DLS_WAVES; i++)
+        RiffPut32(&riff, (EAS_U32) offsets[i]);
+    return len;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestInit()
+ *----------------------------------------------------------------------------
+*/
+EAS_DATA_HANDLE EAS_TestInit (EAS_I32 reverbPreset)
+{
+    EAS_DATA_HANDLE pEASData;
+
+    if (EAS_Init(&pEASData) != EAS_SUCCESS)
+        return NULL;
+    if (reverbPreset != EAS_TEST_NO_REVERB)
+    {
+        EAS_SetParameter(pEASData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, reverbPreset);
+        EAS_SetParameter(pEASData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE);
+    }
+    else
+        EAS_SetParameter(pEASData, EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_TRUE);
+    return pEASData;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestOpen()
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_TestOpen (EAS_DATA_HANDLE pEASData, S_EAS_TEST_FILE *pFile, EAS_BOOL timeline, EAS_HANDLE *pStream)
+{
+    EAS_RESULT result;
+
+    if ((result = EAS_OpenFile(pEASData, &pFile->locator, pStream)) != EAS_SUCCESS)
+        return result;
+    if (timeline && ((result = EAS_SetTimelineMode(pEASData, *pStream, EAS_TRUE)) != EAS_SUCCESS))
+        return result;
+    return EAS_Prepare(pEASData, *pStream);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestHash()
+ *----------------------------------------------------------------------------
+*/
+uint64_t EAS_TestHash (uint64_t hash, const EAS_PCM *pBuffer, EAS_I32 count)
+{
+    EAS_I32 i;
+
+    for (i = 0; i < count; i++)
+    {
+        hash ^= (uint16_t) pBuffer[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestRender()
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_TestRender (EAS_DATA_HANDLE pEASData, EAS_I32 numBuffers, uint64_t *pHash, EAS_PCM *pOutput)
+{
+    const S_EAS_LIB_CONFIG *pLibConfig;
+    EAS_PCM buffer[1024];
+    EAS_RESULT result;
+    EAS_I32 count;
+    EAS_I32 samples;
+
+    pLibConfig = EAS_Config();
+    samples = pLibConfig->mixBufferSize * pLibConfig->numChannels;
+    if (samples > (EAS_I32) (sizeof(buffer) / sizeof(buffer[0])))
+        return EAS_BUFFER_SIZE_MISMATCH;
+
+    while (numBuffers-- > 0)
+    {
+        if ((result = EAS_Render(pEASData, buffer, pLibConfig->mixBufferSize, &count)) != EAS_SUCCESS)
+            return result;
+        if (pHash != NULL)
+            *pHash = EAS_TestHash(*pHash, buffer, count * pLibConfig->numChannels);
+        if (pOutput != NULL)
+        {
+            memcpy(pOutput, buffer, sizeof(EAS_PCM) * (size_t) samples);
+            pOutput += samples;
+        }
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_TestRenderFile()
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_TestRenderFile (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, EAS_I32 tailBuffers, uint64_t *pHash, EAS_I32 *pNumBuffers)
+{
+    EAS_RESULT result;
+    EAS_STATE state;
+    EAS_I32 numBuffers;
+    EAS_I32 tail;
+
+    numBuffers = 0;
+    tail = 0;
+    for (;;)
+    {
+        if ((result = EAS_TestRender(pEASData, 1, pHash, NULL)) != EAS_SUCCESS)
+            return result;
+        numBuffers++;
+        if ((result = EAS_State(pEASData, stream, &state)) != EAS_SUCCESS)
+            return result;
+        if (((state == EAS_STATE_STOPPED) || (state == EAS_STATE_ERROR)) && (++tail > tailBuffers))
+            break;
+    }
+    if (pNumBuffers != NULL)
+        *pNumBuffers = numBuffers;
+    return EAS_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_test.h
+ *
+ * Contents and purpose:
+ * Helpers shared by the host tests and benchmarks: files in memory,
+ * generated MIDI files, rendering with a running hash of the output,
+ * and failure reporting.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_TEST_H
+#define _EAS_TEST_H
+
+#include <stdint.h>
+#include "eas.h"
+
+/* file held in memory and the locator that reads it */
+typedef struct s_eas_test_file_tag
+{
+    EAS_U8              *pData;
+    EAS_I32             size;
+    EAS_FILE            locator;
+} S_EAS_TEST_FILE;
+
+/* starting value for EAS_TestHash */
+#define EAS_TEST_HASH_INIT      1469598103934665603ULL
+
+/* no reverb for EAS_TestInit */
+#define EAS_TEST_NO_REVERB      -1
+
+/* buffer size for EAS_TestMakeDLS */
+#define EAS_TEST_DLS_SIZE       (1024 * 1024)
+
+/* buffers rendered after a file stops, as the render tool does */
+#define EAS_TEST_TAIL_BUFFERS   200
+
+/* records a failure if cond is false */
+#define EAS_TEST_CHECK(cond, ...) \
+    do { if (!(cond)) EAS_TestFail(__FILE__, __LINE__, __VA_ARGS__); } while (0)
+
+/*----------------------------------------------------------------------------
+ * EAS_TestFail()
+ *----------------------------------------------------------------------------
+ * Prints a failure and counts it for EAS_TestResult
+ *----------------------------------------------------------------------------
+*/
+void EAS_TestFail (const char *pFile, int line, const char *pFmt, ...) __attribute__((format(printf, 3, 4)));
+
+/*----------------------------------------------------------------------------
+ * EAS_TestResult()
+ *----------------------------------------------------------------------------
+ * Prints the number of failures and returns the exit code for main
+ *----------------------------------------------------------------------------
+*/
+int EAS_TestResult (const char *pName);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestLoadFile()
+ *----------------------------------------------------------------------------
+ * Reads a file into memory, returns EAS_FALSE if it cannot be read
+ *----------------------------------------------------------------------------
+*/
+EAS_BOOL EAS_TestLoadFile (const char *pPath, S_EAS_TEST_FILE *pFile);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestMemoryFile()
+ *----------------------------------------------------------------------------
+ * Sets up a locator for data already in memory, owned by the caller
+ *----------------------------------------------------------------------------
+*/
+void EAS_TestMemoryFile (S_EAS_TEST_FILE *pFile, EAS_U8 *pData, EAS_I32 size);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestMakeSMF()
+ *----------------------------------------------------------------------------
+ * Writes a type 1 MIDI file with a tempo track and numTracks tracks of
+ * notes, program changes, controllers, sustain and pitch bend chosen
+ * from the seed. The last track is on the drum channel. Returns the size
+ * of the file, or zero if the buffer is too small.
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 EAS_TestMakeSMF (EAS_U8 *pBuffer, EAS_I32 bufferSize, EAS_U32 seed, EAS_I32 numTracks, EAS_I32 numNotes);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestMakeDLS()
+ *----------------------------------------------------------------------------
+ * Writes a DLS collection of 128 instruments with 8 regions each, playing
+ * 64 looped sine waves whose phase depends on the seed. Returns the size
+ * of the collection, or zero if the buffer is too small.
+ *----------------------------------------------------------------------------
+*/
+EAS_I32 EAS_TestMakeDLS (EAS_U8 *pBuffer, EAS_I32 bufferSize, EAS_U32 seed);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestRandom()
+ *----------------------------------------------------------------------------
+ * Small repeatable random number generator
+ *----------------------------------------------------------------------------
+*/
+EAS_U32 EAS_TestRandom (EAS_U32 *pSeed);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestSeconds()
+ *----------------------------------------------------------------------------
+ * Monotonic time in seconds, for the benchmarks
+ *----------------------------------------------------------------------------
+*/
+double EAS_TestSeconds (void);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestInit()
+ *----------------------------------------------------------------------------
+ * Creates an instance with a reverb preset, or EAS_TEST_NO_REVERB.
+ * Returns NULL on failure.
+ *----------------------------------------------------------------------------
+*/
+EAS_DATA_HANDLE EAS_TestInit (EAS_I32 reverbPreset);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestOpen()
+ *----------------------------------------------------------------------------
+ * Opens and prepares a file, optionally in timeline mode
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_TestOpen (EAS_DATA_HANDLE pEASData, S_EAS_TEST_FILE *pFile, EAS_BOOL timeline, EAS_HANDLE *pStream);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestHash()
+ *----------------------------------------------------------------------------
+ * Adds samples to a 64-bit FNV-1a hash of the output
+ *----------------------------------------------------------------------------
+*/
+uint64_t EAS_TestHash (uint64_t hash, const EAS_PCM *pBuffer, EAS_I32 count);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestRender()
+ *----------------------------------------------------------------------------
+ * Renders a number of buffers, adding them to the hash if pHash is not
+ * NULL and copying them to pOutput if it is not NULL
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_TestRender (EAS_DATA_HANDLE pEASData, EAS_I32 numBuffers, uint64_t *pHash, EAS_PCM *pOutput);
+
+/*----------------------------------------------------------------------------
+ * EAS_TestRenderFile()
+ *----------------------------------------------------------------------------
+ * Renders a stream until it stops and then tailBuffers more, hashing
+ * the output. pNumBuffers receives the number of buffers rendered.
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_TestRenderFile (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, EAS_I32 tailBuffers, uint64_t *pHash, EAS_I32 *pNumBuffers);
+
+#endif /* _EAS_TEST_H */
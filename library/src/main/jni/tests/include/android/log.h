@@ -0,0 +1,57 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * android/log.h
+ *
+ * Contents and purpose:
+ * Host stand-in for the NDK log header, so the library and the tests
+ * build without the NDK. Messages go to stderr, see android_log.c.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_TEST_ANDROID_LOG_H
+#define _EAS_TEST_ANDROID_LOG_H
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum android_LogPriority
+{
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT
+} android_LogPriority;
+
+int __android_log_write (int prio, const char *tag, const char *text);
+int __android_log_print (int prio, const char *tag, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+int __android_log_vprint (int prio, const char *tag, const char *fmt, va_list ap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EAS_TEST_ANDROID_LOG_H */
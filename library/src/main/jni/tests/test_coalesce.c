@@ -0,0 +1,223 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_coalesce.c
+ *
+ * Contents and purpose:
+ * Controller coalescing test. Writes controller, pitch bend and channel
+ * pressure messages to a MIDI stream with coalescing enabled and checks
+ * the synth channel state: the messages are held until the next render,
+ * a later note or program change on the same channel applies them
+ * first, a reset after them does not lose its effect, a SysEx message
+ * applies every channel first, and the collapsed count matches the
+ * messages replaced.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eas_test.h"
+#include "eas_data.h"
+#include "eas_synth.h"
+#include "eas_miditypes.h"
+
+/*----------------------------------------------------------------------------
+ * Write()
+ *----------------------------------------------------------------------------
+ * Writes MIDI bytes without rendering
+ *----------------------------------------------------------------------------
+*/
+static void Write (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, const EAS_U8 *pBuffer, EAS_I32 count, const char *pName)
+{
+    EAS_RESULT result;
+
+    result = EAS_WriteMIDIStream(pEASData, stream, (EAS_U8*) pBuffer, count);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: write error %ld", pName, (long) result);
+}
+
+/*----------------------------------------------------------------------------
+ * CheckCount()
+ *----------------------------------------------------------------------------
+*/
+static void CheckCount (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, EAS_I32 expected, const char *pName)
+{
+    EAS_RESULT result;
+    EAS_I32 count;
+
+    result = EAS_GetMIDIStreamCoalescedCount(pEASData, stream, &count);
+    EAS_TEST_CHECK((result == EAS_SUCCESS) && (count == expected),
+        "%s: coalesced count %ld, expected %ld", pName, (long) count, (long) expected);
+}
+
+/*----------------------------------------------------------------------------
+ * TestSysEx()
+ *----------------------------------------------------------------------------
+ * GM system on resets the channels when no voice is playing. Controllers
+ * held before it on any channel must be applied before the reset, not
+ * at the next render.
+ *----------------------------------------------------------------------------
+*/
+static void TestSysEx (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, S_SYNTH *pSynth)
+{
+    static const EAS_U8 held[] = { 0xb2, 0x07, 0x14, 0xe2, 0x00, 0x70, 0xd3, 0x50 };
+    static const EAS_U8 gmOn[] = { 0xf0, 0x7e, 0x7f, 0x09, 0x01, 0xf7 };
+
+    Write(pEASData, stream, held, sizeof(held), "held before SysEx");
+    EAS_TEST_CHECK(pSynth->channels[2].volume == DEFAULT_CHANNEL_VOLUME, "volume applied before the render");
+    EAS_TEST_CHECK(pSynth->channels[2].pitchBend == DEFAULT_PITCH_BEND, "pitch bend applied before the render");
+    EAS_TEST_CHECK(pSynth->channels[3].channelPressure == DEFAULT_CHANNEL_PRESSURE, "pressure applied before the render");
+
+    Write(pEASData, stream, gmOn, sizeof(gmOn), "GM on");
+    EAS_TestRender(pEASData, 1, NULL, NULL);
+    EAS_TEST_CHECK(pSynth->channels[2].volume == DEFAULT_CHANNEL_VOLUME,
+        "SysEx: volume %d after the reset", pSynth->channels[2].volume);
+    EAS_TEST_CHECK(pSynth->channels[2].pitchBend == DEFAULT_PITCH_BEND,
+        "SysEx: pitch bend 0x%x after the reset", pSynth->channels[2].pitchBend);
+    EAS_TEST_CHECK(pSynth->channels[3].channelPressure == DEFAULT_CHANNEL_PRESSURE,
+        "SysEx: pressure %d after the reset", pSynth->channels[3].channelPressure);
+    CheckCount(pEASData, stream, 0, "SysEx");
+}
+
+/*----------------------------------------------------------------------------
+ * TestChannel()
+ *----------------------------------------------------------------------------
+ * Held values are applied by the next note or program change on their
+ * channel, but not by messages on other channels
+ *----------------------------------------------------------------------------
+*/
+static void TestChannel (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, S_SYNTH *pSynth)
+{
+    static const EAS_U8 held[] =
+    {
+        0xb0, 0x07, 0x0a, 0x07, 0x14, 0x07, 0x1e,   /* volume 10, 20, 30 with running status */
+        0xe0, 0x00, 0x50, 0x00, 0x60,               /* bend */
+        0xd0, 0x40,                                 /* pressure */
+        0xb0, 0x0a, 0x20,                           /* pan */
+        0xb1, 0x07, 0x37                            /* volume on channel 1 */
+    };
+    static const EAS_U8 noteOn[] = { 0x90, 0x3c, 0x64 };
+    static const EAS_U8 program[] = { 0xc1, 0x05 };
+    static const EAS_U8 reset[] = { 0xe0, 0x00, 0x70, 0xb0, 0x79, 0x00 };
+    static const EAS_U8 noteOff[] = { 0x80, 0x3c, 0x40 };
+
+    Write(pEASData, stream, held, sizeof(held), "held");
+    EAS_TEST_CHECK(pSynth->channels[0].volume == DEFAULT_CHANNEL_VOLUME, "held: volume applied");
+    EAS_TEST_CHECK(pSynth->channels[0].pitchBend == DEFAULT_PITCH_BEND, "held: pitch bend applied");
+    EAS_TEST_CHECK(pSynth->channels[0].channelPressure == DEFAULT_CHANNEL_PRESSURE, "held: pressure applied");
+    EAS_TEST_CHECK(pSynth->channels[1].volume == DEFAULT_CHANNEL_VOLUME, "held: channel 1 volume applied");
+    CheckCount(pEASData, stream, 3, "held");
+
+    /* a note applies its own channel only */
+    Write(pEASData, stream, noteOn, sizeof(noteOn), "note on");
+    EAS_TEST_CHECK(pSynth->channels[0].volume == 0x1e, "note: volume %d, expected 30", pSynth->channels[0].volume);
+    EAS_TEST_CHECK(pSynth->channels[0].pitchBend == (0x60 << 7), "note: pitch bend 0x%x", pSynth->channels[0].pitchBend);
+    EAS_TEST_CHECK(pSynth->channels[0].channelPressure == 0x40, "note: pressure %d", pSynth->channels[0].channelPressure);
+    EAS_TEST_CHECK(pSynth->channels[0].pan == 0x20, "note: pan %d", pSynth->channels[0].pan);
+    EAS_TEST_CHECK(pSynth->channels[1].volume == DEFAULT_CHANNEL_VOLUME, "note: channel 1 volume applied");
+
+    /* so does a program change */
+    Write(pEASData, stream, program, sizeof(program), "program change");
+    EAS_TEST_CHECK(pSynth->channels[1].volume == 0x37, "program change: volume %d, expected 55", pSynth->channels[1].volume);
+
+    /* a bend held before reset all controllers must not survive it */
+    Write(pEASData, stream, reset, sizeof(reset), "reset");
+    EAS_TestRender(pEASData, 1, NULL, NULL);
+    EAS_TEST_CHECK(pSynth->channels[0].pitchBend == DEFAULT_PITCH_BEND,
+        "reset: pitch bend 0x%x after the reset", pSynth->channels[0].pitchBend);
+
+    Write(pEASData, stream, noteOff, sizeof(noteOff), "note off");
+    CheckCount(pEASData, stream, 3, "channel");
+}
+
+/*----------------------------------------------------------------------------
+ * TestCount()
+ *----------------------------------------------------------------------------
+ * Each replaced value counts once, values in other slots or applied in
+ * between do not count, and the render applies the latest value
+ *----------------------------------------------------------------------------
+*/
+static void TestCount (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, S_SYNTH *pSynth)
+{
+    static const EAS_U8 program[] = { 0xc4, 0x00 };
+    EAS_U8 buffer[32];
+    EAS_I32 count;
+    EAS_INT i;
+
+    /* ten bends, one applied by the render */
+    count = 0;
+    for (i = 0; i < 10; i++)
+    {
+        buffer[count++] = 0xe4;
+        buffer[count++] = 0;
+        buffer[count++] = (EAS_U8) (0x10 + i);
+    }
+    Write(pEASData, stream, buffer, count, "bends");
+    CheckCount(pEASData, stream, 12, "bends");
+    EAS_TestRender(pEASData, 1, NULL, NULL);
+    EAS_TEST_CHECK(pSynth->channels[4].pitchBend == (0x19 << 7), "bends: pitch bend 0x%x", pSynth->channels[4].pitchBend);
+
+    /* one of each, nothing collapsed */
+    Write(pEASData, stream, (const EAS_U8*) "\xb4\x01\x10\x07\x20\x0a\x30\x0b\x40\xd4\x50\xe4\x00\x40", 14, "one of each");
+    CheckCount(pEASData, stream, 12, "one of each");
+    EAS_TestRender(pEASData, 1, NULL, NULL);
+
+    /* the same value on both sides of a program change */
+    Write(pEASData, stream, (const EAS_U8*) "\xb4\x07\x20", 3, "before program change");
+    Write(pEASData, stream, program, sizeof(program), "program change");
+    Write(pEASData, stream, (const EAS_U8*) "\xb4\x07\x20", 3, "after program change");
+    CheckCount(pEASData, stream, 12, "program change");
+    EAS_TestRender(pEASData, 1, NULL, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (void)
+{
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    S_SYNTH *pSynth;
+
+    if ((pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) == NULL)
+        return 2;
+    result = EAS_OpenMIDIStream(pEASData, &stream, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    if (result == EAS_SUCCESS)
+    {
+        result = EAS_SetMIDIStreamCoalescing(pEASData, stream, EAS_TRUE);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "enable coalescing error %ld", (long) result);
+    }
+    if (result != EAS_SUCCESS)
+    {
+        EAS_Shutdown(pEASData);
+        return EAS_TestResult("test_coalesce");
+    }
+    pSynth = ((S_INTERACTIVE_MIDI*) stream->handle)->pSynth;
+
+    /* first, while no voice is playing */
+    TestSysEx(pEASData, stream, pSynth);
+    TestChannel(pEASData, stream, pSynth);
+    TestCount(pEASData, stream, pSynth);
+
+    EAS_CloseMIDIStream(pEASData, stream);
+    EAS_Shutdown(pEASData);
+    return EAS_TestResult("test_coalesce");
+}
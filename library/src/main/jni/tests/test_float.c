@@ -0,0 +1,133 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_float.c
+ *
+ * Contents and purpose:
+ * Float output test. Renders a MIDI file with EAS_Render in one instance
+ * and EAS_RenderFloat in another and checks that every float sample,
+ * scaled by 32768, is within 2 LSB of the 16-bit sample, and that the
+ * float output stays within +/-1.0.
+ *
+ * test_float file
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+
+/* largest difference allowed between the outputs, in 16-bit LSB */
+#define TEST_MAX_LSB            2.0
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    static EAS_PCM pcm[1024];
+    static EAS_FLOAT output[1024];
+    const S_EAS_LIB_CONFIG *pConfig;
+    S_EAS_TEST_FILE file;
+    EAS_DATA_HANDLE pInt;
+    EAS_DATA_HANDLE pFloat;
+    EAS_HANDLE intStream;
+    EAS_HANDLE floatStream;
+    EAS_RESULT result;
+    EAS_STATE state;
+    EAS_I32 numGenerated;
+    EAS_I32 numBuffers;
+    EAS_I32 tail;
+    EAS_I32 i;
+    double diff;
+    double maxDiff;
+    double peak;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s file\n", argv[0]);
+        return 2;
+    }
+    if (!EAS_TestLoadFile(argv[1], &file))
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 2;
+    }
+
+    pConfig = EAS_Config();
+    if ((pInt = EAS_TestInit(EAS_PARAM_REVERB_CHAMBER)) == NULL)
+        return 2;
+    if ((pFloat = EAS_TestInit(EAS_PARAM_REVERB_CHAMBER)) == NULL)
+    {
+        EAS_Shutdown(pInt);
+        return 2;
+    }
+    result = EAS_TestOpen(pInt, &file, EAS_FALSE, &intStream);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    if (result == EAS_SUCCESS)
+    {
+        result = EAS_TestOpen(pFloat, &file, EAS_FALSE, &floatStream);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+        if (result != EAS_SUCCESS)
+            EAS_CloseFile(pInt, intStream);
+    }
+
+    if (result == EAS_SUCCESS)
+    {
+        maxDiff = 0;
+        peak = 0;
+        numBuffers = 0;
+        tail = 0;
+        for (;;)
+        {
+            if ((result = EAS_Render(pInt, pcm, pConfig->mixBufferSize, &numGenerated)) != EAS_SUCCESS)
+                break;
+            if ((result = EAS_RenderFloat(pFloat, output, pConfig->mixBufferSize, &numGenerated)) != EAS_SUCCESS)
+                break;
+            numBuffers++;
+
+            for (i = 0; i < numGenerated * pConfig->numChannels; i++)
+            {
+                diff = fabs(output[i] * 32768.0 - pcm[i]);
+                if (diff > maxDiff)
+                    maxDiff = diff;
+                if (fabs(output[i]) > peak)
+                    peak = fabs(output[i]);
+            }
+
+            if ((result = EAS_State(pInt, intStream, &state)) != EAS_SUCCESS)
+                break;
+            if ((state == EAS_STATE_STOPPED) && (++tail > EAS_TEST_TAIL_BUFFERS))
+                break;
+        }
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+        EAS_TEST_CHECK(maxDiff <= TEST_MAX_LSB, "float output differs by %.2f LSB", maxDiff);
+        EAS_TEST_CHECK(peak <= 1.0, "float output peak %.3f", peak);
+        printf("%ld buffers, largest difference %.2f LSB, peak %.3f\n", (long) numBuffers, maxDiff, peak);
+        EAS_CloseFile(pInt, intStream);
+        EAS_CloseFile(pFloat, floatStream);
+    }
+    EAS_Shutdown(pFloat);
+    EAS_Shutdown(pInt);
+    free(file.pData);
+    return EAS_TestResult("test_float");
+}
@@ -0,0 +1,211 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_locate.c
+ *
+ * Contents and purpose:
+ * Locate and replay regression test. Plays a MIDI file with locates
+ * back and forth, plays it to the end and replays it from the start,
+ * and compares the hash of all the audio with the expected value.
+ * The timeline and checkpoints must not change the audio, so each file
+ * has one expected value. With checkpoints on, the locates after the
+ * file has played must start from a checkpoint.
+ *
+ * test_locate file|tempo hash [timeline] [checkpoints]
+ *
+ * "tempo" is a built in file that changes tempo after the first bar.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+#include "eas_data.h"
+#include "eas_parser.h"
+
+/* reads a parser parameter, from eas_public.c */
+extern EAS_RESULT EAS_GetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_I32 *pValue);
+
+/* buffers rendered between locates */
+#define TEST_LOCATE_BUFFERS     100
+
+/* checkpoint interval in milliseconds when checkpoints are on */
+#define TEST_CHECKPOINT_INTERVAL    2000
+
+/*----------------------------------------------------------------------------
+ * MakeTempoSMF()
+ *----------------------------------------------------------------------------
+ * Writes a type 0 file with a bar of notes at the default tempo, then a
+ * tempo change to 60 bpm and another bar. Returns the size of the file.
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 MakeTempoSMF (EAS_U8 *pBuffer)
+{
+    static const EAS_U8 header[] =
+    {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xe0,
+        'M', 'T', 'r', 'k', 0, 0, 0, 0
+    };
+    static const EAS_U8 tempo[] = { 0x00, 0xff, 0x51, 0x03, 0x0f, 0x42, 0x40 };
+    static const EAS_U8 end[] = { 0x00, 0xff, 0x2f, 0x00 };
+    EAS_U8 *p;
+    EAS_I32 size;
+    EAS_INT bar;
+    EAS_INT i;
+
+    memcpy(pBuffer, header, sizeof(header));
+    p = pBuffer + sizeof(header);
+    for (bar = 0; bar < 2; bar++)
+    {
+        if (bar == 1)
+        {
+            memcpy(p, tempo, sizeof(tempo));
+            p += sizeof(tempo);
+        }
+
+        /* four crotchets */
+        for (i = 0; i < 4; i++)
+        {
+            *p++ = 0x00;
+            *p++ = 0x90;
+            *p++ = (EAS_U8) (60 + 2 * i + bar);
+            *p++ = 0x64;
+            *p++ = 0x83;
+            *p++ = 0x60;
+            *p++ = 0x80;
+            *p++ = (EAS_U8) (60 + 2 * i + bar);
+            *p++ = 0x40;
+        }
+    }
+    memcpy(p, end, sizeof(end));
+    p += sizeof(end);
+
+    /* track length */
+    size = (EAS_I32) (p - pBuffer - sizeof(header));
+    pBuffer[18] = (EAS_U8) (size >> 24);
+    pBuffer[19] = (EAS_U8) (size >> 16);
+    pBuffer[20] = (EAS_U8) (size >> 8);
+    pBuffer[21] = (EAS_U8) size;
+    return (EAS_I32) (p - pBuffer);
+}
+
+/*----------------------------------------------------------------------------
+ * Locate()
+ *----------------------------------------------------------------------------
+ * Locates and renders TEST_LOCATE_BUFFERS buffers
+ *----------------------------------------------------------------------------
+*/
+static void Locate (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, EAS_I32 milliseconds, uint64_t *pHash)
+{
+    EAS_RESULT result;
+
+    result = EAS_Locate(pEASData, stream, milliseconds, EAS_FALSE);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "locate %ld error %ld", (long) milliseconds, (long) result);
+    result = EAS_TestRender(pEASData, TEST_LOCATE_BUFFERS, pHash, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    static EAS_U8 tempoFile[256];
+    S_EAS_TEST_FILE file;
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_I32 numBuffers;
+    EAS_BOOL timeline;
+    EAS_I32 interval;
+    EAS_I32 locates;
+    EAS_INT i;
+    uint64_t expected;
+    uint64_t hash;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s file|tempo hash [timeline] [checkpoints]\n", argv[0]);
+        return 2;
+    }
+    if (strcmp(argv[1], "tempo") == 0)
+        EAS_TestMemoryFile(&file, tempoFile, MakeTempoSMF(tempoFile));
+    else if (!EAS_TestLoadFile(argv[1], &file))
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 2;
+    }
+    expected = strtoull(argv[2], NULL, 16);
+    timeline = EAS_FALSE;
+    interval = 0;
+    for (i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "timeline") == 0)
+            timeline = EAS_TRUE;
+        else if (strcmp(argv[i], "checkpoints") == 0)
+            interval = TEST_CHECKPOINT_INTERVAL;
+    }
+
+    if ((pEASData = EAS_TestInit(EAS_PARAM_REVERB_CHAMBER)) == NULL)
+        return 2;
+    result = EAS_OpenFile(pEASData, &file.locator, &stream);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    if (result == EAS_SUCCESS)
+    {
+        if (interval > 0)
+            EAS_SetCheckpointInterval(pEASData, stream, interval);
+        if (timeline)
+            EAS_SetTimelineMode(pEASData, stream, EAS_TRUE);
+        result = EAS_Prepare(pEASData, stream);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "prepare error %ld", (long) result);
+
+        /* forward, back, then to the end and replay */
+        hash = EAS_TEST_HASH_INIT;
+        result = EAS_TestRender(pEASData, TEST_LOCATE_BUFFERS, &hash, NULL);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+        Locate(pEASData, stream, 6000, &hash);
+        Locate(pEASData, stream, 1500, &hash);
+        result = EAS_TestRenderFile(pEASData, stream, 0, &hash, &numBuffers);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+        Locate(pEASData, stream, 4500, &hash);
+        Locate(pEASData, stream, 0, &hash);
+        Locate(pEASData, stream, 500, &hash);
+
+        /* the locate to 4500 has a checkpoint from the first play */
+        if (interval > 0)
+        {
+            result = EAS_GetStreamParameter(pEASData, stream, PARSER_DATA_CHECKPOINT_LOCATES, &locates);
+            EAS_TEST_CHECK(result == EAS_SUCCESS, "checkpoint locates error %ld", (long) result);
+            EAS_TEST_CHECK(locates > 0, "no locate started from a checkpoint");
+            printf("%ld locates from a checkpoint\n", (long) locates);
+        }
+
+        EAS_TEST_CHECK(hash == expected, "hash %016llx, expected %016llx",
+            (unsigned long long) hash, (unsigned long long) expected);
+        printf("hash %016llx\n", (unsigned long long) hash);
+        EAS_CloseFile(pEASData, stream);
+    }
+    EAS_Shutdown(pEASData);
+    if (file.pData != tempoFile)
+        free(file.pData);
+    return EAS_TestResult("test_locate");
+}
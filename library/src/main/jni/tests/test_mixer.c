@@ -0,0 +1,145 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_mixer.c
+ *
+ * Contents and purpose:
+ * Checks the SIMD master gain kernels in eas_mixer_simd.c against the
+ * C loop, on random and full scale input, for every gain the kernels
+ * accept and for the lengths they turn down.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_mixer.h"
+
+#define TEST_MAX_SAMPLES        1024
+
+/*----------------------------------------------------------------------------
+ * RefMasterGain()
+ *----------------------------------------------------------------------------
+ * The C loop of SynthMasterGain
+ *----------------------------------------------------------------------------
+*/
+static void RefMasterGain (const EAS_MIX_SAMPLE *pInput, EAS_PCM *pOutput, EAS_U16 gain, EAS_I32 numSamples)
+{
+    int64_t s;
+    EAS_I32 i;
+
+    for (i = 0; i < numSamples; i++)
+    {
+        s = ((int64_t) (pInput[i] >> 7) * gain) >> 9;
+        if (s > 32767)
+            s = 32767;
+        else if (s < -32768)
+            s = -32768;
+        pOutput[i] = (EAS_PCM) s;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * FillInput()
+ *----------------------------------------------------------------------------
+ * Random samples over the full 32-bit range, with the extremes and
+ * the values around the rounding points of the split product mixed in
+ *----------------------------------------------------------------------------
+*/
+static void FillInput (EAS_MIX_SAMPLE *pInput, EAS_I32 numSamples, EAS_U32 *pSeed)
+{
+    static const EAS_MIX_SAMPLE special[] =
+    {
+        0, 1, -1, 127, 128, -128, -129, 65535, -65536, 0x7fffffff, (EAS_MIX_SAMPLE) 0x80000000,
+        0x0000ff80, (EAS_MIX_SAMPLE) 0xffff0080, 0x00ffff80, (EAS_MIX_SAMPLE) 0xff000080
+    };
+    EAS_I32 i;
+
+    for (i = 0; i < numSamples; i++)
+    {
+        switch (EAS_TestRandom(pSeed) % 4)
+        {
+            case 0:
+                pInput[i] = special[EAS_TestRandom(pSeed) % (sizeof(special) / sizeof(special[0]))];
+                break;
+            case 1:
+                /* typical mix levels */
+                pInput[i] = (EAS_MIX_SAMPLE) (EAS_TestRandom(pSeed) & 0x3fffff) - 0x200000;
+                break;
+            default:
+                pInput[i] = (EAS_MIX_SAMPLE) ((EAS_TestRandom(pSeed) << 8) ^ EAS_TestRandom(pSeed));
+                break;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (void)
+{
+    EAS_MIX_SAMPLE input[TEST_MAX_SAMPLES];
+    EAS_PCM expected[TEST_MAX_SAMPLES];
+    EAS_PCM output[TEST_MAX_SAMPLES + 8];
+    EAS_U32 seed;
+    EAS_I32 numSamples;
+    EAS_I32 gain;
+    EAS_I32 numChecked;
+
+    seed = 1;
+    numChecked = 0;
+
+    /* every gain the kernels accept, and the ones they turn down */
+    for (gain = 0; gain <= 0xffff; gain += (gain < 0x8100) ? 1 : 0x3f)
+    {
+        numSamples = 8 * (EAS_I32) (1 + EAS_TestRandom(&seed) % (TEST_MAX_SAMPLES / 8));
+        FillInput(input, numSamples, &seed);
+        RefMasterGain(input, expected, (EAS_U16) gain, numSamples);
+        memset(output, 0x55, sizeof(output));
+        if (EAS_SIMDMasterGain(input, output, (EAS_U16) gain, numSamples))
+        {
+            EAS_TEST_CHECK(gain <= 0x7fff, "kernel ran with gain 0x%lx", (long) gain);
+            EAS_TEST_CHECK(memcmp(output, expected, sizeof(EAS_PCM) * (size_t) numSamples) == 0,
+                "kernel differs from the C loop at gain 0x%lx", (long) gain);
+            EAS_TEST_CHECK(output[numSamples] == 0x5555, "kernel wrote past %ld samples", (long) numSamples);
+            numChecked++;
+        }
+
+        /* the library entry point, SIMD or not */
+        SynthMasterGain(input, output, (EAS_U16) gain, (EAS_U16) numSamples);
+        EAS_TEST_CHECK(memcmp(output, expected, sizeof(EAS_PCM) * (size_t) numSamples) == 0,
+            "SynthMasterGain differs from the C loop at gain 0x%lx", (long) gain);
+    }
+
+    /* lengths that are not a multiple of 8 go to the C loop */
+    for (numSamples = 1; numSamples < 64; numSamples++)
+    {
+        FillInput(input, numSamples, &seed);
+        RefMasterGain(input, expected, 0x4000, numSamples);
+        EAS_TEST_CHECK(((numSamples & 7) == 0) || !EAS_SIMDMasterGain(input, output, 0x4000, numSamples),
+            "kernel accepted %ld samples", (long) numSamples);
+        SynthMasterGain(input, output, 0x4000, (EAS_U16) numSamples);
+        EAS_TEST_CHECK(memcmp(output, expected, sizeof(EAS_PCM) * (size_t) numSamples) == 0,
+            "SynthMasterGain differs from the C loop for %ld samples", (long) numSamples);
+    }
+
+    printf("%ld buffers checked against the SIMD kernel\n", (long) numChecked);
+    return EAS_TestResult("test_mixer");
+}
@@ -0,0 +1,293 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_parse.c
+ *
+ * Contents and purpose:
+ * MIDI byte parser equivalence test. Feeds random streams of channel
+ * messages, with and without running status, timing clock and active
+ * sensing inside messages, system common and SysEx messages, to one
+ * instance a byte at a time through EAS_ParseMIDIStream and to another
+ * through EAS_ParseMIDIBuffer, in writes of random size so messages are
+ * split across writes. Both instances render a buffer after each write
+ * and must render the same audio.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_data.h"
+#include "eas_synth.h"
+#include "eas_parser.h"
+#include "eas_midi.h"
+
+/* gets the synth of a stream, from eas_public.c */
+extern EAS_RESULT EAS_GetStreamParameter (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_I32 param, EAS_I32 *pValue);
+
+#define TEST_STREAM_SIZE        8192
+#define TEST_MAX_WRITE          48
+#define TEST_STREAMS            8
+
+/* an instance with a stream parsed by one of the parsers */
+typedef struct
+{
+    EAS_DATA_HANDLE     pEASData;
+    EAS_HANDLE          handle;
+    S_SYNTH             *pSynth;
+    S_MIDI_STREAM       stream;
+    uint64_t            hash;
+} S_TEST_PARSER;
+
+static const EAS_U8 controllers[] = { 0, 1, 6, 7, 10, 11, 32, 64, 91, 100, 101, 121, 123 };
+
+/*----------------------------------------------------------------------------
+ * PutData()
+ *----------------------------------------------------------------------------
+ * Writes a data byte, sometimes after a timing clock or active sensing
+ * byte, which must not disturb the message it interrupts
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 PutData (EAS_U8 *pBuffer, EAS_I32 i, EAS_U8 data, EAS_U32 *pSeed)
+{
+    EAS_U32 r;
+
+    r = EAS_TestRandom(pSeed);
+    if ((r & 7) == 0)
+        pBuffer[i++] = (r & 8) ? 0xfe : 0xf8;
+    pBuffer[i++] = data;
+    return i;
+}
+
+/*----------------------------------------------------------------------------
+ * MakeStream()
+ *----------------------------------------------------------------------------
+ * Random channel messages on a few channels, using running status half
+ * of the time, with real-time bytes, tune requests, master volume and
+ * GM system on SysEx messages and SysEx messages for other devices
+ *----------------------------------------------------------------------------
+*/
+static void MakeStream (EAS_U8 *pBuffer, EAS_I32 size, EAS_U32 seed)
+{
+    EAS_I32 i;
+    EAS_I32 n;
+    EAS_U32 r;
+    EAS_U8 status;
+    EAS_U8 d1;
+    EAS_U8 d2;
+
+    i = 0;
+    status = 0;
+    while (i + 32 <= size)
+    {
+        r = EAS_TestRandom(&seed);
+        switch (r % 16)
+        {
+            case 12:
+                pBuffer[i++] = (r & 16) ? 0xfe : 0xf8;
+                break;
+
+            case 13:
+                /* tune request cancels running status */
+                pBuffer[i++] = 0xf6;
+                status = 0;
+                break;
+
+            case 14:
+                pBuffer[i++] = 0xf0;
+                if (r & 16)
+                {
+                    /* master volume */
+                    i = PutData(pBuffer, i, 0x7f, &seed);
+                    i = PutData(pBuffer, i, 0x7f, &seed);
+                    i = PutData(pBuffer, i, 0x04, &seed);
+                    i = PutData(pBuffer, i, 0x01, &seed);
+                    i = PutData(pBuffer, i, (EAS_U8) ((r >> 8) & 0x7f), &seed);
+                    i = PutData(pBuffer, i, (EAS_U8) (64 + (r >> 16) % 64), &seed);
+                }
+                else if (r & 32)
+                {
+                    /* GM system on */
+                    i = PutData(pBuffer, i, 0x7e, &seed);
+                    i = PutData(pBuffer, i, 0x7f, &seed);
+                    i = PutData(pBuffer, i, 0x09, &seed);
+                    i = PutData(pBuffer, i, 0x01, &seed);
+                }
+                else
+                {
+                    for (n = (EAS_I32) ((r >> 8) % 12); n >= 0; n--)
+                        i = PutData(pBuffer, i, (EAS_U8) (EAS_TestRandom(&seed) & 0x7f), &seed);
+                }
+                pBuffer[i++] = 0xf7;
+                status = 0;
+                break;
+
+            case 15:
+                /* data without a status is ignored */
+                if (status == 0)
+                    pBuffer[i++] = (EAS_U8) ((r >> 8) & 0x7f);
+                break;
+
+            default:
+                /* a channel message, with running status half of the time */
+                if ((status == 0) || (r & 16))
+                {
+                    status = (EAS_U8) ((0x80 + ((r >> 5) % 7) * 0x10) | ((r >> 8) & 3));
+                    if ((r & 0x700) == 0)
+                        status = (EAS_U8) ((status & 0xf0) | 9);
+                    pBuffer[i++] = status;
+                }
+                r = EAS_TestRandom(&seed);
+                switch (status & 0xf0)
+                {
+                    case 0x80:
+                    case 0x90:
+                    case 0xa0:
+                        d1 = (EAS_U8) (36 + (r & 0xff) % 48);
+                        d2 = (EAS_U8) ((r >> 8) & 0x7f);
+                        if ((r & 0x30000) == 0)
+                            d2 = 0;
+                        break;
+                    case 0xb0:
+                        d1 = controllers[(r & 0xff) % sizeof(controllers)];
+                        d2 = (EAS_U8) ((r >> 8) & 0x7f);
+                        if ((d1 == 0) || (d1 == 32))
+                            d2 = 0;
+                        break;
+                    case 0xc0:
+                        d1 = (EAS_U8) ((r >> 8) & 0x7f);
+                        d2 = 0;
+                        break;
+                    default:
+                        d1 = (EAS_U8) (r & 0x7f);
+                        d2 = (EAS_U8) ((r >> 8) & 0x7f);
+                        break;
+                }
+                i = PutData(pBuffer, i, d1, &seed);
+                if (((status & 0xf0) != 0xc0) && ((status & 0xf0) != 0xd0))
+                    i = PutData(pBuffer, i, d2, &seed);
+                break;
+        }
+    }
+    while (i < size)
+        pBuffer[i++] = 0xf8;
+}
+
+/*----------------------------------------------------------------------------
+ * OpenParser()
+ *----------------------------------------------------------------------------
+ * Creates an instance with a MIDI stream for its synth, and a stream
+ * state of its own for the parser under test. Returns EAS_FALSE on
+ * failure.
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL OpenParser (S_TEST_PARSER *pParser)
+{
+    EAS_I32 value;
+
+    if ((pParser->pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) == NULL)
+        return EAS_FALSE;
+    if ((EAS_OpenMIDIStream(pParser->pEASData, &pParser->handle, NULL) != EAS_SUCCESS) ||
+        (EAS_GetStreamParameter(pParser->pEASData, pParser->handle, PARSER_DATA_SYNTH_HANDLE, &value) != EAS_SUCCESS))
+    {
+        EAS_TEST_CHECK(0, "cannot open a MIDI stream");
+        EAS_Shutdown(pParser->pEASData);
+        return EAS_FALSE;
+    }
+    pParser->pSynth = (S_SYNTH*) value;
+    memset(&pParser->stream, 0, sizeof(pParser->stream));
+    EAS_InitMIDIStream(&pParser->stream);
+    pParser->hash = EAS_TEST_HASH_INIT;
+    return EAS_TRUE;
+}
+
+static void CloseParser (S_TEST_PARSER *pParser)
+{
+    EAS_CloseMIDIStream(pParser->pEASData, pParser->handle);
+    EAS_Shutdown(pParser->pEASData);
+}
+
+/*----------------------------------------------------------------------------
+ * TestStream()
+ *----------------------------------------------------------------------------
+*/
+static void TestStream (EAS_U32 seed)
+{
+    static EAS_U8 buffer[TEST_STREAM_SIZE];
+    S_TEST_PARSER byte;
+    S_TEST_PARSER bulk;
+    EAS_RESULT byteResult;
+    EAS_RESULT bulkResult;
+    EAS_U32 writeSeed;
+    EAS_I32 offset;
+    EAS_I32 count;
+    EAS_I32 i;
+
+    MakeStream(buffer, TEST_STREAM_SIZE, seed);
+    if (!OpenParser(&byte))
+        return;
+    if (!OpenParser(&bulk))
+    {
+        CloseParser(&byte);
+        return;
+    }
+
+    writeSeed = seed;
+    for (offset = 0; offset < TEST_STREAM_SIZE; offset += count)
+    {
+        count = 1 + (EAS_I32) (EAS_TestRandom(&writeSeed) % TEST_MAX_WRITE);
+        if (count > TEST_STREAM_SIZE - offset)
+            count = TEST_STREAM_SIZE - offset;
+
+        byteResult = EAS_SUCCESS;
+        for (i = 0; (i < count) && (byteResult == EAS_SUCCESS); i++)
+            byteResult = EAS_ParseMIDIStream(byte.pEASData, byte.pSynth, &byte.stream, buffer[offset + i], eParserModePlay);
+        bulkResult = EAS_ParseMIDIBuffer(bulk.pEASData, bulk.pSynth, &bulk.stream, buffer + offset, count, eParserModePlay);
+        EAS_TEST_CHECK((byteResult == EAS_SUCCESS) && (bulkResult == EAS_SUCCESS),
+            "seed %lu offset %ld: parse error %ld/%ld", (unsigned long) seed, (long) offset, (long) byteResult, (long) bulkResult);
+
+        EAS_TestRender(byte.pEASData, 1, &byte.hash, NULL);
+        EAS_TestRender(bulk.pEASData, 1, &bulk.hash, NULL);
+        if (byte.hash != bulk.hash)
+        {
+            EAS_TEST_CHECK(0, "seed %lu: renders differ after the write at offset %ld", (unsigned long) seed, (long) offset);
+            break;
+        }
+    }
+    EAS_TEST_CHECK(byte.pSynth->totalNoteCount > 0, "seed %lu: no notes played", (unsigned long) seed);
+    EAS_TEST_CHECK(memcmp(&byte.stream, &bulk.stream, sizeof(byte.stream)) == 0,
+        "seed %lu: parser states differ", (unsigned long) seed);
+
+    CloseParser(&bulk);
+    CloseParser(&byte);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (void)
+{
+    EAS_U32 seed;
+
+    for (seed = 1; seed <= TEST_STREAMS; seed++)
+        TestStream(seed);
+    return EAS_TestResult("test_parse");
+}
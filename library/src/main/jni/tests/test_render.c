@@ -0,0 +1,80 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_render.c
+ *
+ * Contents and purpose:
+ * Golden output test. Renders a MIDI file with the chamber reverb,
+ * the way the render tool does, and compares the hash of the audio
+ * with the expected value.
+ *
+ * test_render file hash [timeline]
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    S_EAS_TEST_FILE file;
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_I32 numBuffers;
+    uint64_t expected;
+    uint64_t hash;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s file hash [timeline]\n", argv[0]);
+        return 2;
+    }
+    if (!EAS_TestLoadFile(argv[1], &file))
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 2;
+    }
+    expected = strtoull(argv[2], NULL, 16);
+
+    if ((pEASData = EAS_TestInit(EAS_PARAM_REVERB_CHAMBER)) == NULL)
+        return 2;
+    result = EAS_TestOpen(pEASData, &file, (argc > 3) && (strcmp(argv[3], "timeline") == 0), &stream);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    if (result == EAS_SUCCESS)
+    {
+        hash = EAS_TEST_HASH_INIT;
+        result = EAS_TestRenderFile(pEASData, stream, EAS_TEST_TAIL_BUFFERS, &hash, &numBuffers);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+        EAS_TEST_CHECK(hash == expected, "hash %016llx, expected %016llx",
+            (unsigned long long) hash, (unsigned long long) expected);
+        printf("%ld buffers, hash %016llx\n", (long) numBuffers, (unsigned long long) hash);
+        EAS_CloseFile(pEASData, stream);
+    }
+    EAS_Shutdown(pEASData);
+    free(file.pData);
+    return EAS_TestResult("test_render");
+}
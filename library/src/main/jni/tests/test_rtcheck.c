@@ -0,0 +1,199 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_rtcheck.c
+ *
+ * Contents and purpose:
+ * Render path check, built against the library with _RT_CHECK. Plays a
+ * MIDI file while writing notes, controllers, SysEx and MIDI 2.0 packets
+ * to a live stream with coalescing on between buffers, rendering both
+ * 16-bit and float output, and checks that nothing on the render path
+ * allocated, logged or locked.
+ *
+ * test_rtcheck file
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+#include "eas_rtcheck.h"
+
+/* buffers rendered after the file stops, to let the live notes end */
+#define TEST_TAIL_BUFFERS       200
+
+/*----------------------------------------------------------------------------
+ * WriteLive()
+ *----------------------------------------------------------------------------
+ * Writes some live MIDI for one buffer, chosen from the seed
+ *----------------------------------------------------------------------------
+*/
+static void WriteLive (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, EAS_U32 *pSeed)
+{
+    EAS_U8 buffer[16];
+    EAS_UMP_WORD words[2];
+    EAS_RESULT result;
+    EAS_U32 r;
+    EAS_I32 count;
+
+    r = EAS_TestRandom(pSeed);
+    count = 0;
+    switch (r % 8)
+    {
+        case 0:
+            buffer[count++] = 0x9a;
+            buffer[count++] = (EAS_U8) (48 + (r >> 8) % 24);
+            buffer[count++] = (EAS_U8) (1 + (r >> 16) % 127);
+            break;
+        case 1:
+            buffer[count++] = 0x8a;
+            buffer[count++] = (EAS_U8) (48 + (r >> 8) % 24);
+            buffer[count++] = 0x40;
+            break;
+        case 2:
+            buffer[count++] = 0xba;
+            buffer[count++] = 0x07;
+            buffer[count++] = (EAS_U8) ((r >> 8) & 0x7f);
+            buffer[count++] = 0x07;
+            buffer[count++] = (EAS_U8) ((r >> 16) & 0x7f);
+            break;
+        case 3:
+            buffer[count++] = 0xea;
+            buffer[count++] = (EAS_U8) ((r >> 8) & 0x7f);
+            buffer[count++] = (EAS_U8) ((r >> 16) & 0x7f);
+            buffer[count++] = 0xda;
+            buffer[count++] = (EAS_U8) ((r >> 24) & 0x7f);
+            break;
+        case 4:
+            /* master volume */
+            buffer[count++] = 0xf0;
+            buffer[count++] = 0x7f;
+            buffer[count++] = 0x7f;
+            buffer[count++] = 0x04;
+            buffer[count++] = 0x01;
+            buffer[count++] = 0x00;
+            buffer[count++] = (EAS_U8) (96 + (r >> 8) % 32);
+            buffer[count++] = 0xf7;
+            break;
+        case 5:
+            /* MIDI 2.0 note on and pitch bend */
+            words[0] = (EAS_UMP_WORD) ((0x4u << 28) | (0x9u << 20) | (0xbu << 16) | ((48 + (r >> 8) % 24) << 8));
+            words[1] = (EAS_UMP_WORD) (r & 0xffff0000u);
+            result = EAS_WriteUMPStream(pEASData, stream, words, 2);
+            EAS_TEST_CHECK(result == EAS_SUCCESS, "UMP write error %ld", (long) result);
+            return;
+        case 6:
+            words[0] = (EAS_UMP_WORD) ((0x4u << 28) | (0xeu << 20) | (0xbu << 16));
+            words[1] = (EAS_UMP_WORD) r;
+            result = EAS_WriteUMPStream(pEASData, stream, words, 2);
+            EAS_TEST_CHECK(result == EAS_SUCCESS, "UMP write error %ld", (long) result);
+            return;
+        default:
+            return;
+    }
+    result = EAS_WriteMIDIStream(pEASData, stream, buffer, count);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "write error %ld", (long) result);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    static EAS_FLOAT floatBuffer[1024];
+    S_EAS_TEST_FILE file;
+    S_EAS_RT_SITE sites[EAS_RT_MAX_SITES];
+    EAS_DATA_HANDLE pEASData;
+    const S_EAS_LIB_CONFIG *pConfig;
+    EAS_HANDLE stream;
+    EAS_HANDLE live;
+    EAS_RESULT result;
+    EAS_STATE state;
+    EAS_I32 numBuffers;
+    EAS_I32 numGenerated;
+    EAS_I32 tail;
+    EAS_U32 seed;
+    int numSites;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s file\n", argv[0]);
+        return 2;
+    }
+    if (!EAS_TestLoadFile(argv[1], &file))
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 2;
+    }
+
+    /* the check itself must record a site from the render path */
+    EAS_RT_ENTER();
+    EAS_RT_CHECK("test");
+    EAS_RT_LEAVE();
+    EAS_RT_CHECK("test outside the render path");
+    numSites = EAS_HWRTGetSites(sites, EAS_RT_MAX_SITES);
+    EAS_TEST_CHECK(numSites == 1, "check recorded %d sites, expected 1", numSites);
+    EAS_HWRTClearSites();
+
+    if ((pEASData = EAS_TestInit(EAS_PARAM_REVERB_CHAMBER)) == NULL)
+        return 2;
+    pConfig = EAS_Config();
+    result = EAS_TestOpen(pEASData, &file, EAS_FALSE, &stream);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    if (result == EAS_SUCCESS)
+    {
+        result = EAS_OpenMIDIStream(pEASData, &live, NULL);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "open MIDI stream error %ld", (long) result);
+    }
+    if (result == EAS_SUCCESS)
+    {
+        EAS_SetMIDIStreamCoalescing(pEASData, live, EAS_TRUE);
+        seed = 1;
+        numBuffers = 0;
+        tail = 0;
+        for (;;)
+        {
+            WriteLive(pEASData, live, &seed);
+            if (numBuffers % 4 == 3)
+                result = EAS_RenderFloat(pEASData, floatBuffer, pConfig->mixBufferSize, &numGenerated);
+            else
+                result = EAS_TestRender(pEASData, 1, NULL, NULL);
+            if (result != EAS_SUCCESS)
+                break;
+            numBuffers++;
+            if ((result = EAS_State(pEASData, stream, &state)) != EAS_SUCCESS)
+                break;
+            if ((state == EAS_STATE_STOPPED) && (++tail > TEST_TAIL_BUFFERS))
+                break;
+        }
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+        printf("%ld buffers\n", (long) numBuffers);
+        EAS_CloseMIDIStream(pEASData, live);
+        EAS_CloseFile(pEASData, stream);
+    }
+    EAS_Shutdown(pEASData);
+    free(file.pData);
+
+    numSites = EAS_HWRTGetSites(sites, EAS_RT_MAX_SITES);
+    EAS_TEST_CHECK(numSites == 0, "%d call sites reached from the render path", numSites);
+    EAS_HWRTReport(stdout);
+    return EAS_TestResult("test_rtcheck");
+}
@@ -0,0 +1,248 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_state.c
+ *
+ * Contents and purpose:
+ * Save and restore regression test. Plays a generated MIDI file through
+ * a generated DLS collection, saves the state and checks that restoring
+ * it into the same instance, or into another one with the same file and
+ * collection, renders the same audio as carrying on after the save. A
+ * damaged state, a state that does not fit the file and a collection
+ * with other content must be rejected without changing the instance.
+ * Each check runs with the timeline off and on.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_reverb.h"
+
+#define TEST_SMF_SIZE           (64 * 1024)
+
+/* buffers rendered before the save and compared after it */
+#define TEST_SAVE_BUFFERS       400
+#define TEST_COMPARE_BUFFERS    300
+
+/* an instance playing one file through one collection */
+typedef struct
+{
+    EAS_DATA_HANDLE     pEASData;
+    EAS_HANDLE          stream;
+    S_EAS_TEST_FILE     dls;
+    S_EAS_TEST_FILE     smf;
+} S_TEST_INSTANCE;
+
+static EAS_U8 dls[EAS_TEST_DLS_SIZE];
+static EAS_U8 dlsCopy[EAS_TEST_DLS_SIZE];
+static EAS_U8 otherDLS[EAS_TEST_DLS_SIZE];
+static EAS_U8 smf[TEST_SMF_SIZE];
+static EAS_U8 shortSMF[TEST_SMF_SIZE];
+
+/*----------------------------------------------------------------------------
+ * OpenInstance()
+ *----------------------------------------------------------------------------
+ * Creates an instance, loads the collection and opens and prepares the
+ * file. Returns EAS_FALSE on failure.
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL OpenInstance (S_TEST_INSTANCE *pInst, EAS_U8 *pDLS, EAS_I32 dlsSize, EAS_U8 *pSMF, EAS_I32 smfSize, EAS_BOOL timeline)
+{
+    EAS_RESULT result;
+
+    if ((pInst->pEASData = EAS_TestInit(EAS_PARAM_REVERB_HALL)) == NULL)
+        return EAS_FALSE;
+    EAS_TestMemoryFile(&pInst->dls, pDLS, dlsSize);
+    EAS_TestMemoryFile(&pInst->smf, pSMF, smfSize);
+    result = EAS_LoadDLSCollection(pInst->pEASData, NULL, &pInst->dls.locator);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "load DLS error %ld", (long) result);
+    if (result == EAS_SUCCESS)
+    {
+        result = EAS_TestOpen(pInst->pEASData, &pInst->smf, timeline, &pInst->stream);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    }
+    if (result != EAS_SUCCESS)
+    {
+        EAS_Shutdown(pInst->pEASData);
+        return EAS_FALSE;
+    }
+    return EAS_TRUE;
+}
+
+static void CloseInstance (S_TEST_INSTANCE *pInst)
+{
+    EAS_CloseFile(pInst->pEASData, pInst->stream);
+    EAS_Shutdown(pInst->pEASData);
+}
+
+/*----------------------------------------------------------------------------
+ * SaveState()
+ *----------------------------------------------------------------------------
+ * Returns the state of the instance in a buffer the caller frees
+ *----------------------------------------------------------------------------
+*/
+static EAS_U8 *SaveState (EAS_DATA_HANDLE pEASData, EAS_I32 *pSize)
+{
+    EAS_RESULT result;
+    EAS_U8 *pState;
+
+    result = EAS_SaveState(pEASData, NULL, 0, pSize);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "measure state error %ld", (long) result);
+    if ((result != EAS_SUCCESS) || ((pState = malloc((size_t) *pSize)) == NULL))
+        return NULL;
+    result = EAS_SaveState(pEASData, pState, *pSize, pSize);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "save state error %ld", (long) result);
+    return pState;
+}
+
+/*----------------------------------------------------------------------------
+ * Render()
+ *----------------------------------------------------------------------------
+ * Returns the hash of the next TEST_COMPARE_BUFFERS buffers
+ *----------------------------------------------------------------------------
+*/
+static uint64_t Render (EAS_DATA_HANDLE pEASData)
+{
+    EAS_RESULT result;
+    uint64_t hash;
+
+    hash = EAS_TEST_HASH_INIT;
+    result = EAS_TestRender(pEASData, TEST_COMPARE_BUFFERS, &hash, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+    return hash;
+}
+
+/*----------------------------------------------------------------------------
+ * CheckRejected()
+ *----------------------------------------------------------------------------
+ * Checks that a restore fails with the expected error and leaves the
+ * instance as it was, by comparing the audio after it with the audio
+ * after restoring the instance's own state
+ *----------------------------------------------------------------------------
+*/
+static void CheckRejected (S_TEST_INSTANCE *pInst, const EAS_U8 *pState, EAS_I32 size, EAS_RESULT expected, const char *pName)
+{
+    EAS_RESULT result;
+    EAS_U8 *pOwnState;
+    EAS_I32 ownSize;
+    uint64_t hash;
+
+    if ((pOwnState = SaveState(pInst->pEASData, &ownSize)) == NULL)
+        return;
+    result = EAS_RestoreState(pInst->pEASData, pState, size);
+    EAS_TEST_CHECK(result == expected, "%s: restore returned %ld, expected %ld", pName, (long) result, (long) expected);
+    hash = Render(pInst->pEASData);
+
+    result = EAS_RestoreState(pInst->pEASData, pOwnState, ownSize);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: restore own state error %ld", pName, (long) result);
+    EAS_TEST_CHECK(Render(pInst->pEASData) == hash, "%s: rejected restore changed the instance", pName);
+    free(pOwnState);
+}
+
+/*----------------------------------------------------------------------------
+ * TestState()
+ *----------------------------------------------------------------------------
+*/
+static void TestState (EAS_I32 dlsSize, EAS_I32 otherSize, EAS_I32 smfSize, EAS_I32 shortSize, EAS_BOOL timeline)
+{
+    S_TEST_INSTANCE inst;
+    S_TEST_INSTANCE other;
+    EAS_RESULT result;
+    EAS_U8 *pState;
+    EAS_I32 size;
+    uint64_t expected;
+
+    printf("timeline %s\n", timeline ? "on" : "off");
+    if (!OpenInstance(&inst, dls, dlsSize, smf, smfSize, timeline))
+        return;
+    result = EAS_TestRender(inst.pEASData, TEST_SAVE_BUFFERS, NULL, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+    if ((pState = SaveState(inst.pEASData, &size)) == NULL)
+    {
+        CloseInstance(&inst);
+        return;
+    }
+    expected = Render(inst.pEASData);
+
+    /* back to the save in the same instance */
+    result = EAS_RestoreState(inst.pEASData, pState, size);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "restore error %ld", (long) result);
+    EAS_TEST_CHECK(Render(inst.pEASData) == expected, "restore into the same instance renders differently");
+
+    /* a damaged state */
+    pState[size - 1] ^= 0x55;
+    CheckRejected(&inst, pState, size, EAS_ERROR_DATA_INCONSISTENCY, "damaged");
+    pState[size - 1] ^= 0x55;
+    CloseInstance(&inst);
+
+    /* another instance with its own copy of the collection */
+    if (OpenInstance(&other, dlsCopy, dlsSize, smf, smfSize, timeline))
+    {
+        result = EAS_RestoreState(other.pEASData, pState, size);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "restore into another instance error %ld", (long) result);
+        EAS_TEST_CHECK(Render(other.pEASData) == expected, "restore into another instance renders differently");
+        CloseInstance(&other);
+    }
+
+    /* a collection of the same shape with other samples */
+    if (OpenInstance(&other, otherDLS, otherSize, smf, smfSize, timeline))
+    {
+        CheckRejected(&other, pState, size, EAS_ERROR_SOUND_LIBRARY, "other collection");
+        CloseInstance(&other);
+    }
+
+    /* a file with the same tracks that ends before the saved positions */
+    if (OpenInstance(&other, dls, dlsSize, shortSMF, shortSize, timeline))
+    {
+        result = EAS_TestRender(other.pEASData, TEST_SAVE_BUFFERS / 4, NULL, NULL);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "render error %ld", (long) result);
+        CheckRejected(&other, pState, size, EAS_ERROR_DATA_INCONSISTENCY, "short file");
+        CloseInstance(&other);
+    }
+    free(pState);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (void)
+{
+    EAS_I32 dlsSize;
+    EAS_I32 otherSize;
+    EAS_I32 smfSize;
+    EAS_I32 shortSize;
+
+    dlsSize = EAS_TestMakeDLS(dls, EAS_TEST_DLS_SIZE, 1);
+    otherSize = EAS_TestMakeDLS(otherDLS, EAS_TEST_DLS_SIZE, 2);
+    smfSize = EAS_TestMakeSMF(smf, TEST_SMF_SIZE, 1, 8, 200);
+    shortSize = EAS_TestMakeSMF(shortSMF, TEST_SMF_SIZE, 2, 8, 4);
+    if ((dlsSize == 0) || (otherSize == 0) || (smfSize == 0) || (shortSize == 0))
+    {
+        fprintf(stderr, "Generated files too large\n");
+        return 2;
+    }
+    memcpy(dlsCopy, dls, (size_t) dlsSize);
+
+    TestState(dlsSize, otherSize, smfSize, shortSize, EAS_FALSE);
+    TestState(dlsSize, otherSize, smfSize, shortSize, EAS_TRUE);
+    return EAS_TestResult("test_state");
+}
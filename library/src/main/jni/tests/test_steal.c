@@ -0,0 +1,184 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_steal.c
+ *
+ * Contents and purpose:
+ * Voice stealing policy tests. Limits a MIDI stream to a few voices,
+ * plays one note more than that and checks which note was stolen for
+ * each EAS_STEAL_POLICY value.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eas_test.h"
+#include "eas_data.h"
+#include "eas_synth.h"
+#include "eas_parser.h"
+
+/* sets the polyphony of the stream's synth, from eas_public.c */
+extern EAS_RESULT EAS_IntSetStrmParam (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS_INT param, EAS_I32 value);
+
+/* voices available to the stream */
+#define TEST_POLYPHONY          4
+
+/* buffers rendered after each note, so every note has sounded */
+#define TEST_NOTE_BUFFERS       8
+
+/* for TestPolicy when the new note replaces a matching note */
+#define NO_NOTE_STOLEN          -1
+
+/* a note to play, in the order played */
+typedef struct
+{
+    EAS_U8 channel;
+    EAS_U8 note;
+    EAS_U8 velocity;
+} S_TEST_NOTE;
+
+/*----------------------------------------------------------------------------
+ * IsSounding()
+ *----------------------------------------------------------------------------
+ * Returns EAS_TRUE if a voice is starting or playing a note
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL IsSounding (S_VOICE_MGR *pVoiceMgr, EAS_U8 channel, EAS_U8 note)
+{
+    S_SYNTH_VOICE *pVoice;
+    EAS_INT i;
+
+    for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
+        pVoice = &pVoiceMgr->voices[i];
+        if ((pVoice->voiceState == eVoiceStateStolen) &&
+            (GET_CHANNEL(pVoice->nextChannel) == channel) && (pVoice->nextNote == note))
+            return EAS_TRUE;
+        if (((pVoice->voiceState == eVoiceStateStart) || (pVoice->voiceState == eVoiceStatePlay)) &&
+            (GET_CHANNEL(pVoice->channel) == channel) && (pVoice->note == note))
+            return EAS_TRUE;
+    }
+    return EAS_FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * TestPolicy()
+ *----------------------------------------------------------------------------
+ * Plays TEST_POLYPHONY + 1 notes with a policy and checks that the
+ * stolen note has stopped and the others are still sounding. The same
+ * note played again replaces the old one, so nothing else stops.
+ *----------------------------------------------------------------------------
+*/
+static void TestPolicy (const char *pName, EAS_I32 policy, const S_TEST_NOTE *pNotes, EAS_INT stolen)
+{
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_U8 message[3];
+    EAS_INT i;
+
+    if ((pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) == NULL)
+    {
+        EAS_TEST_CHECK(0, "%s: init failed", pName);
+        return;
+    }
+    result = EAS_OpenMIDIStream(pEASData, &stream, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: open error %ld", pName, (long) result);
+    if (result != EAS_SUCCESS)
+    {
+        EAS_Shutdown(pEASData);
+        return;
+    }
+    EAS_TEST_CHECK(EAS_SetVoiceStealPolicy(pEASData, policy) == EAS_SUCCESS, "%s: policy not set", pName);
+    result = EAS_IntSetStrmParam(pEASData, stream, PARSER_DATA_POLYPHONY, TEST_POLYPHONY);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: polyphony error %ld", pName, (long) result);
+
+    for (i = 0; i <= TEST_POLYPHONY; i++)
+    {
+        message[0] = (EAS_U8) (0x90 | pNotes[i].channel);
+        message[1] = pNotes[i].note;
+        message[2] = pNotes[i].velocity;
+        result = EAS_WriteMIDIStream(pEASData, stream, message, 3);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: write error %ld", pName, (long) result);
+        result = EAS_TestRender(pEASData, TEST_NOTE_BUFFERS, NULL, NULL);
+        EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: render error %ld", pName, (long) result);
+    }
+
+    for (i = 0; i <= TEST_POLYPHONY; i++)
+    {
+        if (i == stolen)
+            EAS_TEST_CHECK(!IsSounding(pEASData->pVoiceMgr, pNotes[i].channel, pNotes[i].note),
+                "%s: note %d on channel %d was not stolen", pName, pNotes[i].note, pNotes[i].channel);
+        else
+            EAS_TEST_CHECK(IsSounding(pEASData->pVoiceMgr, pNotes[i].channel, pNotes[i].note),
+                "%s: note %d on channel %d is not sounding", pName, pNotes[i].note, pNotes[i].channel);
+    }
+
+    EAS_CloseMIDIStream(pEASData, stream);
+    EAS_Shutdown(pEASData);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (void)
+{
+    EAS_DATA_HANDLE pEASData;
+
+    /* the first note is the oldest */
+    static const S_TEST_NOTE oldest[] =
+    {
+        {0, 60, 100}, {0, 62, 100}, {0, 64, 100}, {0, 65, 100}, {0, 67, 100}
+    };
+
+    /* the quiet note is the newest of the notes playing */
+    static const S_TEST_NOTE quietest[] =
+    {
+        {0, 60, 127}, {0, 62, 127}, {0, 64, 127}, {0, 65, 20}, {0, 67, 127}
+    };
+
+    /* the new note repeats one that is neither the oldest nor the newest */
+    static const S_TEST_NOTE sameNote[] =
+    {
+        {0, 60, 100}, {0, 62, 100}, {0, 64, 100}, {0, 65, 100}, {0, 62, 100}
+    };
+
+    /* the highest channel is the lowest priority, whatever its age */
+    static const S_TEST_NOTE channelPriority[] =
+    {
+        {0, 60, 100}, {5, 62, 100}, {1, 64, 100}, {2, 65, 100}, {0, 67, 100}
+    };
+
+    TestPolicy("default", EAS_STEAL_POLICY_DEFAULT, oldest, 0);
+    TestPolicy("oldest", EAS_STEAL_POLICY_OLDEST, oldest, 0);
+    TestPolicy("oldest, channels", EAS_STEAL_POLICY_OLDEST, channelPriority, 0);
+    TestPolicy("quietest", EAS_STEAL_POLICY_QUIETEST, quietest, 3);
+    TestPolicy("same note", EAS_STEAL_POLICY_SAME_NOTE, sameNote, NO_NOTE_STOLEN);
+    TestPolicy("channel priority", EAS_STEAL_POLICY_CHANNEL_PRIORITY, channelPriority, 1);
+
+    if ((pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) != NULL)
+    {
+        EAS_TEST_CHECK(EAS_SetVoiceStealPolicy(pEASData, NUM_STEAL_POLICIES) != EAS_SUCCESS, "invalid policy accepted");
+        EAS_TEST_CHECK(EAS_SetVoiceStealPolicy(pEASData, -1) != EAS_SUCCESS, "invalid policy accepted");
+        EAS_Shutdown(pEASData);
+    }
+
+    return EAS_TestResult("test_steal");
+}
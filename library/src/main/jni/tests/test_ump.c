@@ -0,0 +1,285 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_ump.c
+ *
+ * Contents and purpose:
+ * Universal MIDI Packet test. Writes MIDI 1.0 and MIDI 2.0 channel voice
+ * packets and SysEx7 packets to a MIDI stream and checks the channel and
+ * voice state they leave: velocities scaled to 7 bits with a MIDI 2.0
+ * velocity of zero playing at 1, pitch bend scaled to 14 bits, program
+ * changes with and without a bank, registered controllers and a SysEx
+ * message split across start, continue and end packets.
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eas_test.h"
+#include "eas_data.h"
+#include "eas_synth.h"
+#include "eas_miditypes.h"
+
+/* MIDI 2.0 channel voice packet, first word */
+#define UMP2(opcode, channel, index, low) \
+    ((EAS_UMP_WORD) ((0x4u << 28) | ((opcode) << 20) | ((channel) << 16) | ((index) << 8) | (low)))
+
+/* MIDI 1.0 channel voice packet */
+#define UMP1(status, d1, d2) \
+    ((EAS_UMP_WORD) ((0x2u << 28) | ((status) << 16) | ((d1) << 8) | (d2)))
+
+/* SysEx7 packet, first word, with the first two data bytes */
+#define UMP_SYSEX(status, count, b0, b1) \
+    ((EAS_UMP_WORD) ((0x3u << 28) | ((status) << 20) | ((count) << 16) | ((b0) << 8) | (b1)))
+
+/*----------------------------------------------------------------------------
+ * FindVoice()
+ *----------------------------------------------------------------------------
+ * Returns the voice playing a note, or NULL if the note is not sounding
+ *----------------------------------------------------------------------------
+*/
+static S_SYNTH_VOICE *FindVoice (S_VOICE_MGR *pVoiceMgr, EAS_U8 channel, EAS_U8 note)
+{
+    S_SYNTH_VOICE *pVoice;
+    EAS_INT i;
+
+    for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
+        pVoice = &pVoiceMgr->voices[i];
+        if (((pVoice->voiceState == eVoiceStateStart) || (pVoice->voiceState == eVoiceStatePlay)) &&
+            (GET_CHANNEL(pVoice->channel) == channel) && (pVoice->note == note))
+            return pVoice;
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * Write()
+ *----------------------------------------------------------------------------
+ * Writes packets and renders a buffer so that notes start
+ *----------------------------------------------------------------------------
+*/
+static void Write (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, const EAS_UMP_WORD *pWords, EAS_I32 count, const char *pName)
+{
+    EAS_RESULT result;
+
+    result = EAS_WriteUMPStream(pEASData, stream, pWords, count);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: write error %ld", pName, (long) result);
+    result = EAS_TestRender(pEASData, 1, NULL, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "%s: render error %ld", pName, (long) result);
+}
+
+/*----------------------------------------------------------------------------
+ * CheckNote()
+ *----------------------------------------------------------------------------
+ * Checks that a note is sounding at a velocity
+ *----------------------------------------------------------------------------
+*/
+static void CheckNote (EAS_DATA_HANDLE pEASData, EAS_U8 channel, EAS_U8 note, EAS_U8 velocity, const char *pName)
+{
+    S_SYNTH_VOICE *pVoice;
+
+    pVoice = FindVoice(pEASData->pVoiceMgr, channel, note);
+    EAS_TEST_CHECK(pVoice != NULL, "%s: note %d is not sounding", pName, note);
+    if (pVoice != NULL)
+        EAS_TEST_CHECK(pVoice->velocity == velocity, "%s: velocity %d, expected %d", pName, pVoice->velocity, velocity);
+}
+
+/*----------------------------------------------------------------------------
+ * TestNotes()
+ *----------------------------------------------------------------------------
+*/
+static void TestNotes (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream)
+{
+    EAS_UMP_WORD words[2];
+
+    /* MIDI 2.0 velocities keep their top 7 bits, zero plays at 1 */
+    words[0] = UMP2(0x9, 0, 60, 0);
+    words[1] = 0xffffu << 16;
+    Write(pEASData, stream, words, 2, "velocity 0xffff");
+    CheckNote(pEASData, 0, 60, 127, "velocity 0xffff");
+
+    words[0] = UMP2(0x9, 0, 62, 0);
+    words[1] = 0x8000u << 16;
+    Write(pEASData, stream, words, 2, "velocity 0x8000");
+    CheckNote(pEASData, 0, 62, 64, "velocity 0x8000");
+
+    words[0] = UMP2(0x9, 0, 64, 0);
+    words[1] = 0x0100u << 16;
+    Write(pEASData, stream, words, 2, "velocity 0x0100");
+    CheckNote(pEASData, 0, 64, 1, "velocity 0x0100");
+
+    words[0] = UMP2(0x9, 0, 65, 0);
+    words[1] = 0;
+    Write(pEASData, stream, words, 2, "velocity 0");
+    CheckNote(pEASData, 0, 65, 1, "velocity 0");
+
+    /* MIDI 2.0 and MIDI 1.0 note offs */
+    words[0] = UMP2(0x8, 0, 60, 0);
+    words[1] = 0;
+    Write(pEASData, stream, words, 2, "note off");
+    EAS_TEST_CHECK(FindVoice(pEASData->pVoiceMgr, 0, 60) == NULL, "note off: note 60 is still sounding");
+
+    /* a MIDI 1.0 note on with velocity zero is still a note off */
+    words[0] = UMP1(0x90, 62, 0);
+    Write(pEASData, stream, words, 1, "MIDI 1.0 note off");
+    EAS_TEST_CHECK(FindVoice(pEASData->pVoiceMgr, 0, 62) == NULL, "MIDI 1.0 note off: note 62 is still sounding");
+
+    words[0] = UMP1(0x91, 67, 100);
+    Write(pEASData, stream, words, 1, "MIDI 1.0 note on");
+    CheckNote(pEASData, 1, 67, 100, "MIDI 1.0 note on");
+}
+
+/*----------------------------------------------------------------------------
+ * TestChannel()
+ *----------------------------------------------------------------------------
+*/
+static void TestChannel (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, S_SYNTH *pSynth)
+{
+    static const EAS_UMP_WORD bends[] = { 0x00000000u, 0x80000000u, 0xffffffffu, 0x12345678u, 0x0003ffffu, 0x00040000u };
+    S_SYNTH_CHANNEL *pChannel;
+    EAS_UMP_WORD words[2];
+    EAS_INT i;
+
+    pChannel = &pSynth->channels[2];
+
+    /* pitch bend keeps the top 14 bits of 32 */
+    for (i = 0; i < (EAS_INT) (sizeof(bends) / sizeof(bends[0])); i++)
+    {
+        words[0] = UMP2(0xe, 2, 0, 0);
+        words[1] = bends[i];
+        Write(pEASData, stream, words, 2, "pitch bend");
+        EAS_TEST_CHECK(pChannel->pitchBend == (EAS_I16) (bends[i] >> 18), "pitch bend 0x%08lx: %d, expected %d",
+            (unsigned long) bends[i], pChannel->pitchBend, (int) (bends[i] >> 18));
+    }
+
+    /* program change with the bank valid flag */
+    words[0] = UMP2(0xc, 2, 0, 1);
+    words[1] = (5u << 24) | (0x79u << 8) | 0x03u;
+    Write(pEASData, stream, words, 2, "program with bank");
+    EAS_TEST_CHECK(pChannel->programNum == 5, "program with bank: program %d, expected 5", pChannel->programNum);
+    EAS_TEST_CHECK(pChannel->bankNum == 0x7903, "program with bank: bank 0x%04x, expected 0x7903", pChannel->bankNum);
+
+    /* without the flag the bank is left alone */
+    words[0] = UMP2(0xc, 2, 0, 0);
+    words[1] = (9u << 24) | (0x11u << 8) | 0x22u;
+    Write(pEASData, stream, words, 2, "program without bank");
+    EAS_TEST_CHECK(pChannel->programNum == 9, "program without bank: program %d, expected 9", pChannel->programNum);
+    EAS_TEST_CHECK(pChannel->bankNum == 0x7903, "program without bank: bank 0x%04x, expected 0x7903", pChannel->bankNum);
+
+    /* registered controller 0,0 is the pitch bend range in semitones */
+    words[0] = UMP2(0x2, 2, 0, 0);
+    words[1] = 7u << 25;
+    Write(pEASData, stream, words, 2, "RPN 0");
+    EAS_TEST_CHECK(pChannel->registeredParam == 0, "RPN 0: parameter %d, expected 0", pChannel->registeredParam);
+    EAS_TEST_CHECK(pChannel->pitchBendSensitivity == 700, "RPN 0: range %d, expected 700", pChannel->pitchBendSensitivity);
+
+    /* registered controller 0,2 is the coarse tuning */
+    words[0] = UMP2(0x2, 2, 0, 2);
+    words[1] = 66u << 25;
+    Write(pEASData, stream, words, 2, "RPN 2");
+    EAS_TEST_CHECK(pChannel->registeredParam == 2, "RPN 2: parameter %d, expected 2", pChannel->registeredParam);
+    EAS_TEST_CHECK(pChannel->coarsePitch == 2, "RPN 2: coarse tuning %d, expected 2", pChannel->coarsePitch);
+
+    /* an assignable controller deselects the registered parameter */
+    words[0] = UMP2(0x3, 2, 1, 2);
+    words[1] = 3u << 25;
+    Write(pEASData, stream, words, 2, "NRPN");
+    EAS_TEST_CHECK(pChannel->registeredParam == DEFAULT_REGISTERED_PARAM, "NRPN: parameter %d, expected %d",
+        pChannel->registeredParam, DEFAULT_REGISTERED_PARAM);
+    EAS_TEST_CHECK(pChannel->pitchBendSensitivity == 700, "NRPN: range %d, expected 700", pChannel->pitchBendSensitivity);
+}
+
+/*----------------------------------------------------------------------------
+ * TestSysEx()
+ *----------------------------------------------------------------------------
+ * Sends the master volume message F0 7F 7F 04 01 ll mm F7 as one
+ * complete packet and split over start, continue and end packets
+ *----------------------------------------------------------------------------
+*/
+static void TestSysEx (EAS_DATA_HANDLE pEASData, EAS_HANDLE stream, S_SYNTH *pSynth)
+{
+    EAS_UMP_WORD words[6];
+    EAS_I32 gain;
+
+    /* one packet holds all six data bytes */
+    words[0] = UMP_SYSEX(0x0, 6, 0x7f, 0x7f);
+    words[1] = (0x04u << 24) | (0x01u << 16) | (0x00u << 8) | 0x20u;
+    Write(pEASData, stream, words, 2, "complete SysEx");
+    gain = (0x20 << 8) * (0x20 << 8) >> 15;
+    EAS_TEST_CHECK(pSynth->masterVolume == gain, "complete SysEx: volume %d, expected %ld", pSynth->masterVolume, (long) gain);
+
+    /* two bytes in each of three packets */
+    words[0] = UMP_SYSEX(0x1, 2, 0x7f, 0x7f);
+    words[1] = 0;
+    words[2] = UMP_SYSEX(0x2, 2, 0x04, 0x01);
+    words[3] = 0;
+    words[4] = UMP_SYSEX(0x3, 2, 0x00, 0x40);
+    words[5] = 0;
+    Write(pEASData, stream, words, 6, "split SysEx");
+    gain = (0x40 << 8) * (0x40 << 8) >> 15;
+    EAS_TEST_CHECK(pSynth->masterVolume == gain, "split SysEx: volume %d, expected %ld", pSynth->masterVolume, (long) gain);
+
+    /* a packet for another message in the middle is ignored */
+    words[0] = UMP_SYSEX(0x1, 2, 0x7f, 0x7f);
+    words[1] = 0;
+    words[2] = UMP_SYSEX(0x2, 2, 0x04, 0x02);
+    words[3] = 0;
+    words[4] = UMP_SYSEX(0x3, 2, 0x00, 0x10);
+    words[5] = 0;
+    Write(pEASData, stream, words, 6, "other SysEx");
+    EAS_TEST_CHECK(pSynth->masterVolume == gain, "other SysEx: volume %d, expected %ld", pSynth->masterVolume, (long) gain);
+}
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (void)
+{
+    EAS_DATA_HANDLE pEASData;
+    EAS_HANDLE stream;
+    EAS_RESULT result;
+    EAS_UMP_WORD words[2];
+    S_SYNTH *pSynth;
+
+    if ((pEASData = EAS_TestInit(EAS_TEST_NO_REVERB)) == NULL)
+        return 2;
+    result = EAS_OpenMIDIStream(pEASData, &stream, NULL);
+    EAS_TEST_CHECK(result == EAS_SUCCESS, "open error %ld", (long) result);
+    if (result != EAS_SUCCESS)
+    {
+        EAS_Shutdown(pEASData);
+        return EAS_TestResult("test_ump");
+    }
+    pSynth = ((S_INTERACTIVE_MIDI*) stream->handle)->pSynth;
+
+    TestNotes(pEASData, stream);
+    TestChannel(pEASData, stream, pSynth);
+    TestSysEx(pEASData, stream, pSynth);
+
+    /* an incomplete packet is rejected */
+    words[0] = UMP2(0x9, 0, 60, 0);
+    result = EAS_WriteUMPStream(pEASData, stream, words, 1);
+    EAS_TEST_CHECK(result == EAS_ERROR_PARAMETER_RANGE, "incomplete packet returned %ld", (long) result);
+
+    EAS_CloseMIDIStream(pEASData, stream);
+    EAS_Shutdown(pEASData);
+    return EAS_TestResult("test_ump");
+}
@@ -0,0 +1,231 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * test_wtengine.c
+ *
+ * Contents and purpose:
+ * Golden output test for the wavetable engine kernels. Runs the
+ * interpolation, gain and filter kernels on random voices and compares
+ * a hash of their output with the expected value, so that a native
+ * version of a kernel can be checked to be bit exact with the C one.
+ *
+ * test_wtengine hash
+ *
+ * Copyright 2026 The MidiDriver Authors
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eas_test.h"
+#include "eas_synthcfg.h"
+#include "eas_math.h"
+#include "eas_audioconst.h"
+#include "eas_sndlib.h"
+#include "eas_wtengine.h"
+
+/* kernels, declared in eas_wtengine.c */
+extern void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame);
+
+#define TEST_WAVE_SAMPLES       4096
+#define TEST_ITERATIONS         20000
+
+static EAS_SAMPLE wave[TEST_WAVE_SAMPLES];
+
+/*----------------------------------------------------------------------------
+ * HashWords()
+ *----------------------------------------------------------------------------
+*/
+static uint64_t HashWords (uint64_t hash, const int32_t *pWords, EAS_I32 count)
+{
+    EAS_I32 i;
+
+    for (i = 0; i < count; i++)
+    {
+        hash ^= (uint32_t) pWords[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*----------------------------------------------------------------------------
+ * RandomPhaseIncrement()
+ *----------------------------------------------------------------------------
+ * Mostly the pitches notes play at, sometimes very high or zero
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 RandomPhaseIncrement (EAS_U32 *pSeed)
+{
+    switch (EAS_TestRandom(pSeed) % 8)
+    {
+        case 0:
+            return 0;
+        case 1:
+            return (EAS_I32) (EAS_TestRandom(pSeed) % (8 << NUM_PHASE_FRAC_BITS));
+        default:
+            return (EAS_I32) (EAS_TestRandom(pSeed) % (2 << NUM_PHASE_FRAC_BITS));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * TestInterpolate()
+ *----------------------------------------------------------------------------
+*/
+static uint64_t TestInterpolate (uint64_t hash, EAS_U32 *pSeed, EAS_BOOL loop)
+{
+    EAS_PCM output[BUFFER_SIZE_IN_MONO_SAMPLES];
+    int32_t state[3];
+    S_WT_INT_FRAME frame;
+    S_WT_VOICE voice;
+    EAS_I32 start;
+    EAS_I32 length;
+
+    memset(&voice, 0, sizeof(voice));
+    memset(&frame, 0, sizeof(frame));
+    memset(output, 0x5a, sizeof(output));
+
+    /* loopEnd points at the last sample, the kernels read one past phaseAccum */
+    start = (EAS_I32) (EAS_TestRandom(pSeed) % (TEST_WAVE_SAMPLES / 2));
+    length = 2 + (EAS_I32) (EAS_TestRandom(pSeed) % ((EAS_TestRandom(pSeed) & 1) ? 16 : (TEST_WAVE_SAMPLES / 2 - 2)));
+    voice.loopStart = (EAS_U32) &wave[start];
+    voice.loopEnd = (EAS_U32) &wave[start + length - 1];
+    voice.phaseAccum = (EAS_U32) &wave[start + (EAS_I32) (EAS_TestRandom(pSeed) % (EAS_U32) (length - 1))];
+    voice.phaseFrac = EAS_TestRandom(pSeed) & PHASE_FRAC_MASK;
+    frame.frame.phaseIncrement = RandomPhaseIncrement(pSeed);
+    frame.numSamples = 1 + (EAS_I32) (EAS_TestRandom(pSeed) % BUFFER_SIZE_IN_MONO_SAMPLES);
+    frame.pAudioBuffer = output;
+
+    if (loop)
+        WT_Interpolate(&voice, &frame);
+    else
+        WT_InterpolateNoLoop(&voice, &frame);
+
+    hash = EAS_TestHash(hash, output, BUFFER_SIZE_IN_MONO_SAMPLES);
+    state[0] = (int32_t) ((const EAS_SAMPLE*) voice.phaseAccum - wave);
+    state[1] = (int32_t) voice.phaseFrac;
+    state[2] = (int32_t) frame.numSamples;
+    return HashWords(hash, state, 3);
+}
+
+/*----------------------------------------------------------------------------
+ * TestVoiceGain()
+ *----------------------------------------------------------------------------
+*/
+static uint64_t TestVoiceGain (uint64_t hash, EAS_U32 *pSeed)
+{
+    EAS_MIX_SAMPLE mix[BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS];
+    EAS_PCM audio[BUFFER_SIZE_IN_MONO_SAMPLES];
+    S_WT_INT_FRAME frame;
+    S_WT_VOICE voice;
+    EAS_I32 i;
+
+    memset(&voice, 0, sizeof(voice));
+    memset(&frame, 0, sizeof(frame));
+    for (i = 0; i < BUFFER_SIZE_IN_MONO_SAMPLES; i++)
+        audio[i] = (EAS_PCM) EAS_TestRandom(pSeed);
+    for (i = 0; i < BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS; i++)
+        mix[i] = (EAS_MIX_SAMPLE) (EAS_TestRandom(pSeed) & 0xfffff) - 0x80000;
+
+    /* gains as the synth sets them, pan gains peak at 0x5a82 */
+#if (NUM_OUTPUT_CHANNELS == 2)
+    voice.gainLeft = (EAS_I16) (EAS_TestRandom(pSeed) % 0x5a83);
+    voice.gainRight = (EAS_I16) (EAS_TestRandom(pSeed) % 0x5a83);
+#endif
+    frame.prevGain = (EAS_I32) (EAS_TestRandom(pSeed) & 0x3fff);
+    frame.frame.gainTarget = (EAS_I32) (EAS_TestRandom(pSeed) & 0x3fff);
+    frame.numSamples = ((EAS_TestRandom(pSeed) & 3) == 0) ? 1 + (EAS_I32) (EAS_TestRandom(pSeed) % BUFFER_SIZE_IN_MONO_SAMPLES) : BUFFER_SIZE_IN_MONO_SAMPLES;
+    frame.pAudioBuffer = audio;
+    frame.pMixBuffer = mix;
+
+    WT_VoiceGain(&voice, &frame);
+    return HashWords(hash, mix, BUFFER_SIZE_IN_MONO_SAMPLES * NUM_OUTPUT_CHANNELS);
+}
+
+#ifdef _FILTER_ENABLED
+/*----------------------------------------------------------------------------
+ * TestVoiceFilter()
+ *----------------------------------------------------------------------------
+*/
+static uint64_t TestVoiceFilter (uint64_t hash, EAS_U32 *pSeed)
+{
+    EAS_PCM audio[BUFFER_SIZE_IN_MONO_SAMPLES];
+    S_FILTER_CONTROL filter;
+    S_WT_INT_FRAME frame;
+    int32_t state[2];
+    EAS_I32 i;
+
+    memset(&frame, 0, sizeof(frame));
+    for (i = 0; i < BUFFER_SIZE_IN_MONO_SAMPLES; i++)
+        audio[i] = (EAS_PCM) (EAS_TestRandom(pSeed) & 0x3fff) - 0x2000;
+    filter.z1 = (EAS_I16) ((EAS_TestRandom(pSeed) & 0x3fff) - 0x2000);
+    filter.z2 = (EAS_I16) ((EAS_TestRandom(pSeed) & 0x3fff) - 0x2000);
+    frame.frame.k = (EAS_I32) (EAS_TestRandom(pSeed) & 0x3fff);
+    frame.frame.b1 = (EAS_I32) (EAS_TestRandom(pSeed) & 0x7fff) - 0x4000;
+    frame.frame.b2 = (EAS_I32) (EAS_TestRandom(pSeed) & 0x3fff);
+    frame.numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
+    frame.pAudioBuffer = audio;
+
+    WT_VoiceFilter(&filter, &frame);
+    hash = EAS_TestHash(hash, audio, BUFFER_SIZE_IN_MONO_SAMPLES);
+    state[0] = filter.z1;
+    state[1] = filter.z2;
+    return HashWords(hash, state, 2);
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * main()
+ *----------------------------------------------------------------------------
+*/
+int main (int argc, char **argv)
+{
+    uint64_t expected;
+    uint64_t hash;
+    EAS_U32 seed;
+    EAS_I32 i;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s hash\n", argv[0]);
+        return 2;
+    }
+    expected = strtoull(argv[1], NULL, 16);
+
+    seed = 1;
+    for (i = 0; i < TEST_WAVE_SAMPLES; i++)
+        wave[i] = (EAS_SAMPLE) EAS_TestRandom(&seed);
+
+    hash = EAS_TEST_HASH_INIT;
+    for (i = 0; i < TEST_ITERATIONS; i++)
+    {
+        hash = TestInterpolate(hash, &seed, EAS_TRUE);
+        hash = TestInterpolate(hash, &seed, EAS_FALSE);
+        hash = TestVoiceGain(hash, &seed);
+#ifdef _FILTER_ENABLED
+        hash = TestVoiceFilter(hash, &seed);
+#endif
+    }
+
+    printf("hash %016llx\n", (unsigned long long) hash);
+    EAS_TEST_CHECK(hash == expected, "hash %016llx, expected %016llx",
+        (unsigned long long) hash, (unsigned long long) expected);
+    return EAS_TestResult("test_wtengine");
+}